@@ -380,7 +380,7 @@ public:
     ASSERT(size_ > 0, "Vector is empty");
 
     it->~Type();
-    if (--size_) [[likely]]
+    if (--size_ && it != end()) [[likely]]
     {
       RelocateAt(end(), it);
     }
@@ -534,7 +534,7 @@ protected:
     }
 
     // Ideally we want to grow by 1.5x to maximize memory reallocation.
-    return capacity_ + (capacity_ / 2); // Same as 1.5x
+    return capacity_ + (capacity_ / 2) + 1; // Roughly 1.5x, always grows for small capacities
   }
 
   ///
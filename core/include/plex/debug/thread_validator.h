@@ -9,7 +9,7 @@
 
 #include "plex/debug/assertion.h"
 
-#define LOCAL_THREAD_DECLARE mutable ::std::optional<::std::thread::id> __local_thread__;
+#define LOCAL_THREAD_DECLARE mutable ::std::optional<::std::thread::id> __local_thread__
 
 ///
 /// Performs initialization of the local thread id.
@@ -0,0 +1,119 @@
+#ifndef PLEX_OS_MAPPED_FILE_H
+#define PLEX_OS_MAPPED_FILE_H
+
+#include <cstddef>
+
+namespace plex
+{
+///
+/// File mapped into memory.
+///
+/// The mapping is private: the memory can be written to, but writes are copy-on-write and never reach the file. Pages
+/// are loaded lazily by the operating system the first time they are accessed.
+///
+/// The mapping always starts on a page boundary, so it is aligned at least to the page size.
+///
+class MappedFile final
+{
+public:
+  ///
+  /// Constructor.
+  ///
+  MappedFile() noexcept = default;
+
+  ///
+  /// Destructor.
+  ///
+  ~MappedFile()
+  {
+    Close();
+  }
+
+  ///
+  /// Move constructor.
+  ///
+  /// @param[in] other File to move.
+  ///
+  MappedFile(MappedFile&& other) noexcept : data_(other.data_), size_(other.size_)
+  {
+    other.data_ = nullptr;
+    other.size_ = 0;
+  }
+
+  ///
+  /// Move assignment operator.
+  ///
+  /// @param[in] other File to move.
+  ///
+  /// @return Reference to this.
+  ///
+  MappedFile& operator=(MappedFile&& other) noexcept
+  {
+    if (this != &other)
+    {
+      Close();
+
+      data_ = other.data_;
+      size_ = other.size_;
+
+      other.data_ = nullptr;
+      other.size_ = 0;
+    }
+
+    return *this;
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  ///
+  /// Maps the file into memory. The previously mapped file is unmapped.
+  ///
+  /// @param[in] path Path of the file to map.
+  ///
+  /// @return True if the file was mapped, false if it could not be opened or is empty.
+  ///
+  bool Open(const char* path);
+
+  ///
+  /// Unmaps the file. Does nothing if no file is mapped.
+  ///
+  void Close() noexcept;
+
+  ///
+  /// Returns the mapped memory of the file.
+  ///
+  /// @return Pointer to the first byte of the file, nullptr if no file is mapped.
+  ///
+  [[nodiscard]] std::byte* Data() const noexcept
+  {
+    return data_;
+  }
+
+  ///
+  /// Returns the size of the mapped file.
+  ///
+  /// @return Size in bytes.
+  ///
+  [[nodiscard]] size_t Size() const noexcept
+  {
+    return size_;
+  }
+
+  ///
+  /// Returns whether or not a file is mapped.
+  ///
+  /// @return True if a file is mapped, false otherwise.
+  ///
+  [[nodiscard]] bool IsOpen() const noexcept
+  {
+    return data_ != nullptr;
+  }
+
+private:
+  std::byte* data_ = nullptr;
+  size_t size_ = 0;
+};
+} // namespace plex
+
+#endif
@@ -0,0 +1,96 @@
+#include "plex/os/mapped_file.h"
+
+#include "plex/config/compiler.h"
+
+#if PLATFORM_WINDOWS
+// Lean windows include
+#define WIN32_LEAN_AND_MEAN
+#define VC_EXTRALEAN
+#include <Windows.h>
+#elif PLATFORM_LINUX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace plex
+{
+bool MappedFile::Open(const char* path)
+{
+  Close();
+
+#if PLATFORM_WINDOWS
+  HANDLE file =
+    CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+  if (file == INVALID_HANDLE_VALUE) return false;
+
+  LARGE_INTEGER size;
+
+  if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+  {
+    CloseHandle(file);
+    return false;
+  }
+
+  HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+
+  CloseHandle(file);
+
+  if (!mapping) return false;
+
+  void* data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+
+  // The view keeps the mapping alive
+  CloseHandle(mapping);
+
+  if (!data) return false;
+
+  data_ = static_cast<std::byte*>(data);
+  size_ = static_cast<size_t>(size.QuadPart);
+
+  return true;
+#elif PLATFORM_LINUX
+  const int file = open(path, O_RDONLY);
+
+  if (file == -1) return false;
+
+  struct stat status;
+
+  if (fstat(file, &status) == -1 || status.st_size <= 0)
+  {
+    close(file);
+    return false;
+  }
+
+  const size_t size = static_cast<size_t>(status.st_size);
+
+  void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+
+  // The mapping keeps the file alive
+  close(file);
+
+  if (data == MAP_FAILED) return false;
+
+  data_ = static_cast<std::byte*>(data);
+  size_ = size;
+
+  return true;
+#endif
+}
+
+void MappedFile::Close() noexcept
+{
+  if (!data_) return;
+
+#if PLATFORM_WINDOWS
+  UnmapViewOfFile(data_);
+#elif PLATFORM_LINUX
+  munmap(data_, size_);
+#endif
+
+  data_ = nullptr;
+  size_ = 0;
+}
+} // namespace plex
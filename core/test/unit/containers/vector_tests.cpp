@@ -2,6 +2,8 @@
 
 #include <gtest/gtest.h>
 
+#include <set>
+
 namespace plex::tests
 {
 static_assert(
@@ -10,6 +12,47 @@ static_assert(std::contiguous_iterator<Vector<size_t>::iterator>, "Vector should
 
 static_assert(IsTriviallyRelocatable<Vector<size_t>>::value, "Vector should be relocatable");
 
+namespace
+{
+  ///
+  /// Tracks the addresses of its alive instances to detect instances used after being destroyed.
+  ///
+  struct LifetimeTracker
+  {
+    inline static std::set<const LifetimeTracker*> alive;
+    inline static size_t used_after_destroy = 0;
+
+    int value;
+
+    LifetimeTracker(int initial) : value(initial)
+    {
+      alive.insert(this);
+    }
+
+    LifetimeTracker(const LifetimeTracker& other) : value(other.value)
+    {
+      if (!alive.contains(&other)) ++used_after_destroy;
+
+      alive.insert(this);
+    }
+
+    LifetimeTracker(LifetimeTracker&& other) noexcept : value(other.value)
+    {
+      if (!alive.contains(&other)) ++used_after_destroy;
+
+      alive.insert(this);
+    }
+
+    LifetimeTracker& operator=(const LifetimeTracker&) = default;
+    LifetimeTracker& operator=(LifetimeTracker&&) noexcept = default;
+
+    ~LifetimeTracker()
+    {
+      alive.erase(this);
+    }
+  };
+} // namespace
+
 TEST(Vector_Tests, Empty_Trivial_AfterDefaultConstruction_True)
 {
   Vector<double> vector;
@@ -667,6 +710,22 @@ TEST(Vector_Tests, Reserve_NonTrivial_Decrease_DoNothing)
   EXPECT_EQ(last_capacity, vector.capacity());
 }
 
+TEST(Vector_Tests, PushBack_AfterReserveOne_Grows)
+{
+  Vector<size_t> vector;
+
+  vector.reserve(1);
+
+  for (size_t i = 0; i < 10; i++)
+  {
+    vector.push_back(i);
+  }
+
+  EXPECT_EQ(vector.size(), 10);
+  EXPECT_GE(vector.capacity(), 10);
+  EXPECT_EQ(vector[9], 9);
+}
+
 TEST(Vector_Tests, PopBack_NonTrivial_Single_sizeDecrease)
 {
   Vector<std::string> vector;
@@ -884,6 +943,51 @@ TEST(Vector_Tests, SwapAndPop_NonTrivial_PushPushErase_CorrectValues)
   EXPECT_EQ(vector[0], "2");
 }
 
+TEST(Vector_Tests, SwapAndPop_NonTrivial_EraseLast_CorrectValues)
+{
+  Vector<std::string> vector;
+
+  // Long enough to not fit in the small string buffer
+  vector.push_back("first string that is allocated on the heap");
+  vector.push_back("second string that is allocated on the heap");
+  vector.push_back("third string that is allocated on the heap");
+  vector.SwapAndPop(vector.end() - 1);
+
+  EXPECT_EQ(vector.size(), 2);
+  EXPECT_EQ(vector[0], "first string that is allocated on the heap");
+  EXPECT_EQ(vector[1], "second string that is allocated on the heap");
+
+  vector.SwapAndPop(vector.end() - 1);
+
+  EXPECT_EQ(vector.size(), 1);
+  EXPECT_EQ(vector[0], "first string that is allocated on the heap");
+}
+
+TEST(Vector_Tests, SwapAndPop_NonTrivial_EraseLast_NotUsedAfterDestroy)
+{
+  LifetimeTracker::used_after_destroy = 0;
+
+  {
+    Vector<LifetimeTracker> vector;
+
+    vector.reserve(3);
+
+    vector.emplace_back(1);
+    vector.emplace_back(2);
+    vector.emplace_back(3);
+
+    vector.SwapAndPop(vector.end() - 1);
+
+    EXPECT_EQ(vector.size(), 2);
+    EXPECT_EQ(vector[0].value, 1);
+    EXPECT_EQ(vector[1].value, 2);
+    EXPECT_EQ(LifetimeTracker::alive.size(), 2);
+  }
+
+  EXPECT_EQ(LifetimeTracker::used_after_destroy, 0);
+  EXPECT_TRUE(LifetimeTracker::alive.empty());
+}
+
 TEST(Vector_Tests, SwapAndPop_Trivial_PushPushFindErase_CorrectValues)
 {
   Vector<double> vector;
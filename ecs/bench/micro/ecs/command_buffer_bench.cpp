@@ -0,0 +1,97 @@
+#include "plex/ecs/command_buffer.h"
+
+#include <benchmark/benchmark.h>
+
+namespace plex::bench
+{
+namespace
+{
+  template<size_t Id>
+  struct Component
+  {
+    size_t x;
+    size_t y;
+  };
+} // namespace
+
+static void CommandBuffer_Playback_InterleavedCreates(benchmark::State& state)
+{
+  size_t amount = state.range(0);
+
+  CommandBuffer buffer;
+
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+
+    Registry registry;
+
+    for (size_t i = 0; i < amount; i++)
+    {
+      buffer.Create(Component<0> { i, i }, Component<1> { i, i });
+      buffer.Create(Component<0> { i, i });
+    }
+
+    state.ResumeTiming();
+
+    buffer.Playback(registry);
+
+    benchmark::DoNotOptimize(registry);
+  }
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK(CommandBuffer_Playback_InterleavedCreates)->Arg(100)->Arg(1000)->Arg(10000)->Complexity(::benchmark::oN);
+
+static void CommandBuffer_Baseline_InterleavedCreates(benchmark::State& state)
+{
+  size_t amount = state.range(0);
+
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+
+    Registry registry;
+
+    state.ResumeTiming();
+
+    for (size_t i = 0; i < amount; i++)
+    {
+      registry.Create(Component<0> { i, i }, Component<1> { i, i });
+      registry.Create(Component<0> { i, i });
+    }
+
+    benchmark::DoNotOptimize(registry);
+  }
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK(CommandBuffer_Baseline_InterleavedCreates)->Arg(100)->Arg(1000)->Arg(10000)->Complexity(::benchmark::oN);
+
+static void CommandBuffer_Record_Create(benchmark::State& state)
+{
+  size_t amount = state.range(0);
+
+  CommandBuffer buffer;
+
+  for (auto _ : state)
+  {
+    for (size_t i = 0; i < amount; i++)
+    {
+      buffer.Create(Component<0> { i, i }, Component<1> { i, i });
+    }
+
+    benchmark::DoNotOptimize(buffer);
+
+    state.PauseTiming();
+    buffer.Clear();
+    state.ResumeTiming();
+  }
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK(CommandBuffer_Record_Create)->Arg(100)->Arg(1000)->Arg(10000)->Complexity(::benchmark::oN);
+} // namespace plex::bench
@@ -0,0 +1,136 @@
+#include "plex/ecs/hierarchy.h"
+
+#include <benchmark/benchmark.h>
+
+#include "plex/async/sync_wait.h"
+#include "plex/math/vec4.h"
+#include "plex/random/pcg.h"
+
+namespace plex::bench
+{
+namespace
+{
+  struct LocalTransform
+  {
+    float4 position;
+  };
+
+  struct WorldTransform
+  {
+    float4 position;
+  };
+
+  ///
+  /// Creates a scene graph where every node is a child of a random node created before it, with one root every 1000
+  /// nodes.
+  ///
+  Vector<Entity> CreateSceneGraph(Registry& registry, const size_t amount)
+  {
+    Vector<Entity> entities;
+
+    PCG random;
+
+    for (size_t i = 0; i < amount; i++)
+    {
+      const Entity entity = registry.Create(LocalTransform { { 1, 1, 1, 1 } }, WorldTransform {});
+
+      if (i % 1000 != 0) SetParent(registry, entity, entities[random(static_cast<uint32_t>(i))]);
+
+      entities.push_back(entity);
+    }
+
+    return entities;
+  }
+
+  ///
+  /// Propagates the transforms of the descendants of the entity recursively, following the children.
+  ///
+  void PropagateRecursive(Registry& registry, const Entity entity, const float4& parent)
+  {
+    auto& world = registry.Unpack<WorldTransform>(entity);
+
+    world.position = parent + registry.Unpack<LocalTransform>(entity).position;
+
+    if (!registry.HasComponents<Children>(entity)) return;
+
+    for (const Entity child : registry.Unpack<Children>(entity).entities)
+    {
+      PropagateRecursive(registry, child, world.position);
+    }
+  }
+} // namespace
+
+static void Hierarchy_Propagate(benchmark::State& state)
+{
+  size_t amount = state.range(0);
+
+  Registry registry;
+
+  CreateSceneGraph(registry, amount);
+
+  for (auto _ : state)
+  {
+    PropagateHierarchies<LocalTransform, WorldTransform>(registry,
+      [](const WorldTransform& parent, const LocalTransform& local, WorldTransform& world)
+      { world.position = parent.position + local.position; });
+  }
+
+  benchmark::DoNotOptimize(registry);
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK(Hierarchy_Propagate)->Arg(1000)->Arg(10000)->Arg(200000)->Complexity(::benchmark::oN);
+
+static void Hierarchy_Propagate_Parallel(benchmark::State& state)
+{
+  size_t amount = state.range(0);
+
+  Registry registry;
+  ThreadPool pool;
+
+  CreateSceneGraph(registry, amount);
+
+  for (auto _ : state)
+  {
+    SyncWait(ParallelPropagateHierarchies<LocalTransform, WorldTransform>(registry,
+      pool,
+      [](const WorldTransform& parent, const LocalTransform& local, WorldTransform& world)
+      { world.position = parent.position + local.position; }));
+  }
+
+  benchmark::DoNotOptimize(registry);
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK(Hierarchy_Propagate_Parallel)
+  ->Arg(1000)
+  ->Arg(10000)
+  ->Arg(200000)
+  ->UseRealTime()
+  ->Complexity(::benchmark::oN);
+
+static void Hierarchy_Propagate_Recursive(benchmark::State& state)
+{
+  size_t amount = state.range(0);
+
+  Registry registry;
+
+  const Vector<Entity> entities = CreateSceneGraph(registry, amount);
+
+  for (auto _ : state)
+  {
+    for (size_t i = 0; i < amount; i += 1000)
+    {
+      PropagateRecursive(registry, entities[i], float4 {});
+    }
+  }
+
+  benchmark::DoNotOptimize(registry);
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK(Hierarchy_Propagate_Recursive)->Arg(1000)->Arg(10000)->Arg(200000)->Complexity(::benchmark::oN);
+} // namespace plex::bench
@@ -2,7 +2,16 @@
 
 #include <benchmark/benchmark.h>
 
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <utility>
+
+#include "plex/async/sync_wait.h"
 #include "plex/math/vec4.h"
+#include "plex/random/pcg.h"
 
 namespace plex::bench
 {
@@ -24,6 +33,72 @@ namespace
     uint64_t data1;
     uint64_t data2;
   };
+
+  ///
+  /// Flat layout where every component has its own growable array. Kept to compare against chunked storages.
+  ///
+  struct FlatLayout
+  {
+    SharedSparseArray<Entity> sparse;
+    Vector<Entity> dense;
+    Vector<Position> positions;
+    Vector<Velocity> velocities;
+
+    void Insert(Entity entity, const Position& position, const Velocity& velocity)
+    {
+      sparse.Assure(entity);
+      sparse.Assign(entity, static_cast<Entity>(dense.size()));
+
+      dense.push_back(entity);
+      positions.push_back(position);
+      velocities.push_back(velocity);
+    }
+  };
+
+  ///
+  /// Creates entities with a position spread evenly across one archetype per index, returned in random order.
+  ///
+  template<size_t... I>
+  Vector<Entity> CreateShuffled(Registry& registry, size_t amount, std::index_sequence<I...>)
+  {
+    Vector<Entity> entities;
+
+    for (size_t i = 0; i < amount / sizeof...(I); i++)
+    {
+      (entities.push_back(registry.Create(Position {}, Component<I> { i, i })), ...);
+    }
+
+    PCG random;
+
+    for (size_t i = entities.size() - 1; i > 0; i--)
+    {
+      std::swap(entities[i], entities[random(static_cast<uint32_t>(i + 1))]);
+    }
+
+    return entities;
+  }
+
+  template<size_t Archetypes>
+  void UnpackRandom(benchmark::State& state)
+  {
+    Registry registry;
+
+    const size_t amount = state.range(0);
+
+    const Vector<Entity> entities = CreateShuffled(registry, amount, std::make_index_sequence<Archetypes>());
+
+    for (auto _ : state)
+    {
+      for (const auto entity : entities)
+      {
+        benchmark::DoNotOptimize(registry.Unpack<Position>(entity));
+      }
+    }
+
+    benchmark::DoNotOptimize(registry);
+
+    state.SetComplexityN(amount);
+  }
 } // namespace
 
 static void Registry_Iterate_SimpleWork_ManualFor(benchmark::State& state)
@@ -99,6 +174,100 @@ BENCHMARK(Registry_Iterate_SimpleWork_ForEach)
   ->Arg(100000)
   ->Complexity(::benchmark::oN);
 
+static void Registry_Iterate_Integrate_ForEach(benchmark::State& state)
+{
+  Registry registry;
+
+  size_t amount = state.range(0);
+
+  for (float f = 0; f < static_cast<float>(amount); f++)
+  {
+    registry.Create(f, static_cast<double>(f));
+  }
+
+  for (auto _ : state)
+  {
+    EntityForEach(registry.ViewFor<float, double>(),
+      [](float& position, const double& velocity) { position += static_cast<float>(velocity) * 0.5f; });
+
+    benchmark::ClobberMemory();
+  }
+
+  benchmark::DoNotOptimize(registry);
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK(Registry_Iterate_Integrate_ForEach)->Arg(1000)->Arg(10000)->Arg(100000)->Complexity(::benchmark::oN);
+
+static void Registry_Iterate_Integrate_ForEachSpan(benchmark::State& state)
+{
+  Registry registry;
+
+  size_t amount = state.range(0);
+
+  for (float f = 0; f < static_cast<float>(amount); f++)
+  {
+    registry.Create(f, static_cast<double>(f));
+  }
+
+  for (auto _ : state)
+  {
+    EntityForEachSpan(registry.ViewFor<float, double>(),
+      [](std::span<float> positions, std::span<const double> velocities)
+      {
+        for (size_t i = 0; i < positions.size(); i++)
+        {
+          positions[i] += static_cast<float>(velocities[i]) * 0.5f;
+        }
+      });
+
+    benchmark::ClobberMemory();
+  }
+
+  benchmark::DoNotOptimize(registry);
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK(Registry_Iterate_Integrate_ForEachSpan)->Arg(1000)->Arg(10000)->Arg(100000)->Complexity(::benchmark::oN);
+
+static void Registry_Iterate_SimpleWork_ParallelForEach(benchmark::State& state)
+{
+  Registry registry;
+  ThreadPool pool;
+
+  size_t amount = state.range(0);
+
+  for (float f = 0; f < static_cast<float>(amount); f++)
+  {
+    registry.Create(Position { { f, f, f, f } }, Velocity { { f, f, f, f } });
+  }
+
+  for (auto _ : state)
+  {
+    SyncWait(ParallelEntityForEach(registry.ViewFor<Position, Velocity>(),
+      pool,
+      [](Position& position, const Velocity& velocity)
+      {
+        position.data += velocity.data * velocity.data;
+        benchmark::DoNotOptimize(position.data);
+      }));
+  }
+
+  benchmark::DoNotOptimize(registry);
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK(Registry_Iterate_SimpleWork_ParallelForEach)
+  ->Arg(1000)
+  ->Arg(10000)
+  ->Arg(100000)
+  ->Arg(1000000)
+  ->UseRealTime()
+  ->Complexity(::benchmark::oN);
+
 static void Registry_Iterate_OneArchetype(benchmark::State& state)
 {
   Registry registry;
@@ -287,6 +456,104 @@ static void Registry_Iterate_TenArchetypes_Unpack2(benchmark::State& state)
 
 BENCHMARK(Registry_Iterate_TenArchetypes_Unpack2)->Arg(100)->Arg(1000)->Arg(10000)->Complexity(::benchmark::oN);
 
+static void Registry_Iterate_ChangedOneEntity(benchmark::State& state)
+{
+  Registry registry;
+
+  size_t amount = state.range(0);
+
+  for (size_t i = 0; i < amount; i++)
+  {
+    registry.Create(Component<0> { i, i });
+  }
+
+  const Entity changed = static_cast<Entity>(amount / 2);
+
+  for (auto _ : state)
+  {
+    const Tick last_run = registry.AdvanceTick();
+
+    registry.Unpack<Component<0>>(changed).data1++;
+
+    EntityForEach(registry.ViewFor<Component<0>>(),
+      Changed<Component<0>> { last_run - 1 },
+      [](const Component<0>& c1) { benchmark::DoNotOptimize(c1); });
+  }
+
+  benchmark::DoNotOptimize(registry);
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK(Registry_Iterate_ChangedOneEntity)->Arg(1000)->Arg(10000)->Arg(100000)->Complexity(::benchmark::oN);
+
+static void Registry_Construct_TwoArchetypes(benchmark::State& state)
+{
+  for (auto _ : state)
+  {
+    Registry registry;
+
+    registry.Create(Position {});
+    registry.Create(Position {}, Velocity {});
+
+    benchmark::DoNotOptimize(registry);
+  }
+}
+
+BENCHMARK(Registry_Construct_TwoArchetypes);
+
+static void Registry_Singleton_DummyEntity(benchmark::State& state)
+{
+  Registry registry;
+
+  for (size_t i = 0; i < 64; i++)
+  {
+    registry.Create(Position {}, Component<0> {});
+  }
+
+  const Entity dummy = registry.Create(Velocity { { 1, 1, 1, 1 } });
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(registry.Unpack<Velocity>(dummy));
+  }
+}
+
+BENCHMARK(Registry_Singleton_DummyEntity);
+
+static void Registry_Singleton_Get(benchmark::State& state)
+{
+  Registry registry;
+
+  for (size_t i = 0; i < 64; i++)
+  {
+    registry.Create(Position {}, Component<0> {});
+  }
+
+  registry.Set<Velocity>(Velocity { { 1, 1, 1, 1 } });
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(registry.Get<Velocity>());
+  }
+}
+
+BENCHMARK(Registry_Singleton_Get);
+
+static void Registry_Unpack_Random_OneArchetype(benchmark::State& state)
+{
+  UnpackRandom<1>(state);
+}
+
+BENCHMARK(Registry_Unpack_Random_OneArchetype)->Arg(1024)->Arg(16384)->Complexity(::benchmark::oN);
+
+static void Registry_Unpack_Random_ManyArchetypes(benchmark::State& state)
+{
+  UnpackRandom<256>(state);
+}
+
+BENCHMARK(Registry_Unpack_Random_ManyArchetypes)->Arg(1024)->Arg(16384)->Complexity(::benchmark::oN);
+
 static void Registry_Create_NoComponents(benchmark::State& state)
 {
   size_t amount = state.range(0);
@@ -362,7 +629,7 @@ static void Registry_Create_TwoComponents(benchmark::State& state)
 
 BENCHMARK(Registry_Create_TwoComponents)->Arg(100)->Arg(1000)->Arg(10000)->Complexity(::benchmark::oN);
 
-static void Registry_Destroy_NoComponents(benchmark::State& state)
+static void Registry_CreateMany_TwoComponents(benchmark::State& state)
 {
   size_t amount = state.range(0);
 
@@ -372,17 +639,10 @@ static void Registry_Destroy_NoComponents(benchmark::State& state)
 
     Registry registry;
 
-    for (size_t i = 0; i < amount; i++)
-    {
-      registry.Create();
-    }
-
     state.ResumeTiming();
 
-    for (Entity i = 0; i < amount; i++)
-    {
-      registry.Destroy(i);
-    }
+    registry.CreateMany<Component<0>, Component<1>>(amount,
+      [](Entity entity) { return std::make_tuple(Component<0> { entity, entity }, Component<1> { entity, entity }); });
 
     benchmark::DoNotOptimize(registry);
   }
@@ -390,9 +650,9 @@ static void Registry_Destroy_NoComponents(benchmark::State& state)
   state.SetComplexityN(amount);
 }
 
-BENCHMARK(Registry_Destroy_NoComponents)->Arg(100)->Arg(1000)->Arg(10000)->Complexity(::benchmark::oN);
+BENCHMARK(Registry_CreateMany_TwoComponents)->Arg(100)->Arg(1000)->Arg(10000)->Complexity(::benchmark::oN);
 
-static void Registry_Destroy_OneComponent(benchmark::State& state)
+static void Registry_Instantiate_TwoComponents(benchmark::State& state)
 {
   size_t amount = state.range(0);
 
@@ -402,17 +662,11 @@ static void Registry_Destroy_OneComponent(benchmark::State& state)
 
     Registry registry;
 
-    for (size_t i = 0; i < amount; i++)
-    {
-      registry.Create(Component<0> { i, i });
-    }
+    const Entity prefab = registry.Create(Component<0> { 1, 2 }, Component<1> { 3, 4 });
 
     state.ResumeTiming();
 
-    for (Entity i = 0; i < amount; i++)
-    {
-      registry.Destroy(i);
-    }
+    registry.Instantiate(prefab, amount);
 
     benchmark::DoNotOptimize(registry);
   }
@@ -420,35 +674,488 @@ static void Registry_Destroy_OneComponent(benchmark::State& state)
   state.SetComplexityN(amount);
 }
 
-BENCHMARK(Registry_Destroy_OneComponent)->Arg(100)->Arg(1000)->Arg(10000)->Complexity(::benchmark::oN);
+BENCHMARK(Registry_Instantiate_TwoComponents)->Arg(100)->Arg(1000)->Arg(10000)->Complexity(::benchmark::oN);
 
-static void Registry_Destroy_TwoComponents(benchmark::State& state)
+static void Registry_CreateMany_OnCreateObserver(benchmark::State& state)
 {
   size_t amount = state.range(0);
 
+  size_t observed = 0;
+
+  Observers<Entity>::Handler handler;
+  handler.Bind([&observed](std::span<const Entity> entities) { observed += entities.size(); });
+
   for (auto _ : state)
   {
     state.PauseTiming();
 
     Registry registry;
+    registry.OnCreate<Component<0>>(handler);
 
-    for (size_t i = 0; i < amount; i++)
-    {
-      registry.Create(Component<0> { i, i }, Component<1> { i, i });
-    }
+    state.ResumeTiming();
+
+    registry.CreateMany<Component<0>, Component<1>>(amount,
+      [](Entity entity) { return std::make_tuple(Component<0> { entity, entity }, Component<1> { entity, entity }); });
+
+    registry.FlushObservers();
+
+    benchmark::DoNotOptimize(observed);
+  }
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK(Registry_CreateMany_OnCreateObserver)->Arg(100)->Arg(1000)->Arg(10000)->Complexity(::benchmark::oN);
+
+static void Registry_Save_TwoComponents(benchmark::State& state)
+{
+  size_t amount = state.range(0);
+
+  const std::string path = (std::filesystem::temp_directory_path() / "plex_registry_bench_save.bin").string();
+
+  Registry registry;
+
+  registry.CreateMany(amount, Component<0> { 1, 2 }, Component<1> { 3, 4 });
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(registry.Save(path.c_str()));
+  }
+
+  std::remove(path.c_str());
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK(Registry_Save_TwoComponents)->Arg(100)->Arg(1000)->Arg(10000)->Complexity(::benchmark::oN);
+
+static void Registry_Load_TwoComponents(benchmark::State& state)
+{
+  size_t amount = state.range(0);
+
+  const std::string path = (std::filesystem::temp_directory_path() / "plex_registry_bench_load.bin").string();
+
+  {
+    Registry registry;
+
+    registry.CreateMany(amount, Component<0> { 1, 2 }, Component<1> { 3, 4 });
+    registry.Save(path.c_str());
+  }
+
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+
+    auto registry = std::make_unique<Registry>();
 
     state.ResumeTiming();
 
-    for (Entity i = 0; i < amount; i++)
-    {
-      registry.Destroy(i);
-    }
+    benchmark::DoNotOptimize(registry->Load<Component<0>, Component<1>>(path.c_str()));
 
-    benchmark::DoNotOptimize(registry);
+    state.PauseTiming();
+
+    registry.reset();
+
+    state.ResumeTiming();
   }
 
+  std::remove(path.c_str());
+
   state.SetComplexityN(amount);
 }
 
-BENCHMARK(Registry_Destroy_TwoComponents)->Arg(100)->Arg(1000)->Arg(10000)->Complexity(::benchmark::oN);
+BENCHMARK(Registry_Load_TwoComponents)->Arg(100)->Arg(1000)->Arg(10000)->Complexity(::benchmark::oN);
+
+static void Registry_Snapshot_Unmodified(benchmark::State& state)
+{
+  size_t amount = state.range(0);
+
+  Registry registry;
+
+  registry.CreateMany(amount, Component<0> { 1, 2 }, Component<1> { 3, 4 });
+  registry.AdvanceTick();
+
+  RegistrySnapshot previous = registry.Snapshot();
+
+  for (auto _ : state)
+  {
+    RegistrySnapshot snapshot = registry.Snapshot();
+
+    benchmark::DoNotOptimize(snapshot);
+  }
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK(Registry_Snapshot_Unmodified)->Arg(100)->Arg(1000)->Arg(10000)->Complexity(::benchmark::oN);
+
+static void Registry_Snapshot_Modified(benchmark::State& state)
+{
+  size_t amount = state.range(0);
+
+  Registry registry;
+
+  registry.CreateMany(amount, Component<0> { 1, 2 }, Component<1> { 3, 4 });
+
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+
+    registry.AdvanceTick();
+    EntityForEach(registry.ViewFor<Component<0>>(), [](Component<0>& component) { component.data1++; });
+
+    state.ResumeTiming();
+
+    RegistrySnapshot snapshot = registry.Snapshot();
+
+    benchmark::DoNotOptimize(snapshot);
+  }
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK(Registry_Snapshot_Modified)->Arg(100)->Arg(1000)->Arg(10000)->Complexity(::benchmark::oN);
+
+static void Registry_Sort_Compare(benchmark::State& state)
+{
+  size_t amount = state.range(0);
+
+  Registry registry;
+
+  registry.CreateMany(amount, Component<0> { 0, 0 }, Component<1> { 0, 0 });
+
+  PCG random;
+
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+
+    EntityForEach(registry.ViewFor<Component<0>>(), [&random](Component<0>& component) { component.data1 = random(); });
+
+    state.ResumeTiming();
+
+    registry.Sort<Component<0>>([](const auto& lhs, const auto& rhs) { return lhs.data1 < rhs.data1; });
+  }
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK(Registry_Sort_Compare)->Arg(100)->Arg(1000)->Arg(10000)->Complexity(::benchmark::oNLogN);
+
+static void Registry_Sort_Key(benchmark::State& state)
+{
+  size_t amount = state.range(0);
+
+  Registry registry;
+
+  registry.CreateMany(amount, Component<0> { 0, 0 }, Component<1> { 0, 0 });
+
+  PCG random;
+
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+
+    EntityForEach(registry.ViewFor<Component<0>>(), [&random](Component<0>& component) { component.data1 = random(); });
+
+    state.ResumeTiming();
+
+    registry.Sort<Component<0>>([](const auto& component) { return static_cast<uint32_t>(component.data1); });
+  }
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK(Registry_Sort_Key)->Arg(100)->Arg(1000)->Arg(10000)->Complexity(::benchmark::oN);
+
+static void Registry_Destroy_NoComponents(benchmark::State& state)
+{
+  size_t amount = state.range(0);
+
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+
+    Registry registry;
+
+    for (size_t i = 0; i < amount; i++)
+    {
+      registry.Create();
+    }
+
+    state.ResumeTiming();
+
+    for (Entity i = 0; i < amount; i++)
+    {
+      registry.Destroy(i);
+    }
+
+    benchmark::DoNotOptimize(registry);
+  }
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK(Registry_Destroy_NoComponents)->Arg(100)->Arg(1000)->Arg(10000)->Complexity(::benchmark::oN);
+
+static void Registry_Destroy_OneComponent(benchmark::State& state)
+{
+  size_t amount = state.range(0);
+
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+
+    Registry registry;
+
+    for (size_t i = 0; i < amount; i++)
+    {
+      registry.Create(Component<0> { i, i });
+    }
+
+    state.ResumeTiming();
+
+    for (Entity i = 0; i < amount; i++)
+    {
+      registry.Destroy(i);
+    }
+
+    benchmark::DoNotOptimize(registry);
+  }
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK(Registry_Destroy_OneComponent)->Arg(100)->Arg(1000)->Arg(10000)->Complexity(::benchmark::oN);
+
+static void Registry_Destroy_TwoComponents(benchmark::State& state)
+{
+  size_t amount = state.range(0);
+
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+
+    Registry registry;
+
+    for (size_t i = 0; i < amount; i++)
+    {
+      registry.Create(Component<0> { i, i }, Component<1> { i, i });
+    }
+
+    state.ResumeTiming();
+
+    for (Entity i = 0; i < amount; i++)
+    {
+      registry.Destroy(i);
+    }
+
+    benchmark::DoNotOptimize(registry);
+  }
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK(Registry_Destroy_TwoComponents)->Arg(100)->Arg(1000)->Arg(10000)->Complexity(::benchmark::oN);
+
+static void Registry_Destroy_HalfTwoComponents(benchmark::State& state)
+{
+  size_t amount = state.range(0);
+
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+
+    Registry registry;
+
+    for (size_t i = 0; i < amount; i++)
+    {
+      registry.Create(Component<0> { i, i }, Component<1> { i, i });
+    }
+
+    state.ResumeTiming();
+
+    for (size_t i = 0; i < amount; i += 2)
+    {
+      registry.Destroy<Component<0>, Component<1>>(static_cast<Entity>(i));
+    }
+
+    benchmark::DoNotOptimize(registry);
+  }
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK(Registry_Destroy_HalfTwoComponents)->Arg(100)->Arg(1000)->Arg(10000)->Complexity(::benchmark::oN);
+
+static void Registry_DestroyIf_HalfTwoComponents(benchmark::State& state)
+{
+  size_t amount = state.range(0);
+
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+
+    Registry registry;
+
+    for (size_t i = 0; i < amount; i++)
+    {
+      registry.Create(Component<0> { i, i }, Component<1> { i, i });
+    }
+
+    state.ResumeTiming();
+
+    registry.DestroyIf<Component<0>, Component<1>>([](const Component<0>& c) { return c.data1 % 2 == 0; });
+
+    benchmark::DoNotOptimize(registry);
+  }
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK(Registry_DestroyIf_HalfTwoComponents)->Arg(100)->Arg(1000)->Arg(10000)->Complexity(::benchmark::oN);
+
+static void Registry_AddRemove_OneComponent(benchmark::State& state)
+{
+  Registry registry;
+
+  size_t amount = state.range(0);
+
+  for (size_t i = 0; i < amount; i++)
+  {
+    registry.Create(Component<0> { i, i }, Component<1> { i, i });
+  }
+
+  for (auto _ : state)
+  {
+    for (Entity i = 0; i < amount; i++)
+    {
+      registry.Add(i, Component<2> { i, i });
+    }
+
+    for (Entity i = 0; i < amount; i++)
+    {
+      registry.Remove<Component<2>>(i);
+    }
+
+    benchmark::DoNotOptimize(registry);
+  }
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK(Registry_AddRemove_OneComponent)->Arg(100)->Arg(1000)->Arg(10000)->Complexity(::benchmark::oN);
+
+static void Registry_Layout_Spawn_Chunked(benchmark::State& state)
+{
+  size_t amount = state.range(0);
+
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+
+    SharedSparseArray<Entity> sparse;
+    Storage<Entity> storage(&sparse);
+    storage.Initialize<Position, Velocity>();
+
+    state.ResumeTiming();
+
+    for (Entity i = 0; i < amount; i++)
+    {
+      const float f = static_cast<float>(i);
+
+      storage.Insert(i, Position { { f, f, f, f } }, Velocity { { f, f, f, f } });
+    }
+
+    benchmark::DoNotOptimize(storage);
+  }
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK(Registry_Layout_Spawn_Chunked)->Arg(1000)->Arg(10000)->Arg(100000)->Complexity(::benchmark::oN);
+
+static void Registry_Layout_Spawn_Flat(benchmark::State& state)
+{
+  size_t amount = state.range(0);
+
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+
+    FlatLayout layout;
+
+    state.ResumeTiming();
+
+    for (Entity i = 0; i < amount; i++)
+    {
+      const float f = static_cast<float>(i);
+
+      layout.Insert(i, Position { { f, f, f, f } }, Velocity { { f, f, f, f } });
+    }
+
+    benchmark::DoNotOptimize(layout);
+  }
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK(Registry_Layout_Spawn_Flat)->Arg(1000)->Arg(10000)->Arg(100000)->Complexity(::benchmark::oN);
+
+static void Registry_Layout_Iterate_Chunked(benchmark::State& state)
+{
+  Registry registry;
+
+  size_t amount = state.range(0);
+
+  for (float f = 0; f < static_cast<float>(amount); f++)
+  {
+    registry.Create(Position { { f, f, f, f } }, Velocity { { f, f, f, f } });
+  }
+
+  for (auto _ : state)
+  {
+    EntityForEach(registry.ViewFor<Position, Velocity>(),
+      [](Position& position, const Velocity& velocity)
+      {
+        position.data += velocity.data * velocity.data;
+        benchmark::DoNotOptimize(position.data);
+      });
+  }
+
+  benchmark::DoNotOptimize(registry);
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK(Registry_Layout_Iterate_Chunked)->Arg(1000)->Arg(10000)->Arg(100000)->Complexity(::benchmark::oN);
+
+static void Registry_Layout_Iterate_Flat(benchmark::State& state)
+{
+  FlatLayout layout;
+
+  size_t amount = state.range(0);
+
+  for (Entity i = 0; i < amount; i++)
+  {
+    const float f = static_cast<float>(i);
+
+    layout.Insert(i, Position { { f, f, f, f } }, Velocity { { f, f, f, f } });
+  }
+
+  for (auto _ : state)
+  {
+    for (size_t i = 0; i < layout.dense.size(); i++)
+    {
+      layout.positions[i].data += layout.velocities[i].data * layout.velocities[i].data;
+      benchmark::DoNotOptimize(layout.positions[i].data);
+    }
+  }
+
+  benchmark::DoNotOptimize(layout);
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK(Registry_Layout_Iterate_Flat)->Arg(1000)->Arg(10000)->Arg(100000)->Complexity(::benchmark::oN);
 } // namespace plex::bench
\ No newline at end of file
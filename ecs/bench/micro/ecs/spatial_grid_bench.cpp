@@ -0,0 +1,145 @@
+#include "plex/ecs/spatial_grid.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+
+#include "plex/random/pcg.h"
+
+namespace plex::bench
+{
+namespace
+{
+  struct Position
+  {
+    float3 value;
+  };
+
+  using Grid = SpatialGrid<Position, float3 Position::*>;
+
+  constexpr float cRadius = 2.0f;
+
+  ///
+  /// Creates entities at random positions in a cube sized to keep about one entity per unit of volume.
+  ///
+  Vector<Entity> CreateScene(Registry& registry, const size_t amount)
+  {
+    Vector<Entity> entities;
+
+    PCG random;
+
+    const uint32_t size = static_cast<uint32_t>(std::cbrt(static_cast<double>(amount))) * 100;
+    const auto coordinate = [&]() { return static_cast<float>(random(size)) / 100.0f; };
+
+    for (size_t i = 0; i < amount; i++)
+    {
+      const float x = coordinate();
+      const float y = coordinate();
+      const float z = coordinate();
+
+      entities.push_back(registry.Create(Position { { x, y, z } }));
+    }
+
+    return entities;
+  }
+} // namespace
+
+static void SpatialGrid_QueryRadius_Neighbors(benchmark::State& state)
+{
+  size_t amount = state.range(0);
+
+  Registry registry;
+
+  CreateScene(registry, amount);
+
+  Grid grid(registry, cRadius, &Position::value);
+
+  for (auto _ : state)
+  {
+    size_t neighbors = 0;
+
+    EntityForEach(registry.ViewFor<const Position>(),
+      [&](const Position& position) { neighbors += grid.QueryRadius(position.value, cRadius).size(); });
+
+    benchmark::DoNotOptimize(neighbors);
+  }
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK(SpatialGrid_QueryRadius_Neighbors)->Arg(1000)->Arg(10000)->Arg(100000)->Complexity(::benchmark::oN);
+
+static void SpatialGrid_QueryRadius_Neighbors_BruteForce(benchmark::State& state)
+{
+  size_t amount = state.range(0);
+
+  Registry registry;
+
+  CreateScene(registry, amount);
+
+  for (auto _ : state)
+  {
+    size_t neighbors = 0;
+
+    EntityForEach(registry.ViewFor<const Position>(),
+      [&](const Position& center)
+      {
+        EntityForEach(registry.ViewFor<const Position>(),
+          [&](const Position& position)
+          {
+            const float3 offset = position.value - center.value;
+
+            if (offset.x * offset.x + offset.y * offset.y + offset.z * offset.z <= cRadius * cRadius) ++neighbors;
+          });
+      });
+
+    benchmark::DoNotOptimize(neighbors);
+  }
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK(SpatialGrid_QueryRadius_Neighbors_BruteForce)->Arg(1000)->Arg(10000)->Complexity(::benchmark::oNSquared);
+
+static void SpatialGrid_Update(benchmark::State& state)
+{
+  size_t amount = state.range(0);
+
+  Registry registry;
+
+  CreateScene(registry, amount);
+
+  Grid grid(registry, cRadius, &Position::value);
+
+  for (auto _ : state)
+  {
+    EntityForEach(registry.ViewFor<Position>(), [](Position& position) { position.value.x += 0.1f; });
+
+    grid.Update();
+  }
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK(SpatialGrid_Update)->Arg(1000)->Arg(10000)->Arg(100000)->Complexity(::benchmark::oN);
+
+static void SpatialGrid_Rebuild(benchmark::State& state)
+{
+  size_t amount = state.range(0);
+
+  Registry registry;
+
+  CreateScene(registry, amount);
+
+  Grid grid(registry, cRadius, &Position::value);
+
+  for (auto _ : state)
+  {
+    grid.Rebuild();
+  }
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK(SpatialGrid_Rebuild)->Arg(1000)->Arg(10000)->Arg(100000)->Complexity(::benchmark::oN);
+} // namespace plex::bench
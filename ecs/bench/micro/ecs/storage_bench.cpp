@@ -12,6 +12,22 @@ namespace
     uint64_t data1;
     uint64_t data2;
   };
+
+  template<size_t ID>
+  struct Tag
+  {};
+
+  struct LargeComponent
+  {
+    uint64_t data[512];
+  };
+
+  struct OutOfLineLargeComponent
+  {
+    using IsStoredOutOfLine = std::true_type;
+
+    uint64_t data[512];
+  };
 } // namespace
 
 static void Storage_Unpack(benchmark::State& state)
@@ -61,9 +77,14 @@ static void Storage_Iterate(benchmark::State& state)
 
   for (auto _ : state)
   {
-    for (size_t i = 0; i < amount; i++)
+    for (size_t chunk = 0; chunk < storage.ChunkCount(); chunk++)
     {
-      benchmark::DoNotOptimize(storage[i]);
+      auto entities = storage.ChunkEntities(chunk);
+
+      for (size_t i = 0; i < storage.ChunkSize(chunk); i++)
+      {
+        benchmark::DoNotOptimize(entities[i]);
+      }
     }
   }
 
@@ -89,12 +110,16 @@ static void Storage_Iterate_Unpack1(benchmark::State& state)
 
   for (auto _ : state)
   {
-    auto& array1 = storage.Access<Component<0>>();
-
-    for (size_t i = 0; i < amount; i++)
+    for (size_t chunk = 0; chunk < storage.ChunkCount(); chunk++)
     {
-      benchmark::DoNotOptimize(storage[i]);
-      benchmark::DoNotOptimize(array1[i]);
+      auto entities = storage.ChunkEntities(chunk);
+      auto array1 = storage.ChunkComponents<Component<0>>(chunk);
+
+      for (size_t i = 0; i < storage.ChunkSize(chunk); i++)
+      {
+        benchmark::DoNotOptimize(entities[i]);
+        benchmark::DoNotOptimize(array1[i]);
+      }
     }
   }
 
@@ -120,14 +145,18 @@ static void Storage_Iterate_Unpack2(benchmark::State& state)
 
   for (auto _ : state)
   {
-    auto& array1 = storage.Access<Component<0>>();
-    auto& array2 = storage.Access<Component<1>>();
-
-    for (size_t i = 0; i < amount; i++)
+    for (size_t chunk = 0; chunk < storage.ChunkCount(); chunk++)
     {
-      benchmark::DoNotOptimize(storage[i]);
-      benchmark::DoNotOptimize(array1[i]);
-      benchmark::DoNotOptimize(array2[i]);
+      auto entities = storage.ChunkEntities(chunk);
+      auto array1 = storage.ChunkComponents<Component<0>>(chunk);
+      auto array2 = storage.ChunkComponents<Component<1>>(chunk);
+
+      for (size_t i = 0; i < storage.ChunkSize(chunk); i++)
+      {
+        benchmark::DoNotOptimize(entities[i]);
+        benchmark::DoNotOptimize(array1[i]);
+        benchmark::DoNotOptimize(array2[i]);
+      }
     }
   }
 
@@ -166,6 +195,32 @@ static void Storage_Insert_NoComponents(benchmark::State& state)
 
 BENCHMARK(Storage_Insert_NoComponents)->Arg(100)->Arg(1000)->Arg(10000)->Complexity(::benchmark::oN);
 
+static void Storage_Insert_HighIds(benchmark::State& state)
+{
+  const size_t amount = state.range(0);
+
+  // Block of identifiers far from zero, like after deserialization or network id assignment
+  constexpr size_t first = size_t { 1 } << 23;
+
+  for (auto _ : state)
+  {
+    SharedSparseArray<size_t> sparse;
+    Storage<size_t> storage(&sparse);
+    storage.Initialize<Component<0>>();
+
+    for (size_t i = first; i < first + amount; i++)
+    {
+      storage.Insert(i, Component<0> { i, i });
+    }
+
+    benchmark::DoNotOptimize(storage);
+  }
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK(Storage_Insert_HighIds)->Arg(100)->Arg(1000)->Arg(10000)->Complexity(::benchmark::oN);
+
 static void Storage_Insert_OneComponent(benchmark::State& state)
 {
   const size_t amount = state.range(0);
@@ -250,6 +305,34 @@ static void Storage_Insert_TwoComponents(benchmark::State& state)
 
 BENCHMARK(Storage_Insert_TwoComponents)->Arg(100)->Arg(1000)->Arg(10000)->Complexity(::benchmark::oN);
 
+static void Storage_Insert_OneComponentSixTags(benchmark::State& state)
+{
+  const size_t amount = state.range(0);
+
+  SharedSparseArray<size_t> sparse;
+
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+
+    Storage<size_t> storage(&sparse);
+    storage.Initialize<Component<0>, Tag<0>, Tag<1>, Tag<2>, Tag<3>, Tag<4>, Tag<5>>();
+
+    state.ResumeTiming();
+
+    for (size_t i = 0; i < amount; i++)
+    {
+      storage.Insert(i, Component<0> { i, i }, Tag<0> {}, Tag<1> {}, Tag<2> {}, Tag<3> {}, Tag<4> {}, Tag<5> {});
+    }
+
+    benchmark::DoNotOptimize(storage);
+  }
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK(Storage_Insert_OneComponentSixTags)->Arg(100)->Arg(1000)->Arg(10000)->Complexity(::benchmark::oN);
+
 static void Storage_Erase_NoComponents(benchmark::State& state)
 {
   const size_t amount = state.range(0);
@@ -381,4 +464,109 @@ static void Storage_Erase_TwoComponents(benchmark::State& state)
 }
 
 BENCHMARK(Storage_Erase_TwoComponents)->Arg(100)->Arg(1000)->Arg(10000)->Complexity(::benchmark::oN);
+
+static void Storage_Erase_OneComponentSixTags(benchmark::State& state)
+{
+  const size_t amount = state.range(0);
+
+  SharedSparseArray<size_t> sparse;
+
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+
+    Storage<size_t> storage(&sparse);
+    storage.Initialize<Component<0>, Tag<0>, Tag<1>, Tag<2>, Tag<3>, Tag<4>, Tag<5>>();
+
+    for (size_t i = 0; i < amount; i++)
+    {
+      storage.Insert(i, Component<0> { i, i }, Tag<0> {}, Tag<1> {}, Tag<2> {}, Tag<3> {}, Tag<4> {}, Tag<5> {});
+    }
+
+    state.ResumeTiming();
+
+    for (size_t i = 0; i < amount; i++)
+    {
+      storage.Erase(i);
+    }
+
+    benchmark::DoNotOptimize(storage);
+  }
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK(Storage_Erase_OneComponentSixTags)->Arg(100)->Arg(1000)->Arg(10000)->Complexity(::benchmark::oN);
+
+template<typename Type>
+static void Storage_Erase_Large(benchmark::State& state)
+{
+  const size_t amount = state.range(0);
+
+  SharedSparseArray<size_t> sparse;
+
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+
+    Storage<size_t> storage(&sparse);
+    storage.Initialize<Type>();
+
+    for (size_t i = 0; i < amount; i++)
+    {
+      storage.Insert(i, Type {});
+    }
+
+    state.ResumeTiming();
+
+    for (size_t i = 0; i < amount; i++)
+    {
+      storage.Erase(i);
+    }
+
+    benchmark::DoNotOptimize(storage);
+  }
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK_TEMPLATE(Storage_Erase_Large, LargeComponent)->Arg(100)->Arg(1000)->Complexity(::benchmark::oN);
+BENCHMARK_TEMPLATE(Storage_Erase_Large, OutOfLineLargeComponent)->Arg(100)->Arg(1000)->Complexity(::benchmark::oN);
+
+template<typename Type>
+static void Storage_Relocate_Large(benchmark::State& state)
+{
+  const size_t amount = state.range(0);
+
+  SharedSparseArray<size_t> sparse;
+
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+
+    Storage<size_t> source(&sparse);
+    Storage<size_t> destination(&sparse);
+    source.Initialize<Type>();
+    destination.Initialize<Type, Component<0>>();
+
+    for (size_t i = 0; i < amount; i++)
+    {
+      source.Insert(i, Type {});
+    }
+
+    state.ResumeTiming();
+
+    for (size_t i = 0; i < amount; i++)
+    {
+      source.Relocate(i, destination, Component<0> { i, i });
+    }
+
+    benchmark::DoNotOptimize(destination);
+  }
+
+  state.SetComplexityN(amount);
+}
+
+BENCHMARK_TEMPLATE(Storage_Relocate_Large, LargeComponent)->Arg(100)->Arg(1000)->Complexity(::benchmark::oN);
+BENCHMARK_TEMPLATE(Storage_Relocate_Large, OutOfLineLargeComponent)->Arg(100)->Arg(1000)->Complexity(::benchmark::oN);
 } // namespace plex::bench
\ No newline at end of file
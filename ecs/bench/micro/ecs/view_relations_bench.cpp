@@ -1,9 +1,57 @@
 #include "plex/ecs/archetype.h"
 
+#include <algorithm>
+#include <memory>
+#include <utility>
+
 #include <benchmark/benchmark.h>
 
 namespace plex::bench
 {
+namespace
+{
+  template<size_t I>
+  struct Tag
+  {};
+
+  template<size_t... I>
+  void AssureViews(ViewRelations& relations, std::index_sequence<I...>)
+  {
+    (relations.AssureView<Tag<I % 64>, Tag<(I * 5 + 3) % 64 + 64>>(), ...);
+  }
+
+  template<size_t... I>
+  Vector<ComponentId> ComponentIds(std::index_sequence<I...>)
+  {
+    Vector<ComponentId> components;
+
+    (components.push_back(GetComponentId<Tag<I>>()), ...);
+
+    return components;
+  }
+
+  Vector<Vector<ComponentId>> ArchetypeComponents()
+  {
+    const Vector<ComponentId> ids = ComponentIds(std::make_index_sequence<128>());
+
+    Vector<Vector<ComponentId>> archetypes;
+
+    for (size_t i = 0; i < 1024; i++)
+    {
+      Vector<ComponentId> components;
+      components.push_back(ids[i % 64]);
+      components.push_back(ids[(i / 64 * 7 + 3) % 64 + 64]);
+      components.push_back(ids[(i * 13 + 5) % 64]);
+
+      std::ranges::sort(components);
+
+      archetypes.push_back(std::move(components));
+    }
+
+    return archetypes;
+  }
+} // namespace
+
 static void ViewRelations_AssureArchetype(benchmark::State& state)
 {
   ViewRelations relations;
@@ -31,4 +79,62 @@ static void ViewRelations_AssureView(benchmark::State& state)
 }
 
 BENCHMARK(ViewRelations_AssureView);
-} // namespace plex::bench
\ No newline at end of file
+
+static void ViewRelations_AddArchetypes_ManyViews(benchmark::State& state)
+{
+  const Vector<Vector<ComponentId>> archetypes = ArchetypeComponents();
+
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+
+    auto relations = std::make_unique<ViewRelations>();
+
+    AssureViews(*relations, std::make_index_sequence<256>());
+
+    state.ResumeTiming();
+
+    for (const auto& components : archetypes)
+    {
+      benchmark::DoNotOptimize(relations->AssureArchetype(components));
+    }
+
+    state.PauseTiming();
+
+    relations.reset();
+
+    state.ResumeTiming();
+  }
+}
+
+BENCHMARK(ViewRelations_AddArchetypes_ManyViews);
+
+static void ViewRelations_AddViews_ManyArchetypes(benchmark::State& state)
+{
+  const Vector<Vector<ComponentId>> archetypes = ArchetypeComponents();
+
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+
+    auto relations = std::make_unique<ViewRelations>();
+
+    for (const auto& components : archetypes)
+    {
+      benchmark::DoNotOptimize(relations->AssureArchetype(components));
+    }
+
+    state.ResumeTiming();
+
+    AssureViews(*relations, std::make_index_sequence<256>());
+
+    state.PauseTiming();
+
+    relations.reset();
+
+    state.ResumeTiming();
+  }
+}
+
+BENCHMARK(ViewRelations_AddViews_ManyArchetypes);
+} // namespace plex::bench
@@ -2,6 +2,10 @@
 #define PLEX_ECS_ARCHETYPE_H
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <limits>
 #include <memory>
 #include <mutex>
 
@@ -171,20 +175,14 @@ using ViewId = uint_fast32_t;
 using ArchetypeId = uint_fast32_t;
 
 ///
-/// Maximum amount of archetypes allowed.
+/// Archetype identifier used to represent the absence of an archetype.
 ///
-/// @note Having a cap defined allows us to avoid some branches in certain hot paths. This is purely for optimization
-/// purposes and is not a limitation.
-///
-static constexpr size_t MaxArchetypes = 4096;
+static constexpr ArchetypeId cInvalidArchetype = std::numeric_limits<ArchetypeId>::max();
 
 ///
-/// Maximum amount of views allowed.
-///
-/// @note Having a cap defined allows us to avoid some branches in certain hot paths. This is purely for optimization
-/// purposes and is not a limitation.
+/// View identifier used to represent the absence of a view.
 ///
-static constexpr size_t MaxViews = 4096;
+static constexpr ViewId cInvalidView = std::numeric_limits<ViewId>::max();
 
 ///
 /// Tag used for the unique id sequence of components.
@@ -219,6 +217,51 @@ ComponentId GetComponentId() noexcept
   return static_cast<ComponentId>(TypeIndex<Component, ComponentIdTag>());
 }
 
+///
+/// Returns the archetype id for the sorted list of component ids.
+///
+/// Ids come from a packed sequence starting at 0. This is the runtime equivalent of GetArchetypeId<Components...>(),
+/// both always return the same id for the same set of components.
+///
+/// @note Not performance critical, should only be called once per archetype and then cached.
+///
+/// @param[in] components Sorted list of component ids that compose the archetype.
+///
+/// @return Archetype identifier.
+///
+COLD_SECTION NO_INLINE ArchetypeId GetArchetypeId(const Vector<ComponentId>& components);
+
+namespace details
+{
+  ///
+  /// Holds the archetype id for a component list in global storage initialized during runtime.
+  ///
+  /// @tparam ComponentList Sorted component list of the archetype.
+  ///
+  template<typename ComponentList>
+  struct ArchetypeIdGlobalStorage;
+
+  template<typename... Components, template<typename...> class ComponentList>
+  struct ArchetypeIdGlobalStorage<ComponentList<Components...>>
+  {
+    static const ArchetypeId value;
+  };
+
+  template<typename... Components, template<typename...> class ComponentList>
+  const ArchetypeId ArchetypeIdGlobalStorage<ComponentList<Components...>>::value = []()
+  {
+    // The order of initialization of global storages is not guaranteed, so we cannot use GetComponentId here.
+    Vector<ComponentId> components;
+    components.reserve(sizeof...(Components));
+
+    (components.push_back(static_cast<ComponentId>(details::TypeIndex<Components, ComponentIdTag>())), ...);
+
+    std::ranges::sort(components);
+
+    return GetArchetypeId(components);
+  }();
+} // namespace details
+
 ///
 /// Returns the archetype id for the component type list.
 ///
@@ -233,7 +276,7 @@ ComponentId GetComponentId() noexcept
 template<typename... Components>
 ArchetypeId GetArchetypeId() noexcept
 {
-  return static_cast<ArchetypeId>(TypeIndex<ComponentList<Components...>, ArchetypeIdTag>());
+  return details::ArchetypeIdGlobalStorage<ComponentList<Components...>>::value;
 }
 
 ///
@@ -300,17 +343,291 @@ const Vector<ComponentId>& GetComponentIds()
   return components;
 }
 
+///
+/// View parameter that excludes every archetype with any of the components from the view.
+///
+/// For example, View<Position, Without<Frozen>> contains the entities with a position that are not frozen.
+///
+/// @tparam Components Excluded component types.
+///
+template<typename... Components>
+struct Without
+{};
+
+///
+/// View parameter for components that the entities of the view may or may not have.
+///
+/// Optional components do not affect which archetypes are in the view. They are accessed with pointers that are
+/// nullptr for every entity of a sub view whose archetype does not have the component.
+///
+/// @tparam Components Optional component types.
+///
+template<typename... Components>
+struct Optional
+{};
+
+namespace details
+{
+  ///
+  /// Variadic list of types.
+  ///
+  /// @tparam Types Types in the list.
+  ///
+  template<typename... Types>
+  struct TypeList
+  {};
+
+  ///
+  /// Splits view parameters into the required and excluded component type lists.
+  ///
+  /// @tparam Required List of required component types.
+  /// @tparam Excluded List of excluded component types.
+  /// @tparam Parameters View parameters left to split.
+  ///
+  template<typename Required, typename Excluded, typename... Parameters>
+  struct SplitViewParameters;
+
+  template<typename... Required, typename... Excluded>
+  struct SplitViewParameters<TypeList<Required...>, TypeList<Excluded...>>
+  {
+    static const Vector<ComponentId>& RequiredIds()
+    {
+      return GetComponentIds<Required...>();
+    }
+
+    static const Vector<ComponentId>& ExcludedIds()
+    {
+      return GetComponentIds<Excluded...>();
+    }
+  };
+
+  template<typename... Required, typename... Excluded, typename Component, typename... Parameters>
+  struct SplitViewParameters<TypeList<Required...>, TypeList<Excluded...>, Component, Parameters...>
+    : SplitViewParameters<TypeList<Required..., std::remove_cvref_t<Component>>, TypeList<Excluded...>, Parameters...>
+  {};
+
+  template<typename... Required, typename... Excluded, typename... Components, typename... Parameters>
+  struct SplitViewParameters<TypeList<Required...>, TypeList<Excluded...>, Without<Components...>, Parameters...>
+    : SplitViewParameters<TypeList<Required...>, TypeList<Excluded..., Components...>, Parameters...>
+  {};
+
+  template<typename... Required, typename... Excluded, typename... Components, typename... Parameters>
+  struct SplitViewParameters<TypeList<Required...>, TypeList<Excluded...>, Optional<Components...>, Parameters...>
+    : SplitViewParameters<TypeList<Required...>, TypeList<Excluded...>, Parameters...>
+  {};
+} // namespace details
+
+///
+/// Component ids of the view parameters.
+///
+/// Plain component types are required, Without<...> components are excluded and Optional<...> components are ignored.
+///
+/// @tparam Parameters View parameters.
+///
+template<typename... Parameters>
+using ViewParameters = details::SplitViewParameters<details::TypeList<>, details::TypeList<>, Parameters...>;
+
+namespace details
+{
+  ///
+  /// Packed table of component bitset signatures.
+  ///
+  /// The table is stored one column of words at a time. Testing a signature against every row of the table is then a
+  /// loop over contiguous words, which the compiler vectorizes.
+  ///
+  class SignatureTable final
+  {
+  public:
+    static constexpr size_t cWordBits = 64;
+
+    ///
+    /// Constructor.
+    ///
+    SignatureTable() noexcept : rows_(0), capacity_(0), words_(0) {}
+
+    ///
+    /// Assigns the signature of the component ids to the row. Grows the table if needed.
+    ///
+    /// @param[in] row Row to assign.
+    /// @param[in] components Sorted component ids.
+    ///
+    void Assign(size_t row, const Vector<ComponentId>& components);
+
+    ///
+    /// Assures that the table has at least the amount of rows and words per row.
+    ///
+    /// @param[in] rows Minimum amount of rows.
+    /// @param[in] words Minimum amount of words per row.
+    ///
+    void Assure(size_t rows, size_t words);
+
+    ///
+    /// Returns the word of the row, zero if the word is past the words of the table.
+    ///
+    /// @param[in] row Row of the signature.
+    /// @param[in] word Index of the word.
+    ///
+    /// @return Word of the signature.
+    ///
+    [[nodiscard]] uint64_t Word(const size_t row, const size_t word) const noexcept
+    {
+      ASSERT(row < rows_, "Row out of bounds");
+
+      return word < words_ ? data_[word * capacity_ + row] : 0;
+    }
+
+    ///
+    /// Returns the column of the word for every row.
+    ///
+    /// @param[in] word Index of the word.
+    ///
+    /// @return Pointer to the word of the first row.
+    ///
+    [[nodiscard]] const uint64_t* Column(const size_t word) const noexcept
+    {
+      ASSERT(word < words_, "Word out of bounds");
+
+      return data_.data() + word * capacity_;
+    }
+
+    ///
+    /// Returns the amount of rows.
+    ///
+    /// @return Amount of rows.
+    ///
+    [[nodiscard]] size_t Rows() const noexcept
+    {
+      return rows_;
+    }
+
+    ///
+    /// Returns the amount of words per row.
+    ///
+    /// @return Amount of words.
+    ///
+    [[nodiscard]] size_t Words() const noexcept
+    {
+      return words_;
+    }
+
+  private:
+    Vector<uint64_t> data_;
+
+    size_t rows_;
+    size_t capacity_;
+    size_t words_;
+  };
+
+  ///
+  /// Table that translates process-wide ids into local ids.
+  ///
+  /// Ids are stored in fixed size pages that are allocated on demand and never move. Lookups do not lock, an id is
+  /// published with release semantics once everything it refers to is initialized, so a thread that finds the id also
+  /// sees its initialization. Assignments must be serialized by the owner.
+  ///
+  /// @tparam Id Local id type.
+  /// @tparam cInvalid Id used for the global ids that were never assigned.
+  ///
+  template<typename Id, Id cInvalid>
+  class LocalIdTable final
+  {
+  public:
+    static constexpr size_t cPageSize = 512;
+    static constexpr size_t cPageCount = 512;
+
+    ///
+    /// Constructor.
+    ///
+    LocalIdTable() noexcept = default;
+
+    ///
+    /// Destructor.
+    ///
+    ~LocalIdTable()
+    {
+      for (auto& page : pages_)
+      {
+        delete[] page.load(std::memory_order_relaxed);
+      }
+    }
+
+    LocalIdTable(const LocalIdTable&) = delete;
+    LocalIdTable(LocalIdTable&&) = delete;
+    LocalIdTable& operator=(const LocalIdTable&) = delete;
+    LocalIdTable& operator=(LocalIdTable&&) = delete;
+
+    ///
+    /// Returns the local id of the global id.
+    ///
+    /// @note Thread-safe
+    ///
+    /// @param[in] global Global id.
+    ///
+    /// @return Local id or the invalid id if it was never assigned.
+    ///
+    [[nodiscard]] Id Find(const size_t global) const noexcept
+    {
+      if (global >= cPageSize * cPageCount) [[unlikely]] return cInvalid;
+
+      const std::atomic<Id>* page = pages_[global / cPageSize].load(std::memory_order_acquire);
+
+      return page ? page[global % cPageSize].load(std::memory_order_acquire) : cInvalid;
+    }
+
+    ///
+    /// Assigns the local id of the global id, allocating its page if needed.
+    ///
+    /// @warning Must not be called concurrently with itself.
+    ///
+    /// @param[in] global Global id.
+    /// @param[in] id Local id.
+    ///
+    void Assign(const size_t global, const Id id)
+    {
+      if (global >= cPageSize * cPageCount) [[unlikely]]
+      {
+        ASSERT(false, "Too many ids");
+        std::abort();
+      }
+
+      std::atomic<Id>* page = pages_[global / cPageSize].load(std::memory_order_relaxed);
+
+      if (!page)
+      {
+        page = new std::atomic<Id>[cPageSize];
+
+        for (size_t i = 0; i < cPageSize; i++)
+        {
+          page[i].store(cInvalid, std::memory_order_relaxed);
+        }
+
+        pages_[global / cPageSize].store(page, std::memory_order_release);
+      }
+
+      page[global % cPageSize].store(id, std::memory_order_release);
+    }
+
+  private:
+    std::array<std::atomic<std::atomic<Id>*>, cPageCount> pages_ {};
+  };
+} // namespace details
+
 ///
 /// Keeps track of what archetypes are in every view in an array ready for lookup.
 ///
+/// Every archetype and view has a component bitset signature in a packed signature table. Matching a new archetype or
+/// view is a vectorized (archetype & view) == view test over the whole table of the other side.
+///
+/// The ids returned by the relations are local and dense, they start at 0 and only count the archetypes and views
+/// that were assured in these relations. The process-wide ids of GetArchetypeId and GetViewId are translated with a
+/// small cache indexed by the global id, which is read without locking. Every table grows on demand, memory scales with
+/// what was actually used.
+///
 class ViewRelations final
 {
 public:
   ViewRelations()
   {
-    archetype_states_.resize(MaxArchetypes);
-    view_states_.resize(MaxViews);
-
     // Assure the empty view. This guarantees that it will be first in the arrays.
     AssureView();
   }
@@ -320,21 +637,20 @@ public:
   ///
   /// @note Thread-safe
   ///
-  /// @tparam Components Unordered list of component types.
+  /// @tparam Components Unordered list of view parameters, see ViewParameters.
   ///
-  /// @return The view id that was assured.
+  /// @return The local view id that was assured.
   ///
   template<typename... Components>
   ViewId AssureView()
   {
-    const ViewId id = GetViewId<std::remove_cvref_t<Components>...>();
+    const ViewId global = GetViewId<std::remove_cvref_t<Components>...>();
 
-    if (!view_states_[id]) [[unlikely]]
-    {
-      InitializeView<Components...>();
-    }
+    const ViewId id = view_locals_.Find(global);
+
+    if (id != cInvalidView) [[likely]] return id;
 
-    return id;
+    return InitializeView<Components...>();
   }
 
   ///
@@ -344,19 +660,18 @@ public:
   ///
   /// @tparam Components Unordered list of component types.
   ///
-  /// @return The archetype id that was assured.
+  /// @return The local archetype id that was assured.
   ///
   template<typename... Components>
   ArchetypeId AssureArchetype()
   {
-    const ArchetypeId id = GetArchetypeId<std::remove_cvref_t<Components>...>();
+    const ArchetypeId global = GetArchetypeId<std::remove_cvref_t<Components>...>();
 
-    if (!archetype_states_[id]) [[unlikely]]
-    {
-      InitializeArchetype<Components...>();
-    }
+    const ArchetypeId id = archetype_locals_.Find(global);
 
-    return id;
+    if (id != cInvalidArchetype) [[likely]] return id;
+
+    return InitializeArchetype(global, GetComponentIds<std::remove_cvref_t<Components>...>());
   }
 
   ///
@@ -364,117 +679,241 @@ public:
   ///
   /// Very fast, simply a single lookup.
   ///
-  /// @param[in] id View identifier.
+  /// @param[in] id Local view identifier.
   ///
   /// @return List of archetypes for the view.
   ///
   [[nodiscard]] constexpr const Vector<ArchetypeId>& ViewArchetypes(const ViewId id) const noexcept
   {
-    ASSERT(view_states_[id], "View not initialized");
+    ASSERT(id < view_archetypes_.size(), "View not initialized");
 
     return view_archetypes_[id];
   }
 
-private:
   ///
-  /// Initializes an unordered list of components and states for a given id.
+  /// Checks whether or not the view can see the archetype.
   ///
-  /// Components and states are seperated for SoA access cache performance benefits.
+  /// Tests the signatures of the view and archetype directly, the cost does not depend on the amount of archetypes in
+  /// the view.
   ///
-  /// @tparam IdType Type of identifier.
-  /// @tparam Components List of component types.
+  /// @param[in] view Local view identifier.
+  /// @param[in] archetype Local archetype identifier.
   ///
-  /// @param[in] components The components list.
-  /// @param[in] states The states list.
-  /// @param[in] id The id to initialize for.
+  /// @return True if the archetype is in the view, false otherwise.
   ///
-  /// @return True if already initialized, false otherwise.
-  ///
-  template<std::unsigned_integral IdType, typename... Components>
-  static bool Initialize(Vector<Vector<ComponentId>>& components, Vector<bool>& states, const IdType id)
+  [[nodiscard]] bool ViewContains(const ViewId view, const ArchetypeId archetype) const noexcept
   {
-    if (id >= components.size())
+    ASSERT(view < view_components_.size(), "View not initialized");
+    ASSERT(archetype < archetype_components_.size(), "Archetype not initialized");
+
+    uint64_t mismatch = 0;
+
+    for (size_t word = 0; word < view_signatures_.Words(); word++)
     {
-      components.resize(id + 1);
+      const uint64_t archetype_word = archetype_signatures_.Word(archetype, word);
+
+      mismatch |= (view_signatures_.Word(view, word) & ~archetype_word)
+                | (view_excluded_signatures_.Word(view, word) & archetype_word);
     }
 
-    components[id] = GetComponentIds<std::remove_cvref_t<Components>...>();
+    return !mismatch;
+  }
+
+  ///
+  /// If the archetype never existed it will be baked into the flattened graph for quick access.
+  ///
+  /// Runtime equivalent of AssureArchetype<Components...>(), used when the archetype is only known at runtime.
+  ///
+  /// @note Thread-safe
+  ///
+  /// @param[in] components Sorted list of component ids that compose the archetype.
+  ///
+  /// @return The local archetype id that was assured.
+  ///
+  COLD_SECTION NO_INLINE ArchetypeId AssureArchetype(const Vector<ComponentId>& components)
+  {
+    return InitializeArchetype(GetArchetypeId(components), components);
+  }
+
+  ///
+  /// Returns the sorted list of component ids that compose the archetype.
+  ///
+  /// @param[in] id Local archetype identifier.
+  ///
+  /// @return List of component ids for the archetype.
+  ///
+  [[nodiscard]] const Vector<ComponentId>& ArchetypeComponents(const ArchetypeId id) const noexcept
+  {
+    ASSERT(id < archetype_components_.size(), "Archetype not initialized");
 
-    states[id] = true;
+    return archetype_components_[id];
+  }
 
-    return true;
+  ///
+  /// Returns the amount of archetypes assured in the relations.
+  ///
+  /// Local archetype ids are always smaller than this amount.
+  ///
+  /// @return Amount of archetypes.
+  ///
+  [[nodiscard]] size_t ArchetypeCount() const noexcept
+  {
+    return archetype_components_.size();
   }
 
   ///
-  /// Initializes the view for the id and the component types.
+  /// Returns the amount of views assured in the relations.
   ///
-  /// @tparam Components The component types of the view.
+  /// Local view ids are always smaller than this amount.
   ///
-  /// @param[in] id The view id.
+  /// @return Amount of views.
   ///
-  template<typename... Components>
-  COLD_SECTION NO_INLINE void InitializeView()
+  [[nodiscard]] size_t ViewCount() const noexcept
+  {
+    return view_components_.size();
+  }
+
+  ///
+  /// Returns the archetype obtained by adding the component to the archetype.
+  ///
+  /// Transitions are cached edges of the archetype graph, the lookup is a short linear scan over the edges of the
+  /// archetype. No hashing or component list comparisons are done.
+  ///
+  /// @param[in] archetype Source archetype identifier.
+  /// @param[in] component Component to add.
+  ///
+  /// @return Destination archetype or cInvalidArchetype if the transition was never cached.
+  ///
+  [[nodiscard]] ArchetypeId FindAddTransition(const ArchetypeId archetype, const ComponentId component) const noexcept
   {
-    const ViewId id = GetViewId<std::remove_cvref_t<Components>...>();
+    ASSERT(archetype < archetype_edges_.size(), "Archetype not initialized");
+
+    for (const auto& edge : archetype_edges_[archetype])
+    {
+      if (edge.component == component) return edge.add;
+    }
 
-    ASSERT(id < MaxViews, "Too many views.");
+    return cInvalidArchetype;
+  }
 
-    std::lock_guard lg(mutex_);
+  ///
+  /// Returns the archetype obtained by removing the component from the archetype.
+  ///
+  /// Transitions are cached edges of the archetype graph, the lookup is a short linear scan over the edges of the
+  /// archetype. No hashing or component list comparisons are done.
+  ///
+  /// @param[in] archetype Source archetype identifier.
+  /// @param[in] component Component to remove.
+  ///
+  /// @return Destination archetype or cInvalidArchetype if the transition was never cached.
+  ///
+  [[nodiscard]] ArchetypeId FindRemoveTransition(
+    const ArchetypeId archetype, const ComponentId component) const noexcept
+  {
+    ASSERT(archetype < archetype_edges_.size(), "Archetype not initialized");
 
-    if (!view_states_[id])
+    for (const auto& edge : archetype_edges_[archetype])
     {
-      Initialize<ViewId, Components...>(view_components_, view_states_, id);
-      AddView(id);
+      if (edge.component == component) return edge.remove;
     }
+
+    return cInvalidArchetype;
   }
 
   ///
-  /// Initializes the archetype for the id and the component types.
+  /// Caches the transition between two archetypes that differ by a single component.
+  ///
+  /// Both directions of the transition are cached. The destination is the source with the component added.
+  ///
+  /// @note Thread-safe
+  ///
+  /// @param[in] source Archetype without the component.
+  /// @param[in] component Component that differs between both archetypes.
+  /// @param[in] destination Archetype with the component.
+  ///
+  COLD_SECTION NO_INLINE void AddTransition(ArchetypeId source, ComponentId component, ArchetypeId destination);
+
+private:
+  ///
+  /// Initializes the view for the view parameters.
   ///
-  /// @tparam Components The component types of the archetype.
+  /// @tparam Components The view parameters.
   ///
-  /// @param[in] id The archetype id.
+  /// @return The local view id.
   ///
   template<typename... Components>
-  COLD_SECTION NO_INLINE void InitializeArchetype()
+  COLD_SECTION NO_INLINE ViewId InitializeView()
   {
-    const ArchetypeId id = GetArchetypeId<std::remove_cvref_t<Components>...>();
+    using Parameters = ViewParameters<Components...>;
 
-    ASSERT(id < MaxArchetypes, "Too many archetypes.");
+    return InitializeView(
+      GetViewId<std::remove_cvref_t<Components>...>(), Parameters::RequiredIds(), Parameters::ExcludedIds());
+  }
 
-    std::lock_guard lg(mutex_);
+  ///
+  /// Translates the global view id into a local id, initializing the view if it was never assured.
+  ///
+  /// @param[in] global Global view identifier.
+  /// @param[in] required Sorted component ids required by the view.
+  /// @param[in] excluded Sorted component ids excluded by the view.
+  ///
+  /// @return The local view id.
+  ///
+  COLD_SECTION NO_INLINE ViewId InitializeView(
+    ViewId global, const Vector<ComponentId>& required, const Vector<ComponentId>& excluded);
 
-    if (!archetype_states_[id])
-    {
-      Initialize<ArchetypeId, Components...>(archetype_components_, archetype_states_, id);
-      AddArchetype(id);
-    }
-  }
+  ///
+  /// Translates the global archetype id into a local id, initializing the archetype if it was never assured.
+  ///
+  /// @param[in] global Global archetype identifier.
+  /// @param[in] components Sorted component ids of the archetype.
+  ///
+  /// @return The local archetype id.
+  ///
+  COLD_SECTION NO_INLINE ArchetypeId InitializeArchetype(ArchetypeId global, const Vector<ComponentId>& components);
 
   ///
   /// Adds the view into the graph. To be called once per view during initialization.
   ///
-  /// @param[in] id Identifier of the view to add.
+  /// @param[in] id Local identifier of the view to add.
+  /// @param[in] excluded Sorted component ids excluded by the view.
   ///
-  void AddView(ViewId id);
+  void AddView(ViewId id, const Vector<ComponentId>& excluded);
 
   ///
   /// Adds the archetype into the graph. To be called once per archetype during initialization.
   ///
-  /// @param[in] id Identifier of the archetype to add.
+  /// @param[in] id Local identifier of the archetype to add.
   ///
   void AddArchetype(ArchetypeId id);
 
 private:
+  ///
+  /// Cached edge of the archetype graph.
+  ///
+  struct ArchetypeEdge
+  {
+    ComponentId component;
+    ArchetypeId add;
+    ArchetypeId remove;
+  };
+
+private:
+  details::LocalIdTable<ArchetypeId, cInvalidArchetype> archetype_locals_;
+  details::LocalIdTable<ViewId, cInvalidView> view_locals_;
+
   Vector<Vector<ArchetypeId>> view_archetypes_;
 
+  Vector<Vector<ArchetypeEdge>> archetype_edges_;
+
   Vector<Vector<ComponentId>> archetype_components_;
   Vector<Vector<ComponentId>> view_components_;
 
-  std::mutex mutex_;
+  details::SignatureTable archetype_signatures_;
+  details::SignatureTable view_signatures_;
+  details::SignatureTable view_excluded_signatures_;
 
-  Vector<bool> archetype_states_;
-  Vector<bool> view_states_;
+  std::mutex mutex_;
 };
 
 } // namespace plex
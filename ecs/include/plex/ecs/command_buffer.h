@@ -0,0 +1,674 @@
+#ifndef PLEX_ECS_COMMAND_BUFFER_H
+#define PLEX_ECS_COMMAND_BUFFER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <span>
+#include <tuple>
+#include <type_traits>
+
+#include "plex/containers/vector.h"
+#include "plex/ecs/registry.h"
+
+namespace plex
+{
+///
+/// Type erased operations of a recorded command.
+///
+/// Executing a command consumes its payload, the payload is destroyed after it is applied. Functions are nullptr when
+/// the operation is not supported or trivial.
+///
+struct CommandInfo
+{
+  void (*execute)(Registry& registry, void* payload);
+  void (*execute_many)(Registry& registry, std::span<void* const> payloads);
+  void (*discard)(void* payload);
+};
+
+namespace details
+{
+  ///
+  /// Payload of a command that adds a component to an entity.
+  ///
+  /// @tparam Component Component type to add.
+  ///
+  template<typename Component>
+  struct AddCommandPayload
+  {
+    Entity entity;
+    Component component;
+  };
+
+  ///
+  /// Destroys the payload of the command without executing it.
+  ///
+  /// @tparam Payload Payload type.
+  ///
+  /// @param[in] payload Payload to destroy.
+  ///
+  template<typename Payload>
+  void DiscardCommand(void* payload)
+  {
+    static_cast<Payload*>(payload)->~Payload();
+  }
+
+  ///
+  /// Creates one entity for every payload of the command, all the entities are created in a single batch.
+  ///
+  /// @tparam Components Components of the created entities.
+  ///
+  /// @param[in] registry Registry to create entities in.
+  /// @param[in] payloads Tuples of components to create the entities with.
+  ///
+  template<typename... Components>
+  void ExecuteCreateMany(Registry& registry, std::span<void* const> payloads)
+  {
+    using Payload = std::tuple<Components...>;
+
+    size_t index = 0;
+
+    registry.CreateMany<Components...>(payloads.size(),
+      [&](Entity)
+      {
+        Payload& payload = *static_cast<Payload*>(payloads[index++]);
+
+        Payload components(std::move(payload));
+        payload.~Payload();
+
+        return components;
+      });
+  }
+
+  ///
+  /// Destroys the entity of the payload if it is still valid.
+  ///
+  /// @param[in] registry Registry to destroy entity in.
+  /// @param[in] payload Entity to destroy.
+  ///
+  inline void ExecuteDestroy(Registry& registry, void* payload)
+  {
+    const Entity entity = *static_cast<Entity*>(payload);
+
+    if (registry.Valid(entity)) registry.Destroy(entity);
+  }
+
+  ///
+  /// Adds the component of the payload to the entity of the payload if it is still valid.
+  ///
+  /// When the entity already has the component, its value is replaced instead, so the last recorded add wins.
+  ///
+  /// @tparam Component Component type to add.
+  ///
+  /// @param[in] registry Registry of the entity.
+  /// @param[in] payload Entity and component to add.
+  ///
+  template<typename Component>
+  void ExecuteAdd(Registry& registry, void* payload)
+  {
+    auto& command = *static_cast<AddCommandPayload<Component>*>(payload);
+
+    if (registry.Valid(command.entity))
+    {
+      if (registry.HasComponents<Component>(command.entity))
+      {
+        registry.Unpack<Component>(command.entity) = std::move(command.component);
+      }
+      else
+      {
+        registry.Add(command.entity, std::move(command.component));
+      }
+    }
+
+    command.~AddCommandPayload<Component>();
+  }
+
+  ///
+  /// Removes the component from the entity of the payload if it is still valid and still has the component.
+  ///
+  /// @tparam Component Component type to remove.
+  ///
+  /// @param[in] registry Registry of the entity.
+  /// @param[in] payload Entity to remove component from.
+  ///
+  template<typename Component>
+  void ExecuteRemove(Registry& registry, void* payload)
+  {
+    const Entity entity = *static_cast<Entity*>(payload);
+
+    if (registry.Valid(entity) && registry.HasComponents<Component>(entity)) registry.Remove<Component>(entity);
+  }
+
+  ///
+  /// Index of the first occurrence of the type in the list of types.
+  ///
+  /// @tparam Type Type to find.
+  /// @tparam Types List of types, must contain the type.
+  ///
+  template<typename Type, typename... Types>
+  inline constexpr size_t cTypeIndex = []()
+  {
+    constexpr bool matches[] { std::is_same_v<Type, Types>... };
+
+    return static_cast<size_t>(std::ranges::find(matches, true) - std::ranges::begin(matches));
+  }();
+
+  ///
+  /// Components sorted in their canonical order, as a tuple.
+  ///
+  /// @tparam Components Component types.
+  ///
+  template<typename... Components>
+  using SortedComponents = typename SortInto<std::tuple<>, std::tuple<Components...>>::type;
+
+  template<typename... Components>
+  inline constexpr CommandInfo cCreateCommandInfo {
+    nullptr,
+    ExecuteCreateMany<Components...>,
+    std::is_trivially_destructible_v<std::tuple<Components...>> ? nullptr : DiscardCommand<std::tuple<Components...>>,
+  };
+
+  inline constexpr CommandInfo cDestroyCommandInfo { ExecuteDestroy, nullptr, nullptr };
+
+  template<typename Component>
+  inline constexpr CommandInfo cAddCommandInfo {
+    ExecuteAdd<Component>,
+    nullptr,
+    std::is_trivially_destructible_v<Component> ? nullptr : DiscardCommand<AddCommandPayload<Component>>,
+  };
+
+  template<typename Component>
+  inline constexpr CommandInfo cRemoveCommandInfo { ExecuteRemove<Component>, nullptr, nullptr };
+} // namespace details
+
+///
+/// Records structural changes of a registry to apply them later.
+///
+/// Creating or destroying entities and adding or removing components is not thread-safe. Systems that run in parallel
+/// record their structural changes in their own command buffer instead, the buffers are played back together once the
+/// systems are done.
+///
+/// The payloads of the commands are packed one after the other in a linear arena of large blocks. Blocks never move,
+/// the payloads do not need to be relocatable, and they are reused after every playback.
+///
+/// @see CommandBuffers
+///
+class CommandBuffer final
+{
+public:
+  static constexpr size_t cBlockSize = 16384;
+  static constexpr size_t cCommandAlignment = alignof(std::max_align_t);
+
+  ///
+  /// Constructor.
+  ///
+  CommandBuffer() noexcept : last_creation_(0), current_(0) {}
+
+  ///
+  /// Destructor.
+  ///
+  ~CommandBuffer()
+  {
+    Clear();
+
+    for (const auto& block : blocks_)
+    {
+      ::operator delete(block.data, std::align_val_t { cCommandAlignment });
+    }
+  }
+
+  CommandBuffer(const CommandBuffer&) = delete;
+  CommandBuffer(CommandBuffer&&) = delete;
+  CommandBuffer& operator=(const CommandBuffer&) = delete;
+  CommandBuffer& operator=(CommandBuffer&&) = delete;
+
+  ///
+  /// Records the creation of an entity with the given components.
+  ///
+  /// The entity identifier is only known when the command buffer is played back. The components are stored in their
+  /// canonical order, creations of the same components given in a different order are batched together.
+  ///
+  /// @tparam Components List of component types of the entity.
+  ///
+  /// @param[in] components Component data to create entity with.
+  ///
+  template<typename... Components>
+  void Create(Components&&... components)
+  {
+    using Sorted = details::SortedComponents<std::remove_cvref_t<Components>...>;
+
+    RecordSortedCreation(std::type_identity<Sorted> {}, std::forward<Components>(components)...);
+  }
+
+  ///
+  /// Records the destruction of the entity.
+  ///
+  /// Entities that are no longer valid when the command buffer is played back are ignored. A destroyed entity whose
+  /// index was reused before the playback is only detected with generations, see Registry::Valid.
+  ///
+  /// @param[in] entity Entity to destroy.
+  ///
+  void Destroy(const Entity entity)
+  {
+    ::new (Record<Entity>(details::cDestroyCommandInfo)) Entity(entity);
+  }
+
+  ///
+  /// Records adding the component to the entity.
+  ///
+  /// Entities that are no longer valid when the command buffer is played back are ignored. A destroyed entity whose
+  /// index was reused before the playback is only detected with generations, see Registry::Valid.
+  ///
+  /// @tparam Component Type of component to add.
+  ///
+  /// @param[in] entity Entity to add component to.
+  /// @param[in] component Component data to add.
+  ///
+  template<typename Component>
+  void Add(const Entity entity, Component&& component)
+  {
+    using Type = std::remove_cvref_t<Component>;
+    using Payload = details::AddCommandPayload<Type>;
+
+    ::new (Record<Payload>(details::cAddCommandInfo<Type>)) Payload { entity, std::forward<Component>(component) };
+  }
+
+  ///
+  /// Records removing the component from the entity.
+  ///
+  /// Entities that are no longer valid when the command buffer is played back are ignored. A destroyed entity whose
+  /// index was reused before the playback is only detected with generations, see Registry::Valid.
+  ///
+  /// @tparam Component Type of component to remove.
+  ///
+  /// @param[in] entity Entity to remove component from.
+  ///
+  template<typename Component>
+  void Remove(const Entity entity)
+  {
+    ::new (Record<Entity>(details::cRemoveCommandInfo<std::remove_cvref_t<Component>>)) Entity(entity);
+  }
+
+  ///
+  /// Applies every recorded command to the registry and clears the command buffer.
+  ///
+  /// @see CommandBuffer::Playback(Registry&, std::span<CommandBuffer* const>)
+  ///
+  /// @param[in] registry Registry to apply commands to.
+  ///
+  void Playback(Registry& registry)
+  {
+    CommandBuffer* const buffers[] { this };
+
+    Playback(registry, buffers);
+  }
+
+  ///
+  /// Applies every command recorded in the command buffers to the registry and clears the command buffers.
+  ///
+  /// Creations are applied first. They are grouped by components, every group is then created in a single batch.
+  /// The other commands are applied after, in the order they were recorded for every buffer.
+  ///
+  /// @param[in] registry Registry to apply commands to.
+  /// @param[in] buffers Command buffers to play back.
+  ///
+  static void Playback(Registry& registry, std::span<CommandBuffer* const> buffers)
+  {
+    if (buffers.size() == 1)
+    {
+      for (const auto& group : buffers[0]->creations_)
+      {
+        group.Execute(registry);
+      }
+    }
+    else
+    {
+      Vector<CreationGroup> groups;
+
+      for (const auto buffer : buffers)
+      {
+        for (const auto& group : buffer->creations_)
+        {
+          auto it = std::ranges::find(groups, group.info, &CreationGroup::info);
+
+          if (it == groups.end())
+          {
+            groups.push_back({ group.info, {} });
+            it = groups.end() - 1;
+          }
+
+          const size_t offset = it->payloads.size();
+
+          it->payloads.resize(offset + group.payloads.size());
+
+          std::ranges::copy(group.payloads, it->payloads.begin() + offset);
+        }
+      }
+
+      for (const auto& group : groups)
+      {
+        group.Execute(registry);
+      }
+    }
+
+    for (const auto buffer : buffers)
+    {
+      for (const auto& command : buffer->commands_)
+      {
+        command.info->execute(registry, command.payload);
+      }
+
+      buffer->Reset();
+    }
+  }
+
+  ///
+  /// Discards every recorded command.
+  ///
+  void Clear()
+  {
+    for (const auto& group : creations_)
+    {
+      if (!group.info->discard) continue;
+
+      for (const auto payload : group.payloads)
+      {
+        group.info->discard(payload);
+      }
+    }
+
+    for (const auto& command : commands_)
+    {
+      if (command.info->discard) command.info->discard(command.payload);
+    }
+
+    Reset();
+  }
+
+  ///
+  /// Returns the amount of recorded commands.
+  ///
+  /// @return Amount of commands.
+  ///
+  [[nodiscard]] size_t Size() const noexcept
+  {
+    size_t size = commands_.size();
+
+    for (const auto& group : creations_)
+    {
+      size += group.payloads.size();
+    }
+
+    return size;
+  }
+
+  ///
+  /// Returns whether or not there are no recorded commands.
+  ///
+  /// @return True if there are no commands, false otherwise.
+  ///
+  [[nodiscard]] bool Empty() const noexcept
+  {
+    return Size() == 0;
+  }
+
+private:
+  ///
+  /// Recorded command other than a creation.
+  ///
+  struct RecordedCommand
+  {
+    const CommandInfo* info;
+    void* payload;
+  };
+
+  ///
+  /// Block of the arena.
+  ///
+  struct Block
+  {
+    std::byte* data;
+    size_t size;
+    size_t capacity;
+  };
+
+  ///
+  /// Payloads of the creations of the same components, created together during playback.
+  ///
+  struct CreationGroup
+  {
+    const CommandInfo* info;
+    Vector<void*> payloads;
+
+    ///
+    /// Creates the entities of the group in a single batch.
+    ///
+    /// @param[in] registry Registry to create entities in.
+    ///
+    void Execute(Registry& registry) const
+    {
+      if (!payloads.empty()) info->execute_many(registry, std::span<void* const>(payloads.data(), payloads.size()));
+    }
+  };
+
+  ///
+  /// Records the creation of an entity and returns the uninitialized memory of its payload.
+  ///
+  /// Creations are grouped by components as they are recorded, the last group used is tested first.
+  ///
+  /// @tparam Payload Payload type of the creation.
+  ///
+  /// @param[in] info Operations of the creation.
+  ///
+  /// @return Memory to construct the payload in.
+  ///
+  template<typename Payload>
+  void* RecordCreation(const CommandInfo& info)
+  {
+    static_assert(alignof(Payload) <= cCommandAlignment, "Over-aligned payloads are not supported");
+
+    void* payload = Allocate(sizeof(Payload), alignof(Payload));
+
+    if (last_creation_ >= creations_.size() || creations_[last_creation_].info != &info) [[unlikely]]
+    {
+      last_creation_ = FindCreationGroup(&info);
+    }
+
+    creations_[last_creation_].payloads.push_back(payload);
+
+    return payload;
+  }
+
+  ///
+  /// Records the creation of an entity, constructing its payload with the components in their canonical order.
+  ///
+  /// @tparam Sorted Component types in their canonical order.
+  /// @tparam Components Component types in the order they were given.
+  ///
+  /// @param[in] components Component data to create entity with.
+  ///
+  template<typename... Sorted, typename... Components>
+  void RecordSortedCreation(std::type_identity<std::tuple<Sorted...>>, Components&&... components)
+  {
+    using Payload = std::tuple<Sorted...>;
+
+    auto arguments = std::forward_as_tuple(std::forward<Components>(components)...);
+
+    ::new (RecordCreation<Payload>(details::cCreateCommandInfo<Sorted...>))
+      Payload(std::get<details::cTypeIndex<Sorted, std::remove_cvref_t<Components>...>>(std::move(arguments))...);
+  }
+
+  ///
+  /// Returns the index of the creation group for the operations, adding the group if needed.
+  ///
+  /// @param[in] info Operations of the creation.
+  ///
+  /// @return Index of the group.
+  ///
+  size_t FindCreationGroup(const CommandInfo* info)
+  {
+    const auto it = std::ranges::find(creations_, info, &CreationGroup::info);
+
+    if (it != creations_.end()) return static_cast<size_t>(it - creations_.begin());
+
+    creations_.push_back({ info, {} });
+
+    return creations_.size() - 1;
+  }
+
+  ///
+  /// Records a command and returns the uninitialized memory of its payload.
+  ///
+  /// @tparam Payload Payload type of the command.
+  ///
+  /// @param[in] info Operations of the command.
+  ///
+  /// @return Memory to construct the payload in.
+  ///
+  template<typename Payload>
+  void* Record(const CommandInfo& info)
+  {
+    static_assert(alignof(Payload) <= cCommandAlignment, "Over-aligned payloads are not supported");
+
+    void* payload = Allocate(sizeof(Payload), alignof(Payload));
+
+    commands_.push_back({ &info, payload });
+
+    return payload;
+  }
+
+  ///
+  /// Allocates memory at the end of the arena.
+  ///
+  /// @param[in] size Amount of bytes.
+  /// @param[in] alignment Alignment of the memory, at most the command alignment.
+  ///
+  /// @return Allocated memory.
+  ///
+  std::byte* Allocate(const size_t size, const size_t alignment)
+  {
+    size_t offset = 0;
+
+    for (; current_ != blocks_.size(); ++current_)
+    {
+      offset = (blocks_[current_].size + alignment - 1) & ~(alignment - 1);
+
+      if (offset + size <= blocks_[current_].capacity) [[likely]] break;
+    }
+
+    if (current_ == blocks_.size()) [[unlikely]]
+    {
+      AllocateBlock(size);
+
+      offset = 0;
+    }
+
+    Block& block = blocks_[current_];
+
+    block.size = offset + size;
+
+    return block.data + offset;
+  }
+
+  ///
+  /// Allocates a new block at the end of the arena.
+  ///
+  /// @param[in] size Minimum capacity of the block.
+  ///
+  COLD_SECTION NO_INLINE void AllocateBlock(const size_t size)
+  {
+    const size_t capacity = std::max(size, cBlockSize);
+
+    auto data = static_cast<std::byte*>(::operator new(capacity, std::align_val_t { cCommandAlignment }));
+
+    blocks_.push_back({ data, 0, capacity });
+  }
+
+  ///
+  /// Empties the arena without destroying the payloads, the blocks are kept for reuse.
+  ///
+  void Reset() noexcept
+  {
+    for (auto& block : blocks_)
+    {
+      block.size = 0;
+    }
+
+    for (auto& group : creations_)
+    {
+      group.payloads.clear();
+    }
+
+    commands_.clear();
+
+    current_ = 0;
+  }
+
+private:
+  Vector<CreationGroup> creations_;
+  Vector<RecordedCommand> commands_;
+  Vector<Block> blocks_;
+
+  size_t last_creation_;
+  size_t current_;
+};
+
+///
+/// Thread-safe pool of command buffers, typically one per system that records structural changes.
+///
+/// Systems obtain their command buffer once, then record into it without synchronization. Every buffer of the pool is
+/// played back at once, usually at the end of a stage.
+///
+class CommandBuffers final
+{
+public:
+  ///
+  /// Creates a new command buffer owned by the pool.
+  ///
+  /// @note Thread-safe
+  ///
+  /// @return The command buffer.
+  ///
+  COLD_SECTION NO_INLINE CommandBuffer& Obtain()
+  {
+    std::scoped_lock lock(mutex_);
+
+    buffers_.push_back(std::make_unique<CommandBuffer>());
+
+    return *buffers_.back();
+  }
+
+  ///
+  /// Applies the commands of every buffer of the pool to the registry and clears the buffers.
+  ///
+  /// @warning Must not be called while commands are recorded.
+  ///
+  /// @see CommandBuffer::Playback(Registry&, std::span<CommandBuffer* const>)
+  ///
+  /// @param[in] registry Registry to apply commands to.
+  ///
+  void Playback(Registry& registry)
+  {
+    std::scoped_lock lock(mutex_);
+
+    Vector<CommandBuffer*> buffers;
+    buffers.reserve(buffers_.size());
+
+    for (const auto& buffer : buffers_)
+    {
+      buffers.push_back(buffer.get());
+    }
+
+    CommandBuffer::Playback(registry, std::span<CommandBuffer* const>(buffers.data(), buffers.size()));
+  }
+
+private:
+  Vector<std::unique_ptr<CommandBuffer>> buffers_;
+
+  std::mutex mutex_;
+};
+} // namespace plex
+
+#endif
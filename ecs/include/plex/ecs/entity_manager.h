@@ -1,18 +1,123 @@
 #ifndef PLEX_ECS_ENTITY_MANAGER_H
 #define PLEX_ECS_ENTITY_MANAGER_H
 
+#include <algorithm>
 #include <concepts>
+#include <cstdint>
+#include <cstdlib>
+#include <span>
 
+#include "plex/config/compiler.h"
 #include "plex/containers/vector.h"
 
+#ifndef PLEX_ECS_ENTITY_GENERATION_BITS
+///
+/// Default amount of high bits of the 32 bit entity identifier used to store the generation, the remaining low bits
+/// store the index. Generations are disabled by default, every bit given to the generation halves the amount of
+/// entities that can exist: with 8 bits, the registry is limited to 16,777,215 entities.
+///
+/// Set with the PLEX_ECS_ENTITY_GENERATION_BITS CMake option, which defines it for every target linking plex-ecs. Every
+/// translation unit that includes the registry must see the same value.
+///
+#define PLEX_ECS_ENTITY_GENERATION_BITS 0
+#endif
+
 namespace plex
 {
+///
+/// Describes how an entity identifier is split into an index and a generation.
+///
+/// The index is what storages and sparse arrays are indexed with. The generation is incremented every time the index
+/// is recycled, so an identifier kept after its entity was destroyed never matches the entity that reuses the index.
+/// Without generation bits, which is the default, the identifier is the index and a stale identifier matches the entity
+/// that reuses its index.
+///
+/// @note
+///    The generation wraps around, a stale identifier can only alias after its index was recycled 2^GenerationBits
+///    times.
+///
+/// @tparam Entity Entity of integral type.
+/// @tparam GenerationBits Amount of high bits used to store the generation.
+///
+template<std::unsigned_integral Entity, size_t GenerationBits = PLEX_ECS_ENTITY_GENERATION_BITS>
+struct EntityTraits
+{
+  static constexpr size_t cGenerationBits = GenerationBits;
+  static constexpr size_t cIndexBits = 32 - cGenerationBits;
+
+  static_assert(cGenerationBits < 32, "Entity index needs at least one bit");
+  static_assert(sizeof(Entity) >= sizeof(uint32_t), "Entity must have at least 32 bits");
+
+  static constexpr Entity cIndexMask = static_cast<Entity>((uint64_t { 1 } << cIndexBits) - 1);
+  static constexpr Entity cGenerationMask = static_cast<Entity>((uint64_t { 1 } << cGenerationBits) - 1);
+
+  ///
+  /// Returns the index part of the entity.
+  ///
+  /// @param[in] entity Entity identifier.
+  ///
+  /// @return Index of the entity.
+  ///
+  [[nodiscard]] static constexpr Entity Index(const Entity entity) noexcept
+  {
+    return entity & cIndexMask;
+  }
+
+  ///
+  /// Returns the generation part of the entity.
+  ///
+  /// @param[in] entity Entity identifier.
+  ///
+  /// @return Generation of the entity.
+  ///
+  [[nodiscard]] static constexpr Entity Generation(const Entity entity) noexcept
+  {
+    if constexpr (cGenerationBits == 0) return 0;
+    else
+    {
+      return (entity >> cIndexBits) & cGenerationMask;
+    }
+  }
+
+  ///
+  /// Combines an index and a generation into an entity identifier.
+  ///
+  /// @param[in] index Index of the entity.
+  /// @param[in] generation Generation of the entity, wraps around.
+  ///
+  /// @return Entity identifier.
+  ///
+  [[nodiscard]] static constexpr Entity Combine(const Entity index, const Entity generation) noexcept
+  {
+    if constexpr (cGenerationBits == 0) return index;
+    else
+    {
+      return (index & cIndexMask) | static_cast<Entity>((generation & cGenerationMask) << cIndexBits);
+    }
+  }
+
+  ///
+  /// Returns the identifier with the same index and the next generation.
+  ///
+  /// @param[in] entity Entity identifier.
+  ///
+  /// @return Entity identifier of the next generation.
+  ///
+  [[nodiscard]] static constexpr Entity NextGeneration(const Entity entity) noexcept
+  {
+    return Combine(Index(entity), Generation(entity) + 1);
+  }
+};
+
 ///
 /// Responsible for providing and recycling entity identifiers.
 ///
+/// Released identifiers are recycled with their generation incremented, see EntityTraits.
+///
 /// @tparam Entity Entity of integral type to generate.
+/// @tparam GenerationBits Amount of high bits used to store the generation.
 ///
-template<std::unsigned_integral Entity>
+template<std::unsigned_integral Entity, size_t GenerationBits = PLEX_ECS_ENTITY_GENERATION_BITS>
 class EntityManager final
 {
 public:
@@ -63,19 +168,60 @@ public:
   ///
   [[nodiscard]] constexpr Entity Generate() noexcept
   {
+    if (current_ >= Traits::cIndexMask) [[unlikely]] OutOfIndices();
+
     return current_++;
   }
 
   ///
-  /// Releases the entity identifier allowing it to be reused.
+  /// Generates a block of contiguous new entity identifiers.
+  ///
+  /// Recycled identifiers are never part of the block, they are kept for later calls to Obtain.
+  ///
+  /// @param[in] amount Amount of identifiers to generate.
+  ///
+  /// @return First identifier of the block.
+  ///
+  [[nodiscard]] constexpr Entity GenerateMany(const size_t amount) noexcept
+  {
+    if (amount > static_cast<size_t>(Traits::cIndexMask - current_)) [[unlikely]] OutOfIndices();
+
+    const Entity first = current_;
+
+    current_ += static_cast<Entity>(amount);
+
+    return first;
+  }
+
+  ///
+  /// Releases the entity identifier allowing its index to be reused with the next generation.
   ///
   /// @param[in] entity Entity identifier to release.
   ///
   void Release(const Entity entity) noexcept
   {
-    ASSERT(entity <= current_, "Entity not from this manager");
+    ASSERT(Traits::Index(entity) < current_, "Entity not from this manager");
 
-    recycled_.push_back(entity);
+    recycled_.push_back(Traits::NextGeneration(entity));
+  }
+
+  ///
+  /// Releases many entity identifiers at once allowing them to be reused.
+  ///
+  /// @param[in] entities Pointer to the first entity identifier to release.
+  /// @param[in] amount Amount of entity identifiers to release.
+  ///
+  void ReleaseMany(const Entity* entities, const size_t amount)
+  {
+    ASSERT(std::all_of(
+             entities, entities + amount, [this](Entity entity) { return Traits::Index(entity) < current_; }),
+      "Entity not from this manager");
+
+    const size_t size = recycled_.size();
+
+    recycled_.resize(size + amount);
+
+    std::transform(entities, entities + amount, recycled_.data() + size, Traits::NextGeneration);
   }
 
   ///
@@ -108,7 +254,59 @@ public:
     return recycled_.size();
   }
 
+  ///
+  /// Returns the amount of entity identifiers that were ever generated, circulating or recycled.
+  ///
+  /// @return Amount of generated entity identifiers.
+  ///
+  [[nodiscard]] constexpr size_t GeneratedCount() const noexcept
+  {
+    return current_;
+  }
+
+  ///
+  /// Returns the entity identifiers ready to be reused, in the order they are obtained from last to first.
+  ///
+  /// @return Recycled entity identifiers.
+  ///
+  [[nodiscard]] std::span<const Entity> Recycled() const noexcept
+  {
+    return { recycled_.data(), recycled_.size() };
+  }
+
+  ///
+  /// Restores the state of the manager, for example from a snapshot. Every other identifier generated so far is
+  /// considered circulating.
+  ///
+  /// @param[in] generated Amount of entity identifiers that were generated.
+  /// @param[in] recycled Entity identifiers ready to be reused.
+  ///
+  void Restore(const size_t generated, const std::span<const Entity> recycled)
+  {
+    ASSERT(generated <= Traits::cIndexMask, "Out of entity indices");
+    ASSERT(std::ranges::all_of(recycled, [generated](Entity entity) { return Traits::Index(entity) < generated; }),
+      "Entity not from this manager");
+
+    current_ = static_cast<Entity>(generated);
+
+    recycled_.resize(recycled.size());
+
+    std::ranges::copy(recycled, recycled_.begin());
+  }
+
 private:
+  using Traits = EntityTraits<Entity, GenerationBits>;
+
+  ///
+  /// Terminates the program when every entity index is used. Indices past the limit would spill into the generation
+  /// and alias other entities.
+  ///
+  [[noreturn]] COLD_SECTION NO_INLINE static void OutOfIndices() noexcept
+  {
+    ASSERT(false, "Out of entity indices");
+    std::abort();
+  }
+
   Entity current_;
   Vector<Entity> recycled_;
 };
@@ -0,0 +1,508 @@
+#ifndef PLEX_ECS_HIERARCHY_H
+#define PLEX_ECS_HIERARCHY_H
+
+#include <algorithm>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "plex/async/task.h"
+#include "plex/async/thread_pool.h"
+#include "plex/async/when_all.h"
+#include "plex/containers/vector.h"
+#include "plex/ecs/registry.h"
+
+namespace plex
+{
+///
+/// Component of the entities that have a parent.
+///
+/// The depth is the amount of ancestors of the entity, entities without a parent are roots at depth zero. Entities with
+/// a parent are kept sorted by depth in their storages, so that a hierarchy can be walked breadth first with linear
+/// passes over the storages.
+///
+/// @warning Only modify through SetParent and RemoveParent.
+///
+struct Parent
+{
+  Entity entity;
+  uint32_t depth;
+};
+
+///
+/// Component of the entities that have children.
+///
+/// @warning Only modify through SetParent and RemoveParent.
+///
+struct Children
+{
+  Vector<Entity> entities;
+};
+
+namespace details
+{
+  ///
+  /// Singleton of the registry that tracks whether the storages of the entities with a parent are still sorted by
+  /// depth.
+  ///
+  struct HierarchyOrder
+  {
+    bool dirty = true; // Depths changed since the last sort
+    Vector<size_t> versions; // Layout version of every storage of the entities with a parent after the last sort
+  };
+
+  ///
+  /// Marks the hierarchies of the registry as needing a sort, after depths changed.
+  ///
+  /// @param[in] registry Registry of the hierarchies.
+  ///
+  inline void MarkHierarchiesUnsorted(Registry& registry)
+  {
+    if (registry.HasSingleton<HierarchyOrder>()) registry.Get<HierarchyOrder>().dirty = true;
+  }
+
+  ///
+  /// Returns the depth of the entity in its hierarchy.
+  ///
+  /// @param[in] registry Registry of the entity.
+  /// @param[in] entity Entity to get depth for.
+  ///
+  /// @return Amount of ancestors of the entity.
+  ///
+  inline uint32_t HierarchyDepth(Registry& registry, const Entity entity)
+  {
+    const auto parents = registry.ViewFor<const Parent>();
+
+    return parents.Contains(entity) ? parents.Unpack<Parent>(entity).depth : 0;
+  }
+
+  ///
+  /// Removes the child from the children of its parent. The parent loses its children component with its last child.
+  ///
+  /// @param[in] registry Registry of the entities.
+  /// @param[in] parent Parent of the child.
+  /// @param[in] child Child to remove.
+  ///
+  inline void DetachChild(Registry& registry, const Entity parent, const Entity child)
+  {
+    Vector<Entity>& children = registry.Unpack<Children>(parent).entities;
+
+    children.SwapAndPop(std::ranges::find(children, child));
+
+    if (children.empty()) registry.Remove<Children>(parent);
+  }
+
+  ///
+  /// Updates the depth of every descendant of the entity, breadth first.
+  ///
+  /// @param[in] registry Registry of the entities.
+  /// @param[in] entity Entity whose depth changed.
+  /// @param[in] depth New depth of the entity.
+  ///
+  inline void UpdateDescendantDepths(Registry& registry, const Entity entity, const uint32_t depth)
+  {
+    const auto children = registry.ViewFor<const Children>();
+    auto parents = registry.ViewFor<Parent>();
+
+    Vector<Entity> queue;
+    queue.push_back(entity);
+
+    for (size_t i = 0; i != queue.size(); ++i)
+    {
+      if (!children.Contains(queue[i])) continue;
+
+      const uint32_t child_depth = (i == 0 ? depth : parents.Unpack<Parent>(queue[i]).depth) + 1;
+
+      for (const Entity child : children.Unpack<Children>(queue[i]).entities)
+      {
+        parents.Unpack<Parent>(child).depth = child_depth;
+        queue.push_back(child);
+      }
+    }
+  }
+
+  ///
+  /// Returns the index of the first entity of the sub view that is deeper than the depth.
+  ///
+  /// @tparam SubViewType Sub view of entities with a parent, sorted by depth.
+  ///
+  /// @param[in] view Sub view to search.
+  /// @param[in] first Index of the first entity of the level, no entity before it is deeper than the depth.
+  /// @param[in] depth Depth of the level.
+  ///
+  /// @return Index past the last entity of the level.
+  ///
+  template<typename SubViewType>
+  size_t HierarchyLevelEnd(const SubViewType& view, size_t first, const uint32_t depth)
+  {
+    const size_t capacity = view.ChunkCapacity();
+
+    size_t last = view.Size();
+
+    while (first < last)
+    {
+      const size_t middle = first + (last - first) / 2;
+
+      const Parent* parents = std::get<0>(view.template ChunkData<const Parent>(middle / capacity));
+
+      if (parents[middle & (capacity - 1)].depth <= depth) first = middle + 1;
+      else
+      {
+        last = middle;
+      }
+    }
+
+    return first;
+  }
+
+  ///
+  /// Invokes the function for every level of a hierarchy, from the shallowest to the deepest.
+  ///
+  /// Every level is a range of entities in every sub view of the view, the ranges are sorted by depth beforehand.
+  ///
+  /// @tparam ViewType View of entities with a parent.
+  /// @tparam Function Invocable with the sub views and the ranges of the level in each of them.
+  ///
+  /// @param[in] view View to walk.
+  /// @param[in] function Function to invoke for every level.
+  ///
+  template<typename ViewType, typename Function>
+  void ForEachHierarchyLevel(const ViewType& view, Function&& function)
+  {
+    using SubViewType = std::remove_cvref_t<decltype(*view.begin())>;
+
+    Vector<SubViewType> sub_views;
+    Vector<size_t> ends;
+
+    for (auto&& sub_view : view)
+    {
+      if (sub_view.Size() == 0) continue;
+
+      sub_views.push_back(sub_view);
+      ends.push_back(0);
+    }
+
+    Vector<size_t> firsts = ends;
+
+    for (uint32_t depth = 1; !sub_views.empty(); ++depth)
+    {
+      for (size_t i = 0; i != sub_views.size(); ++i)
+      {
+        firsts[i] = ends[i];
+        ends[i] = HierarchyLevelEnd(sub_views[i], firsts[i], depth);
+      }
+
+      function(sub_views, firsts, ends);
+
+      for (size_t i = 0; i != sub_views.size();)
+      {
+        if (ends[i] == sub_views[i].Size())
+        {
+          sub_views.SwapAndPop(sub_views.begin() + static_cast<ptrdiff_t>(i));
+          ends.SwapAndPop(ends.begin() + static_cast<ptrdiff_t>(i));
+          firsts.pop_back();
+        }
+        else
+        {
+          ++i;
+        }
+      }
+    }
+  }
+} // namespace details
+
+///
+/// Makes the entity a child of the parent. The entity is removed from the children of its previous parent, if any.
+///
+/// The depth of the entity and of all its descendants is updated. Their storages are sorted by depth again the next
+/// time the hierarchies are sorted, only the storages that are out of order are sorted.
+///
+/// @warning The parent must not be the entity or one of its descendants.
+///
+/// @param[in] registry Registry of the entities.
+/// @param[in] entity Entity to make a child.
+/// @param[in] parent Entity to make the parent.
+///
+inline void SetParent(Registry& registry, const Entity entity, const Entity parent)
+{
+  ASSERT(registry.Valid(entity) && registry.Valid(parent), "Entity does not exist");
+
+  ASSERT(entity != parent, "Entity cannot be its own parent");
+
+#ifndef NDEBUG
+  const auto parents = registry.ViewFor<const Parent>();
+
+  for (Entity ancestor = parent; parents.Contains(ancestor); ancestor = parents.Unpack<Parent>(ancestor).entity)
+  {
+    ASSERT(parents.Unpack<Parent>(ancestor).entity != entity, "Parent cannot be a descendant of the entity");
+  }
+#endif
+
+  const uint32_t depth = details::HierarchyDepth(registry, parent) + 1;
+
+  details::MarkHierarchiesUnsorted(registry);
+
+  if (registry.HasComponents<Parent>(entity))
+  {
+    Parent& current = registry.Unpack<Parent>(entity);
+
+    if (current.entity == parent) return;
+
+    const Entity previous = current.entity;
+    const uint32_t previous_depth = current.depth;
+
+    current = { parent, depth };
+
+    details::DetachChild(registry, previous, entity);
+
+    if (depth != previous_depth) details::UpdateDescendantDepths(registry, entity, depth);
+  }
+  else
+  {
+    registry.Add(entity, Parent { parent, depth });
+
+    details::UpdateDescendantDepths(registry, entity, depth);
+  }
+
+  if (registry.HasComponents<Children>(parent)) registry.Unpack<Children>(parent).entities.push_back(entity);
+  else
+  {
+    Children children;
+    children.entities.push_back(entity);
+
+    registry.Add(parent, std::move(children));
+  }
+}
+
+///
+/// Removes the entity from the children of its parent, the entity becomes the root of its own hierarchy.
+///
+/// @param[in] registry Registry of the entity.
+/// @param[in] entity Entity to remove parent of.
+///
+inline void RemoveParent(Registry& registry, const Entity entity)
+{
+  ASSERT(registry.HasComponents<Parent>(entity), "Entity does not have a parent");
+
+  const auto parents = registry.ViewFor<const Parent>();
+
+  const Entity parent = parents.Unpack<Parent>(entity).entity;
+
+  registry.Remove<Parent>(entity);
+
+  details::MarkHierarchiesUnsorted(registry);
+  details::DetachChild(registry, parent, entity);
+  details::UpdateDescendantDepths(registry, entity, 0);
+}
+
+///
+/// Destroys the entity and all its descendants. The entity is removed from the children of its parent.
+///
+/// @param[in] registry Registry of the entity.
+/// @param[in] entity Entity to destroy with its descendants.
+///
+inline void DestroyHierarchy(Registry& registry, const Entity entity)
+{
+  if (registry.HasComponents<Parent>(entity)) RemoveParent(registry, entity);
+
+  const auto children = registry.ViewFor<const Children>();
+
+  Vector<Entity> queue;
+  queue.push_back(entity);
+
+  for (size_t i = 0; i != queue.size(); ++i)
+  {
+    if (!children.Contains(queue[i])) continue;
+
+    for (const Entity child : children.Unpack<Children>(queue[i]).entities)
+    {
+      queue.push_back(child);
+    }
+  }
+
+  for (const Entity descendant : queue)
+  {
+    registry.Destroy(descendant);
+  }
+}
+
+///
+/// Sorts the storages of the entities with a parent by depth, breadth first.
+///
+/// Nothing is done when no parent was set or removed and no entity with a parent was added, removed or moved in its
+/// storage since the last sort. Otherwise, storages that are already sorted are only scanned, entities are only moved
+/// in the storages that are out of order.
+///
+/// @param[in] registry Registry to sort hierarchies of.
+///
+inline void SortHierarchies(Registry& registry)
+{
+  if (!registry.HasSingleton<details::HierarchyOrder>()) registry.Set<details::HierarchyOrder>();
+
+  auto& order = registry.Get<details::HierarchyOrder>();
+  auto parents = registry.ViewFor<Parent>();
+
+  bool sorted = !order.dirty;
+  size_t index = 0;
+
+  for (auto&& sub_view : parents)
+  {
+    sorted = sorted && index < order.versions.size() && order.versions[index] == sub_view.Version();
+    ++index;
+  }
+
+  if (sorted && index == order.versions.size()) return;
+
+  parents.Sort<Parent>([](const Parent& parent) { return parent.depth; });
+
+  order.versions.clear();
+
+  for (auto&& sub_view : parents)
+  {
+    order.versions.push_back(sub_view.Version());
+  }
+
+  order.dirty = false;
+}
+
+///
+/// Propagates a component down every hierarchy of the registry, typically world transforms computed from local
+/// transforms.
+///
+/// Hierarchies are sorted, then walked level by level: every level is a contiguous range of entities in each storage.
+/// Parents are always visited before their children, a single linear pass over the storages visits every entity with a
+/// parent once, without recursion.
+///
+/// The propagated component of the roots is not computed, it is read as is.
+///
+/// @code
+/// PropagateHierarchies<LocalTransform, WorldTransform>(registry,
+///   [](const WorldTransform& parent, const LocalTransform& local, WorldTransform& world) { world = parent * local; });
+/// @endcode
+///
+/// @tparam Local Component of every entity with a parent that is combined with the propagated component of the parent.
+/// @tparam World Component that is propagated, every parent must have it.
+/// @tparam Function Invocable with the component of the parent, the local component and the component to compute.
+///
+/// @param[in] registry Registry to propagate in.
+/// @param[in] function Function that computes the propagated component of a child.
+///
+template<typename Local, typename World, typename Function>
+void PropagateHierarchies(Registry& registry, Function function)
+{
+  SortHierarchies(registry);
+
+  const auto worlds = registry.ViewFor<const World>();
+
+  auto propagate = [&worlds, &function](const Parent& parent, const Local& local, World& world)
+  { function(worlds.template Unpack<World>(parent.entity), local, world); };
+
+  details::ForEachHierarchyLevel(registry.ViewFor<const Parent, const Local, World>(),
+    [&propagate](const auto& sub_views, const Vector<size_t>& firsts, const Vector<size_t>& ends)
+    {
+      for (size_t i = 0; i != sub_views.size(); ++i)
+      {
+        details::EntityForEachRange(sub_views[i], firsts[i], ends[i], propagate);
+      }
+    });
+}
+
+///
+/// Propagates a component down every hierarchy of the registry in parallel on the thread pool.
+///
+/// Levels are propagated one after the other, the entities of a level do not depend on each other. Every level is
+/// split into ranges of at least the grain size, rounded to whole chunks, and each range is executed as a separate
+/// task on the pool. Levels with no more entities than the grain size are propagated serially on the awaiting thread.
+///
+/// @see PropagateHierarchies
+///
+/// @warning The registry must not be modified until the returned task completes.
+///
+/// @tparam Local Component of every entity with a parent that is combined with the propagated component of the parent.
+/// @tparam World Component that is propagated, every parent must have it.
+/// @tparam Function Invocable with the component of the parent, the local component and the component to compute.
+///
+/// @param[in] registry Registry to propagate in.
+/// @param[in] pool Thread pool to execute on.
+/// @param[in] function Function that computes the propagated component of a child.
+/// @param[in] grain_size Minimum amount of entities propagated by a single task.
+///
+/// @return Task that completes when every hierarchy was propagated.
+///
+template<typename Local, typename World, typename Function>
+Task<> ParallelPropagateHierarchies(
+  Registry& registry, ThreadPool& pool, Function function, const size_t grain_size = cDefaultParallelGrainSize)
+{
+  ASSERT(grain_size > 0, "Grain size cannot be zero");
+
+  SortHierarchies(registry);
+
+  const auto worlds = registry.ViewFor<const World>();
+
+  auto propagate = [&worlds, &function](const Parent& parent, const Local& local, World& world)
+  { function(worlds.template Unpack<World>(parent.entity), local, world); };
+
+  auto view = registry.ViewFor<const Parent, const Local, World>();
+
+  using SubViewType = std::remove_cvref_t<decltype(*view.begin())>;
+
+  Vector<std::tuple<SubViewType, size_t, size_t>> ranges;
+  Vector<size_t> levels; // Index past the last range of every level
+
+  details::ForEachHierarchyLevel(view,
+    [&ranges, &levels](const auto& sub_views, const Vector<size_t>& firsts, const Vector<size_t>& ends)
+    {
+      for (size_t i = 0; i != sub_views.size(); ++i)
+      {
+        if (firsts[i] != ends[i]) ranges.emplace_back(sub_views[i], firsts[i], ends[i]);
+      }
+
+      levels.push_back(ranges.size());
+    });
+
+  size_t index = 0;
+
+  for (const size_t level_end : levels)
+  {
+    size_t size = 0;
+
+    for (size_t i = index; i != level_end; ++i)
+    {
+      size += std::get<2>(ranges[i]) - std::get<1>(ranges[i]);
+    }
+
+    const bool serial = size <= grain_size || pool.ThreadCount() == 1;
+
+    Vector<Task<>> tasks;
+
+    for (; index != level_end; ++index)
+    {
+      const auto& [sub_view, first, last] = ranges[index];
+
+      if (serial)
+      {
+        details::EntityForEachRange(sub_view, first, last, propagate);
+        continue;
+      }
+
+      const size_t capacity = sub_view.ChunkCapacity();
+      const size_t range = (grain_size + capacity - 1) & ~(capacity - 1);
+
+      // Ranges end on chunk boundaries, so that no two tasks mark the same chunk as changed
+      for (size_t piece = first; piece < last;)
+      {
+        const size_t next = std::min((piece + range) & ~(capacity - 1), last);
+
+        tasks.push_back(details::ParallelEntityForEachRange(pool, sub_view, piece, next, propagate));
+
+        piece = next;
+      }
+    }
+
+    if (!tasks.empty()) co_await WhenAll(std::move(tasks));
+  }
+}
+} // namespace plex
+
+#endif
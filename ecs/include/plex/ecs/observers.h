@@ -0,0 +1,334 @@
+#ifndef PLEX_ECS_OBSERVERS_H
+#define PLEX_ECS_OBSERVERS_H
+
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+#include "plex/containers/vector.h"
+#include "plex/ecs/archetype.h"
+#include "plex/utilities/delegate.h"
+
+namespace plex
+{
+///
+/// Observer identifier type.
+///
+using ObserverId = uint_fast32_t;
+
+///
+/// Lifecycle events that can be observed for a set of components.
+///
+enum class ObserverEvent : uint8_t
+{
+  Create, ///< Entity was created in a matching archetype.
+  Destroy, ///< Entity was destroyed from a matching archetype.
+  Add, ///< Entity started matching, either by creation or by adding components.
+  Remove ///< Entity stopped matching, either by destruction or by removing components.
+};
+
+///
+/// Keeps track of the observers of a registry and of the lifecycle events waiting to be dispatched to them.
+///
+/// Events are not dispatched when they happen. Every entity that changes archetype is recorded into a batch for its
+/// source and destination archetypes, the batches are dispatched together when flushed. Every observer is invoked once
+/// per matching batch with the span of the entities of the batch, creating many entities at once results in a single
+/// invocation.
+///
+/// The observers relevant to an archetype are found once by matching their views against the archetype, then cached.
+///
+/// @tparam Entity Entity of integral type.
+///
+template<std::unsigned_integral Entity>
+class Observers final
+{
+public:
+  using Handler = Delegate<void(std::span<const Entity>)>;
+
+  ///
+  /// Adds an observer.
+  ///
+  /// @param[in] event Event to observe.
+  /// @param[in] view Local view identifier of the observed components.
+  /// @param[in] handler Handler invoked with every batch of entities for the event.
+  ///
+  /// @return Identifier of the observer.
+  ///
+  ObserverId Add(const ObserverEvent event, const ViewId view, const Handler handler)
+  {
+    ASSERT(handler, "Handler not bound");
+
+    observers_.push_back({ handler, view, event });
+
+    return static_cast<ObserverId>(observers_.size() - 1);
+  }
+
+  ///
+  /// Removes an observer. Its identifier is never reused.
+  ///
+  /// @param[in] id Identifier of the observer to remove.
+  ///
+  void Remove(const ObserverId id)
+  {
+    ASSERT(id < observers_.size() && observers_[id].handler, "Observer does not exist");
+
+    observers_[id].handler = Handler {};
+  }
+
+  ///
+  /// Records that the entity moved from the source archetype to the destination archetype.
+  ///
+  /// @param[in] source Archetype the entity left, cInvalidArchetype if the entity was created.
+  /// @param[in] destination Archetype the entity entered, cInvalidArchetype if the entity was destroyed.
+  /// @param[in] entity Entity that moved.
+  ///
+  void Record(const ArchetypeId source, const ArchetypeId destination, const Entity entity)
+  {
+    AssureBatch(source, destination).push_back(entity);
+  }
+
+  ///
+  /// Records that the block of entities with contiguous identifiers moved from the source archetype to the destination
+  /// archetype.
+  ///
+  /// @param[in] source Archetype the entities left, cInvalidArchetype if the entities were created.
+  /// @param[in] destination Archetype the entities entered, cInvalidArchetype if the entities were destroyed.
+  /// @param[in] first First entity of the block.
+  /// @param[in] amount Amount of entities in the block.
+  ///
+  void RecordMany(const ArchetypeId source, const ArchetypeId destination, const Entity first, const size_t amount)
+  {
+    Vector<Entity>& entities = AssureBatch(source, destination);
+
+    const size_t offset = entities.size();
+
+    entities.resize(offset + amount);
+
+    for (size_t i = 0; i != amount; ++i)
+    {
+      entities[offset + i] = static_cast<Entity>(first + i);
+    }
+  }
+
+  ///
+  /// Records that the entities moved from the source archetype to the destination archetype.
+  ///
+  /// @param[in] source Archetype the entities left, cInvalidArchetype if the entities were created.
+  /// @param[in] destination Archetype the entities entered, cInvalidArchetype if the entities were destroyed.
+  /// @param[in] moved Entities that moved.
+  ///
+  void RecordMany(const ArchetypeId source, const ArchetypeId destination, const std::span<const Entity> moved)
+  {
+    if (moved.empty()) return;
+
+    Vector<Entity>& entities = AssureBatch(source, destination);
+
+    const size_t offset = entities.size();
+
+    entities.resize(offset + moved.size());
+
+    std::ranges::copy(moved, entities.begin() + offset);
+  }
+
+  ///
+  /// Dispatches every recorded batch to the observers that match it.
+  ///
+  /// Handlers may modify the registry, the events they cause are dispatched by the next flush.
+  ///
+  /// Batches are kept to reuse their memory, the ones that recorded nothing since the previous flush are dropped so
+  /// looking up a batch stays proportional to the archetype moves that are actually in use.
+  ///
+  /// @warning Handlers must not flush.
+  ///
+  /// @param[in] relations Relations used to match the views of the observers with the archetypes.
+  ///
+  void Flush(const ViewRelations& relations)
+  {
+    pending_.swap(dispatching_);
+
+    size_t kept = 0;
+
+    for (size_t i = 0; i != dispatching_.size(); ++i)
+    {
+      if (dispatching_[i].entities.empty()) continue;
+
+      Dispatch(relations, dispatching_[i]);
+
+      dispatching_[i].entities.clear();
+
+      if (kept != i) std::swap(dispatching_[kept], dispatching_[i]);
+
+      ++kept;
+    }
+
+    while (dispatching_.size() != kept)
+    {
+      dispatching_.pop_back();
+    }
+  }
+
+  ///
+  /// Returns whether or not there are observers. Nothing needs to be recorded when there are none.
+  ///
+  /// @return True if there are no observers, false otherwise.
+  ///
+  [[nodiscard]] bool Empty() const noexcept
+  {
+    return observers_.empty();
+  }
+
+private:
+  ///
+  /// Observer of an event for a view.
+  ///
+  struct Observer
+  {
+    Handler handler;
+    ViewId view;
+    ObserverEvent event;
+  };
+
+  ///
+  /// Entities that moved between the same source and destination archetypes.
+  ///
+  struct Batch
+  {
+    ArchetypeId source;
+    ArchetypeId destination;
+    Vector<Entity> entities;
+  };
+
+  ///
+  /// Observers relevant to an archetype, only the observers added before the cache was updated are tested.
+  ///
+  struct ArchetypeObservers
+  {
+    Vector<ObserverId> observers;
+    size_t tested = 0;
+  };
+
+  ///
+  /// Returns the entities of the batch for the source and destination archetypes, creating the batch if needed.
+  ///
+  /// @param[in] source Source archetype.
+  /// @param[in] destination Destination archetype.
+  ///
+  /// @return Entities of the batch.
+  ///
+  Vector<Entity>& AssureBatch(const ArchetypeId source, const ArchetypeId destination)
+  {
+    ASSERT(source != destination, "Entity did not move");
+
+    if (last_ < pending_.size() && pending_[last_].source == source && pending_[last_].destination == destination)
+    {
+      return pending_[last_].entities;
+    }
+
+    for (last_ = 0; last_ != pending_.size(); ++last_)
+    {
+      if (pending_[last_].source == source && pending_[last_].destination == destination)
+      {
+        return pending_[last_].entities;
+      }
+    }
+
+    pending_.push_back({ source, destination, {} });
+
+    return pending_.back().entities;
+  }
+
+  ///
+  /// Updates the cached observers relevant to the archetype with the observers added since the last update.
+  ///
+  /// @param[in] relations Relations used to match the views of the observers with the archetype.
+  /// @param[in] archetype Archetype to update.
+  ///
+  /// @return Amount of relevant observers.
+  ///
+  size_t UpdateArchetypeObservers(const ViewRelations& relations, const ArchetypeId archetype)
+  {
+    if (archetype >= archetype_observers_.size()) archetype_observers_.resize(archetype + 1);
+
+    ArchetypeObservers& cache = archetype_observers_[archetype];
+
+    for (; cache.tested != observers_.size(); ++cache.tested)
+    {
+      if (relations.ViewContains(observers_[cache.tested].view, archetype))
+      {
+        cache.observers.push_back(static_cast<ObserverId>(cache.tested));
+      }
+    }
+
+    return cache.observers.size();
+  }
+
+  ///
+  /// Invokes the observers that match the batch.
+  ///
+  /// Observers are copied out by index, handlers may add observers or archetypes while the batch is dispatched.
+  ///
+  /// @param[in] relations Relations used to match the views of the observers with the archetypes.
+  /// @param[in] batch Batch to dispatch.
+  ///
+  void Dispatch(const ViewRelations& relations, const Batch& batch)
+  {
+    const std::span<const Entity> entities(batch.entities.data(), batch.entities.size());
+
+    const bool created = batch.source == cInvalidArchetype;
+    const bool destroyed = batch.destination == cInvalidArchetype;
+
+    if (!destroyed)
+    {
+      const size_t count = UpdateArchetypeObservers(relations, batch.destination);
+
+      for (size_t i = 0; i != count; ++i)
+      {
+        const Observer observer = observers_[archetype_observers_[batch.destination].observers[i]];
+
+        if (!observer.handler) continue;
+
+        if ((observer.event == ObserverEvent::Create && created)
+            || (observer.event == ObserverEvent::Add
+                && (created || !relations.ViewContains(observer.view, batch.source))))
+        {
+          Handler handler = observer.handler;
+          handler(entities);
+        }
+      }
+    }
+
+    if (!created)
+    {
+      const size_t count = UpdateArchetypeObservers(relations, batch.source);
+
+      for (size_t i = 0; i != count; ++i)
+      {
+        const Observer observer = observers_[archetype_observers_[batch.source].observers[i]];
+
+        if (!observer.handler) continue;
+
+        if ((observer.event == ObserverEvent::Destroy && destroyed)
+            || (observer.event == ObserverEvent::Remove
+                && (destroyed || !relations.ViewContains(observer.view, batch.destination))))
+        {
+          Handler handler = observer.handler;
+          handler(entities);
+        }
+      }
+    }
+  }
+
+private:
+  Vector<Observer> observers_;
+  Vector<ArchetypeObservers> archetype_observers_;
+
+  Vector<Batch> pending_;
+  Vector<Batch> dispatching_;
+
+  size_t last_ = 0;
+};
+} // namespace plex
+
+#endif
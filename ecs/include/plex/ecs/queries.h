@@ -0,0 +1,306 @@
+#ifndef PLEX_ECS_QUERIES_H
+#define PLEX_ECS_QUERIES_H
+
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+#include "plex/ecs/command_buffer.h"
+#include "plex/ecs/registry.h"
+#include "plex/system/query.h"
+
+namespace plex
+{
+namespace details
+{
+  ///
+  /// Components accessed by a view parameter of an Entities query. Excluded components are not accessed, optional
+  /// components are accessed with the constness they are declared with, like required components.
+  ///
+  /// @tparam Parameter View parameter.
+  ///
+  template<typename Parameter>
+  struct EntitiesParameterAccess
+  {
+    using Types = std::tuple<Parameter>;
+  };
+
+  template<typename... Components>
+  struct EntitiesParameterAccess<Without<Components...>>
+  {
+    using Types = std::tuple<>;
+  };
+
+  template<typename... Components>
+  struct EntitiesParameterAccess<Optional<Components...>>
+  {
+    using Types = std::tuple<Components...>;
+  };
+
+  template<typename Query, typename Types>
+  struct EntitiesDataAccessFactory;
+
+  template<typename Query, typename... Types>
+  struct EntitiesDataAccessFactory<Query, std::tuple<Types...>>
+  {
+    using Type = QueryDataAccessFactory<Query, Types...>;
+  };
+} // namespace details
+
+template<typename... Components>
+class Entities;
+
+namespace details
+{
+  template<typename... Components>
+  struct IsInstanceOfView<Entities<Components...>> : std::true_type
+  {};
+} // namespace details
+
+///
+/// Query for a view of the entities of the registry in the global context.
+///
+/// The query is the view itself, it can be iterated directly with EntityForEach. The view is built once when the query
+/// is fetched.
+///
+/// There is one data access per component. Components only read must be const qualified, so that systems that only
+/// read the same components or access different components can run in parallel. Iterating the query with a function
+/// that modifies a component declared const does not compile.
+///
+/// @code
+/// void Move(Entities<const Velocity, Position> entities)
+/// {
+///   EntityForEach(entities, [](const Velocity& velocity, Position& position) { position += velocity; });
+/// }
+/// @endcode
+///
+/// @warning Entities are not created or destroyed through the query, structural changes are not declared as accesses.
+///
+/// @tparam Components View parameters, component types are const qualified if only read.
+///
+template<typename... Components>
+class Entities
+  : public View<Components...>,
+    public details::EntitiesDataAccessFactory<Entities<Components...>,
+      decltype(std::tuple_cat(std::declval<typename details::EntitiesParameterAccess<Components>::Types>()...))>::Type
+{
+public:
+  ///
+  /// Constructor.
+  ///
+  /// @param[in] registry Registry to view.
+  ///
+  explicit Entities(Registry& registry) : View<Components...>(registry) {}
+
+  ///
+  /// Returns the data category of the query.
+  ///
+  /// @return Category of the query.
+  ///
+  static constexpr std::string_view GetCategory() noexcept
+  {
+    return "Entities";
+  }
+
+  ///
+  /// Fetches a view of the registry of the global context.
+  ///
+  /// @param[in] global_context Global context that contains the registry.
+  ///
+  /// @return The query.
+  ///
+  static Entities FetchData(void*, Context& global_context, Context&)
+  {
+    return Entities(global_context.Get<Registry>());
+  }
+};
+
+///
+/// Query for singletons of the registry in the global context.
+///
+/// Singletons are resolved once when the query is fetched, every access is then a single load. Singletons only read
+/// must be const qualified, so that systems that only read the same singletons can run in parallel.
+///
+/// @tparam Types Singleton types, const qualified if only read.
+///
+template<typename... Types>
+class Singletons : public QueryDataAccessFactory<Singletons<Types...>, Types...>
+{
+public:
+  ///
+  /// Constructor.
+  ///
+  /// @warning Every singleton must exist in the registry, otherwise the behaviour is undefined.
+  ///
+  /// @param[in] registry Registry that holds the singletons.
+  ///
+  explicit Singletons(Registry& registry) noexcept : singletons_(&registry.Get<std::remove_const_t<Types>>()...) {}
+
+  ///
+  /// Returns the data category of the query.
+  ///
+  /// @return Category of the query.
+  ///
+  static constexpr std::string_view GetCategory() noexcept
+  {
+    return "Singletons";
+  }
+
+  ///
+  /// Fetches the singletons from the registry of the global context.
+  ///
+  /// @param[in] global_context Global context that contains the registry.
+  ///
+  /// @return The query.
+  ///
+  static Singletons FetchData(void*, Context& global_context, Context&)
+  {
+    return Singletons(global_context.Get<Registry>());
+  }
+
+  ///
+  /// Returns a reference to the singleton of the type.
+  ///
+  /// Singletons accessed mutably by the query can also be accessed as const.
+  ///
+  /// @tparam Type The singleton type.
+  ///
+  /// @return Reference to the singleton.
+  ///
+  template<typename Type>
+  [[nodiscard]] Type& Get() const noexcept
+  {
+    using Singleton = std::remove_const_t<Type>;
+
+    if constexpr ((std::same_as<Singleton, Types> || ...))
+    {
+      return *std::get<Singleton*>(singletons_);
+    }
+    else
+    {
+      static_assert((std::same_as<const Singleton, Types> || ...), "Singleton type not in the query");
+      static_assert(std::is_const_v<Type>, "Singleton is read only in the query");
+
+      return *std::get<Type*>(singletons_);
+    }
+  }
+
+private:
+  std::tuple<Types*...> singletons_;
+};
+
+///
+/// Query for the command buffer of the system, to record structural changes while systems run in parallel.
+///
+/// Every system gets its own command buffer from the CommandBuffers pool of the global context the first time the query
+/// is fetched. Commands are applied when the pool is played back, usually at the end of a stage.
+///
+/// @code
+/// void Spawn(Commands commands)
+/// {
+///   commands.Create(Position {}, Velocity {});
+/// }
+/// @endcode
+///
+class Commands : public QueryDataAccessFactory<Commands>
+{
+public:
+  ///
+  /// Constructor.
+  ///
+  /// @param[in] buffer Command buffer to record commands in.
+  ///
+  explicit Commands(CommandBuffer& buffer) noexcept : buffer_(&buffer) {}
+
+  ///
+  /// Returns the data category of the query.
+  ///
+  /// @return Category of the query.
+  ///
+  static constexpr std::string_view GetCategory() noexcept
+  {
+    return "Commands";
+  }
+
+  ///
+  /// Fetches the command buffer of the system.
+  ///
+  /// @param[in] global_context Global context that contains the command buffer pool.
+  /// @param[in] local_context Local context of the system.
+  ///
+  /// @return The query.
+  ///
+  static Commands FetchData(void*, Context& global_context, Context& local_context)
+  {
+    if (!local_context.Contains<CommandBuffer>()) [[unlikely]]
+    {
+      local_context.Insert(&global_context.Get<CommandBuffers>().Obtain(), [](void*) {});
+    }
+
+    return Commands(local_context.Get<CommandBuffer>());
+  }
+
+  ///
+  /// Records the creation of an entity with the given components.
+  ///
+  /// @see CommandBuffer::Create
+  ///
+  /// @tparam Components List of component types of the entity.
+  ///
+  /// @param[in] components Component data to create entity with.
+  ///
+  template<typename... Components>
+  void Create(Components&&... components) const
+  {
+    buffer_->Create(std::forward<Components>(components)...);
+  }
+
+  ///
+  /// Records the destruction of the entity.
+  ///
+  /// @see CommandBuffer::Destroy
+  ///
+  /// @param[in] entity Entity to destroy.
+  ///
+  void Destroy(const Entity entity) const
+  {
+    buffer_->Destroy(entity);
+  }
+
+  ///
+  /// Records adding the component to the entity.
+  ///
+  /// @see CommandBuffer::Add
+  ///
+  /// @tparam Component Type of component to add.
+  ///
+  /// @param[in] entity Entity to add component to.
+  /// @param[in] component Component data to add.
+  ///
+  template<typename Component>
+  void Add(const Entity entity, Component&& component) const
+  {
+    buffer_->Add(entity, std::forward<Component>(component));
+  }
+
+  ///
+  /// Records removing the component from the entity.
+  ///
+  /// @see CommandBuffer::Remove
+  ///
+  /// @tparam Component Type of component to remove.
+  ///
+  /// @param[in] entity Entity to remove component from.
+  ///
+  template<typename Component>
+  void Remove(const Entity entity) const
+  {
+    buffer_->Remove<Component>(entity);
+  }
+
+private:
+  CommandBuffer* buffer_;
+};
+} // namespace plex
+
+#endif
@@ -2,13 +2,25 @@
 #define PLEX_ECS_REGISTRY_H
 
 #include <algorithm>
+#include <atomic>
 #include <concepts>
+#include <cstring>
+#include <memory>
+#include <ranges>
+#include <span>
 #include <tuple>
 #include <type_traits>
 
+#include "plex/async/task.h"
+#include "plex/async/thread_pool.h"
+#include "plex/async/when_all.h"
 #include "plex/ecs/archetype.h"
 #include "plex/ecs/entity_manager.h"
+#include "plex/ecs/observers.h"
 #include "plex/ecs/storage.h"
+#include "plex/os/mapped_file.h"
+#include "plex/system/context.h"
+#include "plex/utilities/ref.h"
 
 namespace plex
 {
@@ -22,6 +34,27 @@ using Entity = uint_fast32_t;
 template<typename...>
 class View;
 
+template<typename...>
+class SubView;
+
+class Registry;
+class RegistrySnapshot;
+
+namespace details
+{
+  ///
+  /// State of a registry snapshot. The registry keeps the states of its latest snapshots to update them in place once
+  /// they are released.
+  ///
+  struct SnapshotState final : public AtomicRefCounted
+  {
+    Vector<Vector<Ref<SharedChunk<Entity>>>> chunks; // Keeps the copies alive, indexed by archetype of the source
+    std::unique_ptr<Registry> registry; // Adopts the copies of the chunks, destroyed before them
+    Vector<ArchetypeId> archetypes; // Archetype of the snapshot registry indexed by archetype of the source
+    size_t entity_count = 0;
+  };
+} // namespace details
+
 ///
 /// Registry is where all entities and their components are stored and managed.
 ///
@@ -42,10 +75,7 @@ public:
   ///
   /// Constructor.
   ///
-  Registry()
-  {
-    storages_.resize(MaxArchetypes);
-  }
+  Registry() : tick_(1) {}
 
   ///
   /// Destructor.
@@ -83,9 +113,91 @@ public:
 
     AssureStorage<Components...>().Insert(entity, std::forward<Components>(components)...);
 
+    if (!observers_.Empty()) [[unlikely]] observers_.Record(cInvalidArchetype, FindArchetype(entity), entity);
+
     return entity;
   }
 
+  ///
+  /// Creates a block of new entities with contiguous identifiers, the components of every entity are obtained from the
+  /// generator.
+  ///
+  /// The storage and the entity lookup are grown once for the whole block and the components are constructed in place,
+  /// this is much faster than calling Create for every entity.
+  ///
+  /// @tparam Components List of component types used as initial archetype.
+  /// @tparam Generator Invocable with the entity that returns a tuple of the components of the entity.
+  ///
+  /// @param[in] amount Amount of entities to create.
+  /// @param[in] generator Generator of the component data.
+  ///
+  /// @return Range of the identifiers of the created entities.
+  ///
+  template<typename... Components, typename Generator>
+  requires std::invocable<Generator&, Entity>
+  std::ranges::iota_view<Entity, Entity> CreateMany(const size_t amount, Generator&& generator)
+  {
+    const Entity first = entity_manager_.GenerateMany(amount);
+
+    AssureStorage<Components...>().template InsertMany<std::remove_cvref_t<Components>...>(first, amount, generator);
+
+    if (!observers_.Empty() && amount != 0) [[unlikely]]
+    {
+      observers_.RecordMany(cInvalidArchetype, FindArchetype(first), first, amount);
+    }
+
+    const Entity last = first + amount;
+
+    return { first, last };
+  }
+
+  ///
+  /// Creates a block of new entities with contiguous identifiers, every entity is created with a copy of the
+  /// components.
+  ///
+  /// @tparam Components List of component types used as initial archetype.
+  ///
+  /// @param[in] amount Amount of entities to create.
+  /// @param[in] components Component data to copy into every entity.
+  ///
+  /// @return Range of the identifiers of the created entities.
+  ///
+  template<typename... Components>
+  std::ranges::iota_view<Entity, Entity> CreateMany(const size_t amount, const Components&... components)
+  {
+    return CreateMany<Components...>(amount, [&](Entity) { return std::tuple<Components...>(components...); });
+  }
+
+  ///
+  /// Creates a block of new entities with contiguous identifiers, every entity is a copy of the prefab entity.
+  ///
+  /// The entities are created in the archetype of the prefab and the storage is grown once for the whole block.
+  /// Trivially copyable components are broadcast with memory copies instead of being constructed one by one.
+  ///
+  /// @warning Every component of the prefab must be copy constructible.
+  ///
+  /// @param[in] prefab Entity to copy.
+  /// @param[in] amount Amount of entities to create.
+  ///
+  /// @return Range of the identifiers of the created entities.
+  ///
+  std::ranges::iota_view<Entity, Entity> Instantiate(const Entity prefab, const size_t amount)
+  {
+    ASSERT(Valid(prefab), "Prefab entity does not exist");
+
+    const Entity first = entity_manager_.GenerateMany(amount);
+
+    const ArchetypeId archetype = FindArchetype(prefab);
+
+    storages_[archetype]->InsertCopies(first, amount, prefab);
+
+    if (!observers_.Empty()) [[unlikely]] observers_.RecordMany(cInvalidArchetype, archetype, first, amount);
+
+    const Entity last = first + amount;
+
+    return { first, last };
+  }
+
   ///
   /// Destroys the entity and all its attached components.
   ///
@@ -108,6 +220,95 @@ public:
     ViewFor<Components...>().Destroy(entity);
   }
 
+  ///
+  /// Adds the component to the entity.
+  ///
+  /// The entity is moved directly to the storage of its new archetype, its identifier does not change. Transitions
+  /// between archetypes are cached, after the first transition, moving an entity only costs relocating its components.
+  ///
+  /// @warning
+  ///    If the entity already has the component, the behaviour of this method is undefined.
+  ///
+  /// @tparam Component Type of component to add.
+  ///
+  /// @param[in] entity Entity to add component to.
+  /// @param[in] component Component data to add.
+  ///
+  template<typename Component>
+  void Add(const Entity entity, Component&& component)
+  {
+    using Type = std::remove_cvref_t<Component>;
+
+    ASSERT(!HasComponents<Type>(entity), "Entity already has the component");
+
+    const ArchetypeId source = FindArchetype(entity);
+
+    ArchetypeId destination = relations_.FindAddTransition(source, GetComponentId<Type>());
+
+    if (destination == cInvalidArchetype) [[unlikely]]
+    {
+      destination = InitializeAddTransition<Type>(source);
+    }
+
+    storages_[source]->Relocate(entity, *storages_[destination], std::forward<Component>(component));
+
+    if (!observers_.Empty()) [[unlikely]] observers_.Record(source, destination, entity);
+  }
+
+  ///
+  /// Removes the component from the entity.
+  ///
+  /// The entity is moved directly to the storage of its new archetype, its identifier does not change. Transitions
+  /// between archetypes are cached, after the first transition, moving an entity only costs relocating its components.
+  ///
+  /// @warning
+  ///    If the entity does not have the component, the behaviour of this method is undefined.
+  ///
+  /// @tparam Component Type of component to remove.
+  ///
+  /// @param[in] entity Entity to remove component from.
+  ///
+  template<typename Component>
+  void Remove(const Entity entity)
+  {
+    using Type = std::remove_cvref_t<Component>;
+
+    ASSERT(HasComponents<Type>(entity), "Entity does not have the component");
+
+    const ArchetypeId source = FindArchetype(entity);
+
+    ArchetypeId destination = relations_.FindRemoveTransition(source, GetComponentId<Type>());
+
+    if (destination == cInvalidArchetype) [[unlikely]]
+    {
+      destination = InitializeRemoveTransition<Type>(source);
+    }
+
+    storages_[source]->Relocate(entity, *storages_[destination]);
+
+    if (!observers_.Empty()) [[unlikely]] observers_.Record(source, destination, entity);
+  }
+
+  ///
+  /// Destroys every entity who's archetype contains all of the provided component types and for which the predicate
+  /// returns true.
+  ///
+  /// Matching archetypes are scanned once and compacted in a single pass per array, the destroyed identifiers are
+  /// released in one batch.
+  ///
+  /// @tparam Components List of component types of entities to test.
+  /// @tparam Predicate Invocable with the entity and/or components that returns whether or not to destroy the entity.
+  ///
+  /// @param[in] predicate Predicate to test every entity with.
+  ///
+  /// @return Amount of entities destroyed.
+  ///
+  template<typename... Components, typename Predicate>
+  size_t DestroyIf(Predicate&& predicate)
+  {
+    return ViewFor<Components...>().DestroyIf(std::forward<Predicate>(predicate));
+  }
+
   ///
   /// Destroys all the entities who's archetype contains all of the provided component types.
   ///
@@ -119,6 +320,26 @@ public:
     ViewFor<Components...>().DestroyAll();
   }
 
+  ///
+  /// Sorts the entities that have the component by that component, so that iterating them visits the components in
+  /// order.
+  ///
+  /// The order is either given by a comparison of two components or by an integral key of every component, keys are
+  /// radix sorted in linear time. The entities of every archetype with the component are sorted on their own, with
+  /// their other components, and their identifiers do not change.
+  ///
+  /// @tparam Component Component type to sort by.
+  /// @tparam Compare Invocable with two components that returns whether or not the first goes before the second, or
+  /// invocable with one component that returns its integral key.
+  ///
+  /// @param[in] compare Comparison or key of the components.
+  ///
+  template<typename Component, typename Compare>
+  void Sort(Compare compare)
+  {
+    ViewFor<Component>().template Sort<Component>(std::move(compare));
+  }
+
   ///
   /// Returns a reference to the component data of the given component type for given entity.
   ///
@@ -137,6 +358,22 @@ public:
     return ViewFor<Component>().template Unpack<Component>(entity);
   }
 
+  ///
+  /// Returns whether or not the entity identifier refers to an entity that is alive.
+  ///
+  /// An identifier kept after its entity was destroyed is not valid. Once its index is reused by a new entity, the stale
+  /// identifier is only detected when generations are enabled, see PLEX_ECS_ENTITY_GENERATION_BITS. Without them, the
+  /// stale identifier refers to the new entity. This only costs a single lookup in the sparse array.
+  ///
+  /// @param[in] entity Entity to check.
+  ///
+  /// @return True if the entity is alive, false otherwise.
+  ///
+  [[nodiscard]] bool Valid(const Entity entity) const noexcept
+  {
+    return mappings_.Valid(entity);
+  }
+
   ///
   /// Returns whether or not the entity has all of the specified components.
   ///
@@ -181,7 +418,7 @@ public:
   ///
   /// Obtains a view of the registry for the provided component types.
   ///
-  /// @tparam Components Component types to include in the view.
+  /// @tparam Components View parameters: required component types, Without<...> and Optional<...> components.
   ///
   /// @return Basic view of the registry for the component types.
   ///
@@ -191,106 +428,1081 @@ public:
     return View<Components...>(*this);
   }
 
-private:
   ///
-  /// Returns the storage for the archetype.
+  /// Returns the current tick. Components added or mutably accessed are stamped with the current tick.
   ///
-  /// Will properly initialize the storage if it does not exist.
+  /// @return Current tick.
   ///
-  /// @tparam Components Component types that compose the archetype.
+  [[nodiscard]] Tick CurrentTick() const noexcept
+  {
+    return tick_;
+  }
+
   ///
-  /// @return Reference to assured storage.
+  /// Advances the current tick.
   ///
-  template<typename... Components>
-  Storage<Entity>& AssureStorage()
+  /// Typically called once at the start of every run of a system. The tick returned by the previous run is used as the
+  /// since tick of the Changed and Added filters, to only visit the components that were changed or added after it:
+  ///
+  /// @code
+  /// const Tick this_run = registry.AdvanceTick();
+  /// EntityForEach(registry.ViewFor<Position>(), Changed<Position> { last_run }, function);
+  /// last_run = this_run;
+  /// @endcode
+  ///
+  /// @return The new current tick.
+  ///
+  Tick AdvanceTick() noexcept
   {
-    const ArchetypeId id = relations_.template AssureArchetype<std::remove_cvref_t<Components>...>();
-
-    auto storage = storages_[id];
+    return ++tick_;
+  }
 
-    if (storage) [[likely]]
-    {
-      return *storage;
-    }
-    else
+  ///
+  /// Sets the singleton of the type, replacing the current one if there is one.
+  ///
+  /// Singletons hold global state (time, input...) that is not attached to any entity. Accessing a singleton is a
+  /// direct lookup, no archetype is involved.
+  ///
+  /// The current singleton is replaced in place, references to it stay valid. It is move assigned, or destroyed and
+  /// constructed again when the type is not move assignable.
+  ///
+  /// @warning When the type is not move assignable, the arguments must not refer to the current singleton.
+  ///
+  /// @tparam Type The singleton type.
+  /// @tparam Args Argument types to pass to the constructor.
+  ///
+  /// @param[in] args Arguments to pass to the constructor.
+  ///
+  /// @return Reference to the singleton.
+  ///
+  template<typename Type, typename... Args>
+  requires std::constructible_from<Type, Args...>
+  Type& Set(Args&&... args)
+  {
+    if (singletons_.Contains<Type>())
     {
-      return InitializeStorage<std::remove_cvref_t<Components>...>();
+      Type& singleton = singletons_.Get<Type>();
+
+      if constexpr (std::is_move_assignable_v<Type>) return singleton = Type(std::forward<Args>(args)...);
+      else
+      {
+        std::destroy_at(&singleton);
+        return *std::construct_at(&singleton, std::forward<Args>(args)...);
+      }
     }
+
+    singletons_.Emplace<Type>(std::forward<Args>(args)...);
+
+    return singletons_.Get<Type>();
   }
 
   ///
-  /// Initializes the storage for the archetype.
+  /// Removes the singleton of the type.
   ///
-  /// @tparam Components Components that make up the archetype.
+  /// @warning The singleton must exist, otherwise the behaviour is undefined.
   ///
-  template<typename... Components>
-  COLD_SECTION NO_INLINE Storage<Entity>& InitializeStorage()
+  /// @tparam Type The singleton type.
+  ///
+  template<typename Type>
+  void Unset()
   {
-    const ArchetypeId archetype = relations_.template AssureArchetype<Components...>();
+    singletons_.Remove<Type>();
+  }
 
-    storages_[archetype] = new Storage<Entity>(&mappings_);
-    storages_[archetype]->template Initialize<Components...>();
+  ///
+  /// Returns a reference to the singleton of the type.
+  ///
+  /// @warning The singleton must exist, otherwise the behaviour is undefined.
+  ///
+  /// @tparam Type The singleton type.
+  ///
+  /// @return Reference to the singleton.
+  ///
+  template<typename Type>
+  [[nodiscard]] const Type& Get() const noexcept
+  {
+    return singletons_.Get<Type>();
+  }
 
-    return *storages_[archetype];
+  ///
+  /// Returns a reference to the singleton of the type.
+  ///
+  /// @warning The singleton must exist, otherwise the behaviour is undefined.
+  ///
+  /// @tparam Type The singleton type.
+  ///
+  /// @return Reference to the singleton.
+  ///
+  template<typename Type>
+  [[nodiscard]] Type& Get() noexcept
+  {
+    return singletons_.Get<Type>();
   }
 
-private:
-  SharedSparseArray<Entity> mappings_;
-  EntityManager<Entity> entity_manager_;
-  ViewRelations relations_;
+  ///
+  /// Returns whether or not the registry has a singleton of the type.
+  ///
+  /// @tparam Type The singleton type.
+  ///
+  /// @return True if the singleton exists, false otherwise.
+  ///
+  template<typename Type>
+  [[nodiscard]] bool HasSingleton() const noexcept
+  {
+    return singletons_.Contains<Type>();
+  }
 
-  Vector<Storage<Entity>*> storages_;
-};
+  ///
+  /// Adds an observer of the event for the view parameters.
+  ///
+  /// Events are recorded as entities change archetype and are dispatched in batches by FlushObservers. The handler is
+  /// invoked once per batch with the span of the entities of the batch, all the entities of a batch moved between the
+  /// same two archetypes.
+  ///
+  /// @note The handler sees the entities as they are when flushed. The components of entities that were destroyed or
+  /// that left the view can no longer be accessed, entities may also have been destroyed after being created.
+  ///
+  /// @tparam Components View parameters of the observed entities: required component types and Without<...> components.
+  ///
+  /// @param[in] event Event to observe.
+  /// @param[in] handler Handler to invoke with every batch of entities for the event.
+  ///
+  /// @return Identifier of the observer.
+  ///
+  template<typename... Components>
+  ObserverId Observe(const ObserverEvent event, const Observers<Entity>::Handler handler)
+  {
+    return observers_.Add(event, relations_.template AssureView<Components...>(), handler);
+  }
 
-namespace details
-{
-  template<typename... DataTypes>
-  class SubViewIterator
+  ///
+  /// Adds an observer of the entities created with the components.
+  ///
+  /// @see Observe
+  ///
+  /// @tparam Components View parameters of the observed entities.
+  ///
+  /// @param[in] handler Handler to invoke with every batch of created entities.
+  ///
+  /// @return Identifier of the observer.
+  ///
+  template<typename... Components>
+  ObserverId OnCreate(const Observers<Entity>::Handler handler)
   {
-  private:
-    using Self = SubViewIterator;
+    return Observe<Components...>(ObserverEvent::Create, handler);
+  }
 
-  public:
-    using size_type = size_t;
-    using difference_type = ptrdiff_t;
-    using pointers = std::tuple<std::remove_cvref_t<DataTypes>*...>;
+  ///
+  /// Adds an observer of the entities destroyed with the components.
+  ///
+  /// @see Observe
+  ///
+  /// @tparam Components View parameters of the observed entities.
+  ///
+  /// @param[in] handler Handler to invoke with every batch of destroyed entities.
+  ///
+  /// @return Identifier of the observer.
+  ///
+  template<typename... Components>
+  ObserverId OnDestroy(const Observers<Entity>::Handler handler)
+  {
+    return Observe<Components...>(ObserverEvent::Destroy, handler);
+  }
 
-    constexpr SubViewIterator() noexcept = default;
+  ///
+  /// Adds an observer of the entities that start having the components, either by creation or by adding components.
+  ///
+  /// @see Observe
+  ///
+  /// @tparam Components View parameters of the observed entities.
+  ///
+  /// @param[in] handler Handler to invoke with every batch of entities that started matching.
+  ///
+  /// @return Identifier of the observer.
+  ///
+  template<typename... Components>
+  ObserverId OnAdd(const Observers<Entity>::Handler handler)
+  {
+    return Observe<Components...>(ObserverEvent::Add, handler);
+  }
 
-    SubViewIterator(Storage<Entity>* storage, size_t offset) noexcept
-      : data_(AccessFromStorage<std::remove_cvref_t<DataTypes>>(storage, offset)...)
-    {}
+  ///
+  /// Adds an observer of the entities that stop having the components, either by destruction or by removing
+  /// components.
+  ///
+  /// @see Observe
+  ///
+  /// @tparam Components View parameters of the observed entities.
+  ///
+  /// @param[in] handler Handler to invoke with every batch of entities that stopped matching.
+  ///
+  /// @return Identifier of the observer.
+  ///
+  template<typename... Components>
+  ObserverId OnRemove(const Observers<Entity>::Handler handler)
+  {
+    return Observe<Components...>(ObserverEvent::Remove, handler);
+  }
 
-    SubViewIterator(const SubViewIterator& other) noexcept = default;
-    SubViewIterator& operator=(const SubViewIterator&) noexcept = default;
+  ///
+  /// Removes the observer, events that are not flushed yet are not dispatched to it.
+  ///
+  /// @param[in] id Identifier of the observer to remove.
+  ///
+  void Unobserve(const ObserverId id)
+  {
+    observers_.Remove(id);
+  }
 
-    template<typename... OtherDataTypes>
-    SubViewIterator(const SubViewIterator<OtherDataTypes...>& other) : data_(std::get<DataTypes*>(other.data_)...)
+  ///
+  /// Dispatches the events recorded since the last flush to the observers.
+  ///
+  /// Typically called once per frame, after the systems that create and destroy entities.
+  ///
+  void FlushObservers()
+  {
+    observers_.Flush(relations_);
+  }
+
+  ///
+  /// Takes a read-only snapshot of every entity and component of the registry.
+  ///
+  /// Chunks are copied when taking the snapshot, unless they were not modified since the previous snapshot, in which
+  /// case the previous copy is shared. A chunk is modified when its entities move or when one of its components is
+  /// changed or added, as recorded by the ticks, see AdvanceTick. Advance the tick between snapshots, chunks modified
+  /// at the current tick are always copied.
+  ///
+  /// The latest copy of every chunk is kept by the registry to be shared with the next snapshot.
+  ///
+  /// The registry also keeps the lookup of its two latest snapshots. Once one of them is released, the next snapshot
+  /// reuses it and only maps the entities of the chunks that were copied again. Otherwise, the lookup is built for every
+  /// entity. The entities of every chunk are still compared with the copy to detect rows that moved, which is a memory
+  /// comparison per chunk.
+  ///
+  /// @warning Components written to without marking them changed are not detected. Unpack, EntityForEach,
+  ///     EntityForEachSpan and ParallelEntityForEach mark the components they give mutable access to, writes through
+  ///     dereferenced sub view iterators do not.
+  ///
+  /// @return Snapshot of the registry.
+  ///
+  [[nodiscard]] RegistrySnapshot Snapshot();
+
+  ///
+  /// Saves a snapshot of every entity and component of the registry to the file.
+  ///
+  /// The chunks of every archetype are written with the layout of the storage, the snapshot can be loaded without going
+  /// through the entities one by one. Only the rows in use are written, the rest of the chunks is zeroed so that the
+  /// same registry always gives the same file. Along with the components, the state of the entity identifiers and the
+  /// current tick are saved, so entities keep their identifiers and change detection keeps working after loading.
+  ///
+  /// The snapshot is written to a temporary file next to the path, which replaces the file once complete. The registry
+  /// can be saved to the snapshot it was loaded from.
+  ///
+  /// @note Singletons and observers are not saved.
+  ///
+  /// @param[in] path Path of the file to write.
+  ///
+  /// @return True if the snapshot was saved, false if the file could not be written or a component is not trivially
+  ///     copyable. Nothing is written when a component is not trivially copyable.
+  ///
+  COLD_SECTION NO_INLINE bool Save(const char* path) const;
+
+  ///
+  /// Loads a snapshot saved with Save into the registry. The registry must not have created any entity.
+  ///
+  /// The whole file is validated before anything is loaded, including the entity identifiers: a corrupted snapshot is
+  /// rejected instead of corrupting the registry.
+  ///
+  /// The snapshot is mapped into memory. When the chunks of an archetype in the snapshot are laid out exactly like the
+  /// chunks of its storage, which is the case when the component types are registered in the same order as when the
+  /// snapshot was saved, the storage adopts the mapped chunks in place without copying them. Otherwise the component
+  /// arrays are bulk copied into the storage.
+  ///
+  /// Component types are matched by name with the components of the snapshot.
+  ///
+  /// @tparam Components Every component type that may be in the snapshot.
+  ///
+  /// @param[in] path Path of the file to read.
+  ///
+  /// @return True if the snapshot was loaded, false if the registry already created entities, the file could not be
+  ///     read, is not a valid snapshot or contains components that are not in the list. Nothing is loaded when false is
+  ///     returned.
+  ///
+  template<typename... Components>
+  bool Load(const char* path)
+  {
+    Vector<const ComponentInfo*> components;
+    components.reserve(sizeof...(Components));
+
+    (components.push_back(GetComponentInfo<std::remove_cvref_t<Components>>()), ...);
+
+    return Load(path, components);
+  }
+
+  ///
+  /// Loads a snapshot saved with Save into the registry. The registry must not have created any entity.
+  ///
+  /// @see Load
+  ///
+  /// @param[in] path Path of the file to read.
+  /// @param[in] components Information about every component type that may be in the snapshot.
+  ///
+  /// @return True if the snapshot was loaded, false if the registry already created entities, the file could not be
+  ///     read, is not a valid snapshot or contains components that are not in the list. Nothing is loaded when false is
+  ///     returned.
+  ///
+  COLD_SECTION NO_INLINE bool Load(const char* path, const Vector<const ComponentInfo*>& components);
+
+private:
+  ///
+  /// Returns the storage for the archetype.
+  ///
+  /// Will properly initialize the storage if it does not exist.
+  ///
+  /// @tparam Components Component types that compose the archetype.
+  ///
+  /// @return Reference to assured storage.
+  ///
+  template<typename... Components>
+  Storage<Entity>& AssureStorage()
+  {
+    const ArchetypeId id = relations_.template AssureArchetype<std::remove_cvref_t<Components>...>();
+
+    // Every archetype of the relations gets its storage as soon as it is assured, ids past the end are new
+    if (id < storages_.size()) [[likely]]
+    {
+      return *storages_[id];
+    }
+    else
+    {
+      return InitializeStorage<std::remove_cvref_t<Components>...>();
+    }
+  }
+
+  ///
+  /// Initializes the storage for the archetype.
+  ///
+  /// @tparam Components Components that make up the archetype.
+  ///
+  template<typename... Components>
+  COLD_SECTION NO_INLINE Storage<Entity>& InitializeStorage()
+  {
+    const ArchetypeId archetype = relations_.template AssureArchetype<Components...>();
+
+    if (archetype >= storages_.size()) storages_.resize(archetype + 1, nullptr);
+
+    if (!storages_[archetype])
+    {
+      storages_[archetype] = new Storage<Entity>(&mappings_, &tick_, archetype);
+      storages_[archetype]->template Initialize<Components...>();
+    }
+
+    return *storages_[archetype];
+  }
+
+  ///
+  /// Returns the storage for the archetype described at runtime by its component information.
+  ///
+  /// Will properly initialize the storage if it does not exist.
+  ///
+  /// A new storage lays out its component arrays in the order of the components, so a storage initialized with the
+  /// components of another storage has the same chunk layout.
+  ///
+  /// @param[in] components Information about the components that compose the archetype.
+  ///
+  /// @return Archetype identifier of the assured storage.
+  ///
+  COLD_SECTION NO_INLINE ArchetypeId AssureStorage(const Vector<const ComponentInfo*>& components)
+  {
+    Vector<ComponentId> component_ids;
+    component_ids.reserve(components.size());
+
+    for (const auto info : components)
+    {
+      component_ids.push_back(info->id);
+    }
+
+    std::ranges::sort(component_ids);
+
+    const ArchetypeId archetype = relations_.AssureArchetype(component_ids);
+
+    if (archetype >= storages_.size()) storages_.resize(archetype + 1, nullptr);
+
+    if (!storages_[archetype])
+    {
+      storages_[archetype] = new Storage<Entity>(&mappings_, &tick_, archetype);
+      storages_[archetype]->Initialize(components);
+    }
+
+    return archetype;
+  }
+
+  ///
+  /// Finds the archetype of the entity.
+  ///
+  /// The archetype is recorded next to the index of the entity in the sparse array, this is a single lookup.
+  ///
+  /// @param[in] entity Entity to find archetype for.
+  ///
+  /// @return Archetype of the entity.
+  ///
+  [[nodiscard]] ArchetypeId FindArchetype(const Entity entity) const noexcept
+  {
+    ASSERT(mappings_.Valid(entity), "Entity does not exist");
+
+    return mappings_.Archetype(entity);
+  }
+
+  ///
+  /// Initializes and caches the transition obtained by adding the component to the archetype.
+  ///
+  /// @tparam Component Component added by the transition.
+  ///
+  /// @param[in] source Archetype to add component to.
+  ///
+  /// @return Archetype with the component added.
+  ///
+  template<typename Component>
+  COLD_SECTION NO_INLINE ArchetypeId InitializeAddTransition(const ArchetypeId source)
+  {
+    auto components = storages_[source]->ComponentInfos();
+    components.push_back(GetComponentInfo<Component>());
+
+    const ArchetypeId destination = AssureStorage(components);
+
+    relations_.AddTransition(source, GetComponentId<Component>(), destination);
+
+    return destination;
+  }
+
+  ///
+  /// Initializes and caches the transition obtained by removing the component from the archetype.
+  ///
+  /// @tparam Component Component removed by the transition.
+  ///
+  /// @param[in] source Archetype to remove component from.
+  ///
+  /// @return Archetype with the component removed.
+  ///
+  template<typename Component>
+  COLD_SECTION NO_INLINE ArchetypeId InitializeRemoveTransition(const ArchetypeId source)
+  {
+    auto components = storages_[source]->ComponentInfos();
+    components.SwapAndPop(std::ranges::find(components, GetComponentInfo<Component>()));
+
+    const ArchetypeId destination = AssureStorage(components);
+
+    relations_.AddTransition(destination, GetComponentId<Component>(), source);
+
+    return destination;
+  }
+
+private:
+  SharedSparseArray<Entity> mappings_;
+  EntityManager<Entity> entity_manager_;
+  ViewRelations relations_;
+
+  Vector<Storage<Entity>*> storages_;
+
+  Tick tick_;
+
+  Context singletons_;
+
+  Observers<Entity> observers_;
+
+  Vector<size_t> destroy_rows_; // Scratch buffers reused by DestroyIf
+  Vector<Entity> destroyed_;
+
+  Vector<MappedFile> mapped_files_; // Files of the loaded snapshots whose chunks were adopted
+
+  Vector<Vector<Ref<SharedChunk<Entity>>>> shared_chunks_; // Latest copy of every chunk indexed by archetype
+
+  static constexpr size_t cSnapshotStates = 2; // Enough for a snapshot to be taken while the previous one is used
+
+  Vector<Ref<details::SnapshotState>> snapshot_states_; // States of the latest snapshots, oldest first
+};
+
+///
+/// Read-only view of a registry snapshot, obtained with RegistrySnapshot::ViewFor.
+///
+/// The chunks of a snapshot are shared with the registry and with the other snapshots, so the view only gives constant
+/// access to the components and cannot destroy, sort or change the entities. Iterate it with EntityForEach, the
+/// function must take the components by value or by constant reference.
+///
+/// @tparam Components Constant component types of the view.
+///
+template<typename... Components>
+class SnapshotView
+{
+public:
+  static_assert((std::is_const_v<Components> && ...), "Snapshot views only have constant components");
+
+  ///
+  /// Checks if the entity is in the view.
+  ///
+  /// @param[in] entity Entity to find.
+  ///
+  /// @returns True if the entity exists in the view, false otherwise.
+  ///
+  [[nodiscard]] bool Contains(const Entity entity) const noexcept
+  {
+    return view_.Contains(entity);
+  }
+
+  ///
+  /// Returns the amount of entities in the view.
+  ///
+  /// @return Amount of entities in the view.
+  ///
+  [[nodiscard]] size_t Size() const noexcept
+  {
+    return view_.Size();
+  }
+
+  ///
+  /// Returns a constant reference to the component data for the entity.
+  ///
+  /// @tparam Component The component to obtain reference of.
+  ///
+  /// @param[in] entity Entity to unpack data for.
+  ///
+  /// @return The unpacked component data.
+  ///
+  template<typename Component>
+  [[nodiscard]] const Component& Unpack(const Entity entity) const noexcept
+  {
+    return view_.template Unpack<std::remove_const_t<Component>>(entity);
+  }
+
+private:
+  friend class RegistrySnapshot;
+
+  template<typename... ViewComponents, typename Function>
+  friend void EntityForEach(const SnapshotView<ViewComponents...>& view, Function&& function);
+
+  ///
+  /// Constructor.
+  ///
+  /// @param[in] view View of the registry of the snapshot.
+  ///
+  explicit SnapshotView(View<Components...> view) : view_(std::move(view)) {}
+
+private:
+  View<Components...> view_;
+};
+
+///
+/// Read-only copy of the entities and components of a registry, taken with Registry::Snapshot.
+///
+/// The snapshot is made of copies of the chunks of the registry. Copies are shared between snapshots: a chunk that was
+/// not modified since the previous snapshot is not copied again. The snapshot never changes once taken, a thread can
+/// iterate it while another thread keeps modifying the registry.
+///
+/// The snapshot is iterated with read-only views, see SnapshotView.
+///
+/// @warning A snapshot must not be used by multiple threads at the same time.
+///
+class RegistrySnapshot final
+{
+public:
+  RegistrySnapshot(RegistrySnapshot&&) noexcept = default;
+  RegistrySnapshot& operator=(RegistrySnapshot&&) noexcept = default;
+
+  RegistrySnapshot(const RegistrySnapshot&) = delete;
+  RegistrySnapshot& operator=(const RegistrySnapshot&) = delete;
+
+  ///
+  /// Obtains a read-only view of the snapshot for the provided component types.
+  ///
+  /// @tparam Components View parameters, every component must be constant.
+  ///
+  /// @return Read-only view of the snapshot for the component types.
+  ///
+  template<typename... Components>
+  requires(std::is_const_v<std::remove_reference_t<Components>> && ...)
+  [[nodiscard]] SnapshotView<Components...> ViewFor()
+  {
+    return SnapshotView<Components...>(state_->registry->template ViewFor<Components...>());
+  }
+
+  ///
+  /// Returns a reference to the component data of the given component type for given entity.
+  ///
+  /// @tparam Component The component to obtain reference of.
+  ///
+  /// @param[in] entity Entity to unpack data for.
+  ///
+  /// @return The unpacked component data.
+  ///
+  template<typename Component>
+  [[nodiscard]] const Component& Unpack(const Entity entity)
+  {
+    return ViewFor<const Component>().template Unpack<Component>(entity);
+  }
+
+  ///
+  /// Returns whether or not the entity was alive when the snapshot was taken.
+  ///
+  /// @param[in] entity Entity to check.
+  ///
+  /// @return True if the entity is in the snapshot, false otherwise.
+  ///
+  [[nodiscard]] bool Valid(const Entity entity) const noexcept
+  {
+    return state_->registry->Valid(entity);
+  }
+
+  ///
+  /// Returns the total amount of entities in the snapshot.
+  ///
+  /// @return Amount of entities in the snapshot.
+  ///
+  [[nodiscard]] size_t EntityCount() const noexcept
+  {
+    return state_->entity_count;
+  }
+
+  ///
+  /// Returns the tick of the registry when the snapshot was taken.
+  ///
+  /// @return Tick of the snapshot.
+  ///
+  [[nodiscard]] Tick CurrentTick() const noexcept
+  {
+    return state_->registry->CurrentTick();
+  }
+
+private:
+  friend class Registry;
+
+  ///
+  /// Constructor.
+  ///
+  /// @param[in] state State of the snapshot.
+  ///
+  explicit RegistrySnapshot(Ref<details::SnapshotState> state) noexcept : state_(std::move(state)) {}
+
+private:
+  Ref<details::SnapshotState> state_;
+};
+
+inline RegistrySnapshot Registry::Snapshot()
+{
+  Ref<details::SnapshotState> state;
+
+  const auto released = std::ranges::find_if(snapshot_states_, [](const auto& previous) { return previous.unique(); });
+
+  if (released != snapshot_states_.end())
+  {
+    std::atomic_thread_fence(std::memory_order_acquire); // Synchronizes with the thread that released the snapshot
+
+    state = *released;
+  }
+  else
+  {
+    state = MakeRef<details::SnapshotState>();
+    state->registry = std::make_unique<Registry>();
+
+    if (snapshot_states_.size() != cSnapshotStates) snapshot_states_.push_back(state);
+    else
+    {
+      std::ranges::rotate(snapshot_states_, snapshot_states_.begin() + 1);
+      snapshot_states_.back() = state;
+    }
+  }
+
+  Registry& registry = *state->registry;
+
+  registry.tick_ = tick_;
+  state->entity_count = EntityCount();
+
+  if (shared_chunks_.size() < storages_.size()) shared_chunks_.resize(storages_.size());
+  if (state->chunks.size() < storages_.size()) state->chunks.resize(storages_.size());
+  if (state->archetypes.size() < storages_.size()) state->archetypes.resize(storages_.size(), cInvalidArchetype);
+
+  Vector<std::byte*> chunks;
+
+  for (ArchetypeId archetype = 0; archetype != storages_.size(); ++archetype)
+  {
+    const Storage<Entity>* storage = storages_[archetype];
+
+    if (!storage) continue;
+
+    Vector<Ref<SharedChunk<Entity>>>& copies = shared_chunks_[archetype];
+
+    const size_t chunk_count = storage->Size() != 0 ? storage->ChunkCount() : 0;
+
+    copies.resize(chunk_count);
+    chunks.clear();
+
+    for (size_t chunk = 0; chunk != chunk_count; ++chunk)
+    {
+      Ref<SharedChunk<Entity>>& copy = copies[chunk];
+
+      const size_t size = storage->ChunkSize(chunk);
+
+      // Rows that moved show up in the entities, components that were written to or added show up in the ticks
+      if (!copy || copy->Size() != size || storage->ChunkModifiedSince(chunk, copy->CopyTick())
+          || std::memcmp(copy->Entities(), storage->ChunkEntities(chunk), size * sizeof(Entity)) != 0)
+      {
+        copy = MakeRef<SharedChunk<Entity>>(*storage, chunk, tick_);
+      }
+
+      chunks.push_back(copy->Data());
+    }
+
+    ArchetypeId& id = state->archetypes[archetype];
+
+    if (id == cInvalidArchetype)
+    {
+      if (chunks.empty()) continue;
+
+      id = registry.AssureStorage(storage->ComponentInfos());
+    }
+
+    // The storage still reads the previous copies, they are only released once it adopted the new ones
+    registry.storages_[id]->Adopt({ chunks.data(), chunks.size() }, storage->Size());
+
+    Vector<Ref<SharedChunk<Entity>>>& adopted = state->chunks[archetype];
+
+    adopted.resize(copies.size());
+
+    std::ranges::copy(copies, adopted.begin());
+  }
+
+  return RegistrySnapshot(std::move(state));
+}
+
+namespace details
+{
+  ///
+  /// Opaque data type of an optional component. Pointers to it point to the component data, or are nullptr when the
+  /// component is not in the storage.
+  ///
+  /// @tparam Component Optional component type.
+  ///
+  template<typename Component>
+  struct OptionalData;
+
+  template<typename Type>
+  struct IsInstanceOfOptionalData : std::false_type
+  {};
+
+  template<typename Component>
+  struct IsInstanceOfOptionalData<OptionalData<Component>> : std::true_type
+  {
+    using Type = Component;
+  };
+
+  ///
+  /// Type of data accessed for a function argument. Pointer arguments access optional components.
+  ///
+  /// @tparam Arg Function argument type.
+  ///
+  template<typename Arg>
+  using ArgDataType = std::conditional_t<std::is_pointer_v<std::remove_cvref_t<Arg>>,
+    OptionalData<std::remove_cv_t<std::remove_pointer_t<std::remove_cvref_t<Arg>>>>,
+    std::remove_cvref_t<Arg>>;
+
+  template<typename DataType>
+  struct StoredData
+  {
+    using Type = StoredComponent<DataType>;
+  };
+
+  template<typename Component>
+  struct StoredData<OptionalData<Component>>
+  {
+    using Type = OptionalData<Component>;
+  };
+
+  ///
+  /// Type of the elements in the chunk arrays of the data. Components stored out of line are accessed through their
+  /// handles.
+  ///
+  /// @tparam DataType Type of data, can be a component, an optional component or the entity.
+  ///
+  template<typename DataType>
+  using StoredDataType = typename StoredData<DataType>::Type;
+
+  ///
+  /// Returns a pointer to the component from a pointer to its element in the chunk array.
+  ///
+  /// @tparam Type Element type.
+  ///
+  /// @param[in] pointer Pointer to the element.
+  ///
+  /// @return Pointer to the component.
+  ///
+  template<typename Type>
+  ALWAYS_INLINE constexpr Type* ResolvePointer(Type* pointer) noexcept
+  {
+    return pointer;
+  }
+
+  template<typename Component>
+  ALWAYS_INLINE constexpr Component* ResolvePointer(OutOfLineHandle<Component>* pointer) noexcept
+  {
+    return pointer->component;
+  }
+
+  ///
+  /// Advances the pointer of the data by the amount. Empty components always point to their shared instance and
+  /// missing optional components stay nullptr.
+  ///
+  /// @tparam DataType Type of data pointed to.
+  ///
+  /// @param[in] pointer Data pointer to advance.
+  /// @param[in] amount Amount to advance by.
+  ///
+  template<typename DataType>
+  ALWAYS_INLINE constexpr void AdvancePointer(DataType*& pointer, const ptrdiff_t amount) noexcept
+  {
+    if constexpr (IsInstanceOfOptionalData<DataType>::value)
+    {
+      using Component = typename IsInstanceOfOptionalData<DataType>::Type;
+
+      if (!std::is_empty_v<Component> && pointer)
+      {
+        pointer = reinterpret_cast<DataType*>(reinterpret_cast<StoredComponent<Component>*>(pointer) + amount);
+      }
+    }
+    else if constexpr (!std::is_empty_v<DataType>)
+    {
+      pointer += amount;
+    }
+  }
+
+  ///
+  /// Advances every pointer of the data by the amount. Empty components always point to their shared instance.
+  ///
+  /// @tparam DataTypes Types of data pointed to.
+  ///
+  /// @param[in] data Data pointers to advance.
+  /// @param[in] amount Amount to advance by.
+  ///
+  template<typename... DataTypes>
+  ALWAYS_INLINE constexpr void AdvanceData(std::tuple<DataTypes*...>& data, const ptrdiff_t amount) noexcept
+  {
+    (AdvancePointer(std::get<DataTypes*>(data), amount), ...);
+  }
+
+  ///
+  /// Unpacks the data of the current entity for a function argument. Optional components are passed as pointers.
+  ///
+  /// The data pointers either point into the chunk arrays, or directly to the components.
+  ///
+  /// @tparam Arg Function argument type.
+  /// @tparam DataTypes Types of data pointed to.
+  ///
+  /// @param[in] data Data pointers of the current entity.
+  ///
+  /// @return Reference to the data or pointer to the optional component.
+  ///
+  template<typename Arg, typename... DataTypes>
+  ALWAYS_INLINE constexpr decltype(auto) UnpackData(const std::tuple<DataTypes*...>& data) noexcept
+  {
+    using DataType = ArgDataType<Arg>;
+
+    if constexpr (IsInstanceOfOptionalData<DataType>::value)
+    {
+      using Component = typename IsInstanceOfOptionalData<DataType>::Type;
+
+      auto pointer = reinterpret_cast<StoredComponent<Component>*>(std::get<DataType*>(data));
+
+      if constexpr (IsStoredOutOfLine<Component>::value) return pointer ? pointer->component : nullptr;
+      else
+      {
+        return pointer;
+      }
+    }
+    else if constexpr ((std::same_as<DataTypes, StoredDataType<DataType>> || ...))
+    {
+      return *ResolvePointer(std::get<StoredDataType<DataType>*>(data));
+    }
+    else
+    {
+      return *std::get<DataType*>(data);
+    }
+  }
+
+  ///
+  /// Returns pointers to the data of the first entity in the chunk of the storage.
+  ///
+  /// @tparam DataTypes Types of data to access, can be components or the entity.
+  ///
+  /// @param[in] storage Storage to access.
+  /// @param[in] chunk Index of the chunk.
+  ///
+  /// @return Pointers to the data, components stored out of line are pointed to by their handles.
+  ///
+  template<typename... DataTypes>
+  std::tuple<StoredDataType<DataTypes>*...> ChunkData(Storage<Entity>* storage, const size_t chunk) noexcept
+  {
+    const auto access = [storage, chunk]<typename DataType>() -> StoredDataType<DataType>*
+    {
+      if constexpr (std::same_as<DataType, Entity>) return storage->ChunkEntities(chunk);
+      else if constexpr (IsInstanceOfOptionalData<DataType>::value)
+      {
+        using Component = typename IsInstanceOfOptionalData<DataType>::Type;
+
+        if (!storage->template HasComponent<Component>()) return nullptr;
+
+        return reinterpret_cast<DataType*>(storage->template ChunkComponents<Component>(chunk));
+      }
+      else
+      {
+        return storage->template ChunkComponents<DataType>(chunk);
+      }
+    };
+
+    return { access.template operator()<DataTypes>()... };
+  }
+
+  template<typename Function>
+  struct EntityPredicateHelper;
+
+  template<typename Return, typename Class, typename... Args>
+  struct EntityPredicateHelper<Return (Class::*)(Args...) const>
+  {
+    ALWAYS_INLINE static auto ChunkData(Storage<Entity>* storage, const size_t chunk) noexcept
+    {
+      return details::ChunkData<ArgDataType<Args>...>(storage, chunk);
+    }
+
+    template<typename Function, typename... DataTypes>
+    ALWAYS_INLINE static bool Test(Function& function, const std::tuple<DataTypes*...>& data)
+    {
+      return function(UnpackData<Args>(data)...);
+    }
+  };
+
+  template<typename Return, typename Class, typename... Args>
+  struct EntityPredicateHelper<Return (Class::*)(Args...)>
+  {
+    ALWAYS_INLINE static auto ChunkData(Storage<Entity>* storage, const size_t chunk) noexcept
+    {
+      return details::ChunkData<ArgDataType<Args>...>(storage, chunk);
+    }
+
+    template<typename Function, typename... DataTypes>
+    ALWAYS_INLINE static bool Test(Function& function, const std::tuple<DataTypes*...>& data)
+    {
+      return function(UnpackData<Args>(data)...);
+    }
+  };
+
+  ///
+  /// Appends the index of every entity of the storage for which the predicate returns true.
+  ///
+  /// Walks the chunk arrays of the storage directly, the indices are appended in increasing order.
+  ///
+  /// @tparam Predicate Invocable with the entity and/or components that returns a boolean.
+  ///
+  /// @param[in] storage Storage to test the entities of.
+  /// @param[in] predicate Predicate to test every entity with.
+  /// @param[out] rows Vector to append the indices to.
+  ///
+  template<typename Predicate>
+  void EntityPredicateRows(Storage<Entity>* storage, Predicate& predicate, Vector<size_t>& rows)
+  {
+    using Helper = EntityPredicateHelper<decltype(&Predicate::operator())>;
+
+    const size_t capacity = storage->ChunkCapacity();
+
+    for (size_t chunk = 0; chunk != storage->ChunkCount(); ++chunk)
+    {
+      auto data = Helper::ChunkData(storage, chunk);
+
+      const size_t first = chunk * capacity;
+      const size_t last = first + storage->ChunkSize(chunk);
+
+      for (size_t index = first; index != last; ++index)
+      {
+        if (Helper::Test(predicate, data)) rows.push_back(index);
+
+        AdvanceData(data, 1);
+      }
+    }
+  }
+
+  ///
+  /// Iterator over the entities and component data of a single storage.
+  ///
+  /// Walks the chunks of the storage, the pointers are only recomputed when crossing into another chunk. Components
+  /// stored out of line are resolved when dereferencing.
+  ///
+  /// @tparam DataTypes Types of data to iterate, can be components or the entity.
+  ///
+  template<typename... DataTypes>
+  class SubViewIterator
+  {
+  private:
+    using Self = SubViewIterator;
+
+  public:
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using pointers = std::tuple<std::remove_cvref_t<DataTypes>*...>;
+
+    // Dereferencing gives the pointers by value
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = pointers;
+    using pointer = void;
+    using reference = pointers;
+
+    constexpr SubViewIterator() noexcept = default;
+
+    SubViewIterator(Storage<Entity>* storage, size_t index) noexcept : storage_(storage), index_(index)
+    {
+      Load();
+    }
+
+    SubViewIterator(const SubViewIterator& other) noexcept = default;
+    SubViewIterator& operator=(const SubViewIterator&) noexcept = default;
+
+    template<typename... OtherDataTypes>
+    SubViewIterator(const SubViewIterator<OtherDataTypes...>& other) : SubViewIterator(other.storage_, other.index_)
     {}
 
     // clang-format off
 
     Self& operator+=(difference_type amount) noexcept
     {
-      ((std::get<std::remove_cvref_t<DataTypes>*>(data_) += amount), ...);
+      index_ += static_cast<size_t>(amount);
+      Load();
       return *this;
     }
 
     Self& operator-=(difference_type amount) noexcept
     {
-      ((std::get<std::remove_cvref_t<DataTypes>*>(data_) -= amount), ...);
+      index_ -= static_cast<size_t>(amount);
+      Load();
       return *this;
     }
 
     Self& operator++() noexcept
     {
-      (++std::get<std::remove_cvref_t<DataTypes>*>(data_), ...);
+      if ((++index_ & (storage_->ChunkCapacity() - 1)) == 0) [[unlikely]] Load();
+      else
+      {
+        AdvanceData(data_, 1);
+      }
+
       return *this;
     }
 
     Self& operator--() noexcept
     {
-      (--std::get<std::remove_cvref_t<DataTypes>*>(data_), ...);
+      // Past the end iterators have no data loaded, even when the last chunk is not full
+      const bool past_end = index_ >= storage_->Size();
+
+      if ((index_-- & (storage_->ChunkCapacity() - 1)) == 0 || past_end) [[unlikely]] Load();
+      else
+      {
+        AdvanceData(data_, -1);
+      }
+
       return *this;
     }
 
@@ -306,17 +1518,17 @@ namespace details
 
     [[nodiscard]] friend difference_type operator-(const Self& lhs, const Self& rhs) noexcept
     {
-      return std::get<0>(lhs.data_) - std::get<0>(rhs.data_);
+      return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
     }
 
-    const pointers& operator*() const noexcept
+    pointers operator*() const noexcept
     {
-      return data_;
+      return { ResolvePointer(std::get<StoredDataType<std::remove_cvref_t<DataTypes>>*>(data_))... };
     }
 
     [[nodiscard]] friend bool operator==(const Self& lhs, const Self& rhs) noexcept
     {
-      return std::get<0>(lhs.data_) == std::get<0>(rhs.data_);
+      return lhs.index_ == rhs.index_;
     }
 
     [[nodiscard]] friend bool operator!=(const Self& lhs, const Self& rhs) noexcept
@@ -327,27 +1539,50 @@ namespace details
     [[nodiscard]]
     friend std::strong_ordering operator<=>(const Self& lhs, const Self& rhs) noexcept
     {
-      return std::get<0>(lhs.data_) <=> std::get<0>(rhs.data_);
+      return lhs.index_ <=> rhs.index_;
     }
 
     // clang-format on
 
+    ///
+    /// Returns the sub view over the storage that is iterated.
+    ///
+    /// @return Sub view of the storage.
+    ///
+    [[nodiscard]] SubView<> GetSubView() const noexcept;
+
+    ///
+    /// Returns the index of the entity in the storage.
+    ///
+    /// @return Index of the entity.
+    ///
+    [[nodiscard]] size_t Index() const noexcept
+    {
+      return index_;
+    }
+
   private:
-    template<typename DataType>
-    DataType* AccessFromStorage(Storage<Entity>* storage, size_t offset) noexcept
+    template<typename...>
+    friend class SubViewIterator;
+
+    ///
+    /// Computes the data pointers for the current index. Past the end iterators are never dereferenced.
+    ///
+    void Load() noexcept
     {
-      if constexpr (std::same_as<DataType, Entity>)
-      {
-        return storage->data() + offset;
-      }
-      else
+      if (index_ < storage_->Size())
       {
-        return storage->template Access<DataType>().data() + offset;
+        const size_t capacity = storage_->ChunkCapacity();
+
+        data_ = ChunkData<std::remove_cvref_t<DataTypes>...>(storage_, index_ / capacity);
+        AdvanceData(data_, static_cast<difference_type>(index_ & (capacity - 1)));
       }
     }
 
   private:
-    pointers data_;
+    Storage<Entity>* storage_;
+    size_t index_;
+    std::tuple<StoredDataType<std::remove_cvref_t<DataTypes>>*...> data_;
   };
 } // namespace details
 
@@ -381,32 +1616,167 @@ public:
   [[nodiscard]] reverse_iterator rbegin() const noexcept { return reverse_iterator(end()); }
   [[nodiscard]] reverse_iterator rend() const noexcept { return reverse_iterator(begin()); }
 
-  [[nodiscard]] const Entity* ebegin() const noexcept { return storage_->begin(); }
-  [[nodiscard]] const Entity* eend() const noexcept { return storage_->end(); }
+  [[nodiscard]] Storage<Entity>::const_iterator ebegin() const noexcept { return storage_->begin(); }
+  [[nodiscard]] Storage<Entity>::const_iterator eend() const noexcept { return storage_->end(); }
+
+  // clang-format on
+
+public:
+  ///
+  /// Checks if the entity is in the view.
+  ///
+  /// @param[in] entity Entity to find.
+  ///
+  /// @returns True if the entity exists in the view, false otherwise.
+  ///
+  [[nodiscard]] bool Contains(const Entity entity) const noexcept
+  {
+    return storage_->Contains(entity);
+  }
+
+  ///
+  /// Returns the amount of entities in the view.
+  ///
+  /// @return Amount of entities in the view.
+  ///
+  [[nodiscard]] size_t Size() const noexcept
+  {
+    return storage_->Size();
+  }
+
+  ///
+  /// Returns the amount of chunks that contain entities.
+  ///
+  /// @return Amount of chunks in the view.
+  ///
+  [[nodiscard]] size_t ChunkCount() const noexcept
+  {
+    return storage_->ChunkCount();
+  }
+
+  ///
+  /// Returns the amount of entities in the chunk.
+  ///
+  /// @param[in] chunk Index of the chunk.
+  ///
+  /// @return Amount of entities in the chunk.
+  ///
+  [[nodiscard]] size_t ChunkSize(const size_t chunk) const noexcept
+  {
+    return storage_->ChunkSize(chunk);
+  }
+
+  ///
+  /// Returns the maximum amount of entities a chunk can hold. Always a power of two.
+  ///
+  /// @return Capacity of a chunk.
+  ///
+  [[nodiscard]] size_t ChunkCapacity() const noexcept
+  {
+    return storage_->ChunkCapacity();
+  }
+
+  ///
+  /// Returns the version of the layout of the storage, see Storage::Version.
+  ///
+  /// @return Version of the layout.
+  ///
+  [[nodiscard]] size_t Version() const noexcept
+  {
+    return storage_->Version();
+  }
+
+  ///
+  /// Returns pointers to the data of the first entity in the chunk. The data of every entity in the chunk is
+  /// contiguous.
+  ///
+  /// @note Components stored out of line are pointed to by their handles.
+  ///
+  /// @tparam DataTypes Types of data to access, can be components, pointers to optional components or the entity.
+  ///
+  /// @param[in] chunk Index of the chunk.
+  ///
+  /// @return Pointers to the data.
+  ///
+  template<typename... DataTypes>
+  [[nodiscard]] std::tuple<details::StoredDataType<details::ArgDataType<DataTypes>>*...> ChunkData(
+    const size_t chunk) const noexcept
+  {
+    return details::ChunkData<details::ArgDataType<DataTypes>...>(storage_, chunk);
+  }
+
+  ///
+  /// Returns whether or not the entities of the sub view have the component.
+  ///
+  /// @tparam Component The component type.
+  ///
+  /// @return True if the archetype of the sub view has the component, false otherwise.
+  ///
+  template<typename Component>
+  [[nodiscard]] bool HasComponent() const noexcept
+  {
+    return storage_->template HasComponent<Component>();
+  }
+
+  ///
+  /// Returns the last tick the component was changed in the chunk.
+  ///
+  /// @tparam Component The component type.
+  ///
+  /// @param[in] chunk Index of the chunk.
+  ///
+  /// @return Last changed tick.
+  ///
+  template<typename Component>
+  [[nodiscard]] Tick ChunkChangedTick(const size_t chunk) const noexcept
+  {
+    return storage_->template ChunkChangedTick<Component>(chunk);
+  }
 
-  // clang-format on
+  ///
+  /// Returns the newest tick the component was added to an entity of the chunk.
+  ///
+  /// @tparam Component The component type.
+  ///
+  /// @param[in] chunk Index of the chunk.
+  ///
+  /// @return Newest added tick.
+  ///
+  template<typename Component>
+  [[nodiscard]] Tick ChunkAddedTick(const size_t chunk) const noexcept
+  {
+    return storage_->template ChunkAddedTick<Component>(chunk);
+  }
 
-public:
   ///
-  /// Checks if the entity is in the view.
+  /// Returns the ticks the component was added at for every entity of the chunk.
   ///
-  /// @param[in] entity Entity to find.
+  /// @tparam Component The component type.
   ///
-  /// @returns True if the entity exists in the view, false otherwise.
+  /// @param[in] chunk Index of the chunk.
   ///
-  [[nodiscard]] bool Contains(const Entity entity) const noexcept
+  /// @return Pointer to the added tick of the first entity of the chunk.
+  ///
+  template<typename Component>
+  [[nodiscard]] const Tick* ChunkAddedTicks(const size_t chunk) const noexcept
   {
-    return storage_->Contains(entity);
+    return storage_->template ChunkAddedTicks<Component>(chunk);
   }
 
   ///
-  /// Returns the amount of entities in the view.
+  /// Marks the component as changed for every entity of the chunk.
   ///
-  /// @return Amount of entities in the view.
+  /// @note
+  ///    EntityForEach marks the components the function takes by mutable reference. Iterating manually does not.
   ///
-  [[nodiscard]] size_t Size() const noexcept
+  /// @tparam Component The component type.
+  ///
+  /// @param[in] chunk Index of the chunk.
+  ///
+  template<typename Component>
+  void MarkChunkChanged(const size_t chunk) const noexcept
   {
-    return storage_->Size();
+    storage_->template MarkChunkChanged<Component>(chunk);
   }
 
   ///
@@ -444,13 +1814,20 @@ public:
   template<typename Component>
   [[nodiscard]] Component& Unpack(const Entity entity) noexcept
   {
-    return const_cast<Component&>(static_cast<const SubView*>(this)->Unpack<Component>(entity));
+    ASSERT(Contains(entity), "Entity does not exist in the view");
+
+    storage_->template MarkChanged<Component>(entity);
+
+    return storage_->template Unpack<Component>(entity);
   }
 
 private:
   template<typename...>
   friend class View;
 
+  template<typename...>
+  friend class details::SubViewIterator;
+
   ///
   /// Constructs a view from a storage.
   ///
@@ -462,6 +1839,12 @@ private:
   Storage<Entity>* storage_;
 };
 
+template<typename... DataTypes>
+SubView<> details::SubViewIterator<DataTypes...>::GetSubView() const noexcept
+{
+  return SubView<>(storage_);
+}
+
 ///
 /// View contains entities of possibly different archetypes.
 ///
@@ -474,7 +1857,7 @@ private:
 ///     For example, if a new archetype is created with all the required components after this view was created, it will
 ///     not be in the view. For this reason, it is good practice to recreate views when needed.
 ///
-/// @tparam Components Required component types for the view.
+/// @tparam Components View parameters: required component types, Without<...> and Optional<...> components.
 ///
 template<typename... Components>
 class View
@@ -564,14 +1947,17 @@ public:
 public:
   static constexpr bool cNoComponents = sizeof...(Components) == 0;
 
+  // Resetting the entity manager would hand out old identifiers again, only allowed without generations
+  static constexpr bool cReleaseAll = cNoComponents && EntityTraits<Entity>::cGenerationBits == 0;
+
   ///
   /// Constructor.
   ///
   /// @param[in] registry Registry to construct view for.
   ///
   constexpr explicit View(Registry& registry)
-    : registry_(registry),
-      archetypes_(registry.relations_.ViewArchetypes(registry.relations_.template AssureView<Components...>()))
+    : registry_(registry), view_(registry.relations_.template AssureView<Components...>()),
+      archetypes_(registry.relations_.ViewArchetypes(view_))
   {}
 
   ///
@@ -584,7 +1970,35 @@ public:
   ///
   void Destroy(const Entity entity)
   {
-    ASSERT(Contains(entity), "Entity does not exist in view");
+    if (!registry_.observers_.Empty()) [[unlikely]]
+    {
+      registry_.observers_.Record(registry_.FindArchetype(entity), cInvalidArchetype, entity);
+    }
+
+    FindStorage(entity)->Erase(entity);
+
+    registry_.entity_manager_.Release(entity);
+  }
+
+  ///
+  /// Destroys every entity in the view for which the predicate returns true.
+  ///
+  /// Every storage of the view is scanned once and compacted in a single pass per array, then the destroyed entities
+  /// are released together. This is much faster than destroying the entities one by one.
+  ///
+  /// @tparam Predicate Invocable with the entity and/or components that returns whether or not to destroy the entity.
+  ///
+  /// @param[in] predicate Predicate to test every entity with.
+  ///
+  /// @return Amount of entities destroyed.
+  ///
+  template<typename Predicate>
+  size_t DestroyIf(Predicate predicate)
+  {
+    Vector<size_t>& rows = registry_.destroy_rows_;
+    Vector<Entity>& destroyed = registry_.destroyed_;
+
+    destroyed.clear();
 
     for (const auto archetype : archetypes_)
     {
@@ -592,15 +2006,24 @@ public:
 
       ASSERT(storage, "Storage not initialized");
 
-      if (storage->Contains(entity))
-      {
-        storage->Erase(entity);
+      const size_t first = destroyed.size();
+
+      rows.clear();
+
+      details::EntityPredicateRows(storage, predicate, rows);
 
-        registry_.entity_manager_.Release(entity);
+      storage->EraseRows(rows, destroyed);
 
-        return;
+      if (!registry_.observers_.Empty()) [[unlikely]]
+      {
+        registry_.observers_.RecordMany(
+          archetype, cInvalidArchetype, std::span<const Entity>(destroyed.data() + first, destroyed.size() - first));
       }
     }
+
+    registry_.entity_manager_.ReleaseMany(destroyed.data(), destroyed.size());
+
+    return destroyed.size();
   }
 
   ///
@@ -614,7 +2037,7 @@ public:
 
       ASSERT(storage, "Storage not initialized");
 
-      if constexpr (!cNoComponents) // Release all later
+      if constexpr (!cReleaseAll) // Release all later
       {
         for (auto entity : *storage)
         {
@@ -622,10 +2045,18 @@ public:
         }
       }
 
+      if (!registry_.observers_.Empty()) [[unlikely]]
+      {
+        for (auto entity : *storage)
+        {
+          registry_.observers_.Record(archetype, cInvalidArchetype, entity);
+        }
+      }
+
       storage->Clear();
     }
 
-    if constexpr (cNoComponents)
+    if constexpr (cReleaseAll)
     {
       // This releases everything at once very cheaply.
       registry_.entity_manager_.ReleaseAll();
@@ -633,24 +2064,41 @@ public:
   }
 
   ///
-  /// Checks if the entity is in the view.
+  /// Sorts the entities of every storage of the view by one of their components.
   ///
-  /// @param[in] entity Entity to find.
+  /// Every storage is sorted on its own, entities never change archetype. See Storage::Sort.
   ///
-  /// @returns True if the entity exists in the view, false otherwise.
+  /// @tparam Component Component type to sort by, every storage of the view must have it.
+  /// @tparam Compare Invocable with two components that returns whether or not the first goes before the second, or
+  /// invocable with one component that returns its integral key.
   ///
-  [[nodiscard]] bool Contains(const Entity entity) const noexcept
+  /// @param[in] compare Comparison or key of the components.
+  ///
+  template<typename Component, typename Compare>
+  void Sort(Compare compare)
   {
     for (const auto archetype : archetypes_)
     {
-      const auto storage = registry_.storages_[archetype];
+      auto storage = registry_.storages_[archetype];
 
       ASSERT(storage, "Storage not initialized");
 
-      if (storage->Contains(entity)) return true;
+      storage->template Sort<std::remove_cvref_t<Component>>(compare);
     }
+  }
 
-    return false;
+  ///
+  /// Checks if the entity is in the view.
+  ///
+  /// @param[in] entity Entity to find.
+  ///
+  /// @returns True if the entity exists in the view, false otherwise.
+  ///
+  [[nodiscard]] bool Contains(const Entity entity) const noexcept
+  {
+    if (!registry_.mappings_.Valid(entity)) return false;
+
+    return registry_.relations_.ViewContains(view_, registry_.mappings_.Archetype(entity));
   }
 
   ///
@@ -684,7 +2132,7 @@ public:
   ///
   /// Returns a reference to the component data for the entity.
   ///
-  /// This operation is O(n) where n is the amount of archetypes in the view.
+  /// The storage of the entity is found with a single lookup, no matter how many archetypes are in the view.
   ///
   /// @note
   ///    Prefer obtaining unpacked components directly from iterating when possible.
@@ -698,28 +2146,13 @@ public:
   template<typename Component>
   [[nodiscard]] const Component& Unpack(const Entity entity) const noexcept
   {
-    ASSERT(Contains(entity), "Entity does not exist in the view");
-
-    const auto end = archetypes_.end() - 1;
-
-    for (auto it = archetypes_.begin(); it != end; ++it)
-    {
-      const auto storage = registry_.storages_[*it];
-
-      ASSERT(storage, "Storage not initialized");
-
-      if (storage->Contains(entity)) return storage->template Unpack<Component>(entity);
-    }
-
-    ASSERT(registry_.storages_[*end], "Storage not initialized");
-
-    return registry_.storages_[*end]->template Unpack<Component>(entity);
+    return FindStorage(entity)->template ComponentAt<Component>(registry_.mappings_[entity]);
   }
 
   ///
   /// Returns a reference to the component data for the entity.
   ///
-  /// This operation is O(n) where n is the amount of archetypes in the view.
+  /// The storage of the entity is found with a single lookup, no matter how many archetypes are in the view.
   ///
   /// @note
   ///    Prefer obtaining unpacked components directly from iterating when possible.
@@ -733,11 +2166,33 @@ public:
   template<typename Component>
   [[nodiscard]] Component& Unpack(const Entity entity) noexcept
   {
-    return const_cast<Component&>(static_cast<const View*>(this)->Unpack<Component>(entity));
+    auto storage = FindStorage(entity);
+
+    const size_t index = registry_.mappings_[entity];
+
+    storage->template MarkChangedAt<Component>(index);
+
+    return storage->template ComponentAt<Component>(index);
+  }
+
+private:
+  ///
+  /// Returns the storage of the view that contains the entity.
+  ///
+  /// @param[in] entity Entity to find.
+  ///
+  /// @return Storage that contains the entity.
+  ///
+  [[nodiscard]] Storage<Entity>* FindStorage(const Entity entity) const noexcept
+  {
+    ASSERT(Contains(entity), "Entity does not exist in the view");
+
+    return registry_.storages_[registry_.FindArchetype(entity)];
   }
 
 private:
   Registry& registry_;
+  ViewId view_;
   const Vector<ArchetypeId>& archetypes_;
 };
 
@@ -751,68 +2206,364 @@ namespace details
   struct IsInstanceOfSubView<SubView<Components...>> : std::true_type
   {};
 
-  template<typename Type>
-  struct IsInstanceOfView : std::false_type
-  {};
+  template<typename Type>
+  struct IsInstanceOfView : std::false_type
+  {};
+
+  template<typename... Components>
+  struct IsInstanceOfView<View<Components...>> : std::true_type
+  {};
+
+  template<typename Type>
+  struct IsInstanceOfEntityApplyData : std::false_type
+  {};
+
+  template<typename... DataTypes>
+  struct IsInstanceOfEntityApplyData<std::tuple<DataTypes*...>> : std::true_type
+  {};
+
+  template<typename Type>
+  concept InstanceOfEntityApplyData = IsInstanceOfEntityApplyData<std::remove_cvref_t<Type>>::value;
+
+  template<typename Function>
+  struct EntityApplyHelper;
+
+  template<typename Class, typename... Args>
+  struct EntityApplyHelper<void (Class::*)(Args...) const>
+  {
+    template<typename Function, typename... DataTypes>
+    FLATTEN ALWAYS_INLINE static constexpr void Apply(Function&& function, const std::tuple<DataTypes*...>& data)
+    {
+      function(UnpackData<Args>(data)...);
+    }
+  };
+
+  template<typename Class, typename... Args>
+  struct EntityApplyHelper<void (Class::*)(Args...)>
+  {
+    template<typename Function, typename... DataTypes>
+    FLATTEN ALWAYS_INLINE static constexpr void Apply(Function&& function, const std::tuple<DataTypes*...>& data)
+    {
+      function(UnpackData<Args>(data)...);
+    }
+  };
+
+  ///
+  /// Marks the component of the argument as changed in the chunk if the argument is a mutable reference, or a mutable
+  /// pointer to an optional component that the sub view has.
+  ///
+  /// @tparam Arg Argument type of the function.
+  /// @tparam SubViewType The sub view type.
+  ///
+  /// @param[in] view The sub view that is iterated.
+  /// @param[in] chunk Index of the chunk that is iterated.
+  ///
+  template<typename Arg, typename SubViewType>
+  void MarkChangedArg(const SubViewType& view, const size_t chunk) noexcept
+  {
+    using Type = std::remove_reference_t<Arg>;
+    using Pointee = std::remove_pointer_t<std::remove_cvref_t<Arg>>;
+
+    if constexpr (std::is_lvalue_reference_v<Arg> && !std::is_const_v<Type> && !std::same_as<Type, Entity>)
+    {
+      view.template MarkChunkChanged<Type>(chunk);
+    }
+    else if constexpr (std::is_pointer_v<std::remove_cvref_t<Arg>> && !std::is_const_v<Pointee>)
+    {
+      if (view.template HasComponent<Pointee>()) view.template MarkChunkChanged<Pointee>(chunk);
+    }
+  }
+
+  ///
+  /// Concept for the function arguments that only read their data: values, constant references and pointers to
+  /// constant optional components.
+  ///
+  /// @tparam Arg Argument type of the function.
+  ///
+  template<typename Arg>
+  concept ReadOnlyArg = (!std::is_reference_v<Arg> || std::is_const_v<std::remove_reference_t<Arg>>)
+                     && (!std::is_pointer_v<std::remove_cvref_t<Arg>>
+                         || std::is_const_v<std::remove_pointer_t<std::remove_cvref_t<Arg>>>);
+
+  template<typename Function>
+  struct IsReadOnlyFunction : std::false_type
+  {};
+
+  template<typename Class, typename... Args>
+  struct IsReadOnlyFunction<void (Class::*)(Args...) const> : std::bool_constant<(ReadOnlyArg<Args> && ...)>
+  {};
+
+  template<typename Class, typename... Args>
+  struct IsReadOnlyFunction<void (Class::*)(Args...)> : std::bool_constant<(ReadOnlyArg<Args> && ...)>
+  {};
+
+  ///
+  /// Concept for the functions applied to entities that never modify the components.
+  ///
+  /// @tparam Function Function to check.
+  ///
+  template<typename Function>
+  concept ReadOnlyEntityFunction = IsReadOnlyFunction<decltype(&std::remove_cvref_t<Function>::operator())>::value;
+
+  ///
+  /// Component type the argument modifies: the referenced type of a mutable reference, the pointee of a mutable
+  /// pointer or the element type of a mutable span. Void when the argument only reads its data.
+  ///
+  /// @tparam Arg Argument type of the function.
+  ///
+  template<typename Arg>
+  struct ModifiedComponent
+  {
+    using Type = std::remove_reference_t<Arg>;
+    using Pointee = std::remove_pointer_t<std::remove_cvref_t<Arg>>;
+
+    using type = std::conditional_t<std::is_lvalue_reference_v<Arg> && !std::is_const_v<Type>,
+      Type,
+      std::conditional_t<std::is_pointer_v<std::remove_cvref_t<Arg>> && !std::is_const_v<Pointee>, Pointee, void>>;
+  };
+
+  template<typename Element, size_t Extent>
+  struct ModifiedComponent<std::span<Element, Extent>>
+  {
+    using type = std::conditional_t<std::is_const_v<Element>, void, Element>;
+  };
+
+  ///
+  /// Whether or not the view parameter declares the component read only.
+  ///
+  /// @tparam Component Component type.
+  /// @tparam Parameter View parameter.
+  ///
+  template<typename Component, typename Parameter>
+  struct IsReadOnlyParameter : std::is_same<Parameter, const Component>
+  {};
+
+  template<typename Component, typename... Components>
+  struct IsReadOnlyParameter<Component, Optional<Components...>>
+    : std::bool_constant<(std::is_same_v<Components, const Component> || ...)>
+  {};
+
+  template<typename Component, typename... Parameters>
+  struct IsReadOnlyInView : std::bool_constant<(IsReadOnlyParameter<Component, Parameters>::value || ...)>
+  {};
+
+  template<typename ViewType, typename Function>
+  struct IsViewConstFunction : std::true_type
+  {};
+
+  template<typename... Components, typename Class, typename... Args>
+  struct IsViewConstFunction<View<Components...>, void (Class::*)(Args...) const>
+    : std::bool_constant<(!IsReadOnlyInView<typename ModifiedComponent<Args>::type, Components...>::value && ...)>
+  {};
+
+  template<typename... Components, typename Class, typename... Args>
+  struct IsViewConstFunction<View<Components...>, void (Class::*)(Args...)>
+    : IsViewConstFunction<View<Components...>, void (Class::*)(Args...) const>
+  {};
+
+  ///
+  /// Returns the view that the view type is or derives from, only used in unevaluated contexts.
+  ///
+  template<typename... Components>
+  View<Components...> BaseView(const View<Components...>&);
+
+  ///
+  /// Concept for the functions that do not modify the components the view declares const.
+  ///
+  /// @tparam ViewType View type, or a type derived from a view.
+  /// @tparam Function Function to check.
+  ///
+  template<typename ViewType, typename Function>
+  concept ViewConstFunction = IsViewConstFunction<decltype(BaseView(std::declval<ViewType>())),
+    decltype(&std::remove_cvref_t<Function>::operator())>::value;
+
+  template<typename SubViewType, typename Function>
+  struct EntityForEachHelper;
+
+  template<typename... Components, typename Class, typename... Args>
+  struct EntityForEachHelper<SubView<Components...>, void (Class::*)(Args...) const>
+  {
+    static auto ChunkData(const SubView<Components...>& view, size_t chunk) noexcept
+    {
+      return view.template ChunkData<Args...>(chunk);
+    }
+
+    static void MarkChanged(const SubView<Components...>& view, size_t chunk) noexcept
+    {
+      (MarkChangedArg<Args>(view, chunk), ...);
+    }
+  };
+
+  template<typename... Components, typename Class, typename... Args>
+  struct EntityForEachHelper<SubView<Components...>, void (Class::*)(Args...)>
+  {
+    static auto ChunkData(const SubView<Components...>& view, size_t chunk) noexcept
+    {
+      return view.template ChunkData<Args...>(chunk);
+    }
+
+    static void MarkChanged(const SubView<Components...>& view, size_t chunk) noexcept
+    {
+      (MarkChangedArg<Args>(view, chunk), ...);
+    }
+  };
+
+  template<typename Type>
+  struct IsInstanceOfSpan : std::false_type
+  {};
+
+  template<typename Type>
+  struct IsInstanceOfSpan<std::span<Type>> : std::true_type
+  {};
+
+  ///
+  /// Returns the span over the data of every entity in the chunk of the sub view for a function argument.
+  ///
+  /// The data of a chunk always starts on the chunk alignment, which the compiler is told about.
+  ///
+  /// @tparam Arg Function argument type, must be a span of a component or of const entities.
+  /// @tparam SubViewType The sub view type.
+  ///
+  /// @param[in] view The sub view that is iterated.
+  /// @param[in] chunk Index of the chunk that is iterated.
+  ///
+  /// @return Span over the data of the chunk.
+  ///
+  template<typename Arg, typename SubViewType>
+  std::remove_cvref_t<Arg> ChunkSpan(const SubViewType& view, const size_t chunk) noexcept
+  {
+    using Span = std::remove_cvref_t<Arg>;
+
+    static_assert(IsInstanceOfSpan<Span>::value, "Arguments must be dynamic extent spans");
 
-  template<typename... Components>
-  struct IsInstanceOfView<View<Components...>> : std::true_type
-  {};
+    using Element = typename Span::element_type;
+    using Type = std::remove_const_t<Element>;
 
-  template<typename Type>
-  struct IsInstanceOfEntityApplyData : std::false_type
-  {};
+    static_assert(!std::is_empty_v<Type>, "Empty components have no array");
+    static_assert(!IsStoredOutOfLine<Type>::value, "Components stored out of line are not contiguous");
+    static_assert(!std::same_as<Type, Entity> || std::is_const_v<Element>, "Entities cannot be modified");
 
-  template<typename... DataTypes>
-  struct IsInstanceOfEntityApplyData<std::tuple<DataTypes*...>> : std::true_type
-  {};
+    if constexpr (!std::is_const_v<Element>) view.template MarkChunkChanged<Type>(chunk);
 
-  template<typename Type>
-  concept InstanceOfEntityApplyData = IsInstanceOfEntityApplyData<std::remove_cvref_t<Type>>::value;
+    Type* data = std::get<0>(view.template ChunkData<Type>(chunk));
+
+    return Span(std::assume_aligned<Storage<Entity>::cChunkAlignment>(data), view.ChunkSize(chunk));
+  }
 
   template<typename Function>
-  struct EntityApplyHelper;
+  struct EntityForEachSpanHelper;
 
   template<typename Class, typename... Args>
-  struct EntityApplyHelper<void (Class::*)(Args...) const>
+  struct EntityForEachSpanHelper<void (Class::*)(Args...) const>
   {
-    template<typename Function, typename... DataTypes>
-    FLATTEN ALWAYS_INLINE static constexpr void Apply(Function&& function, const std::tuple<DataTypes*...>& data)
+    template<typename SubViewType, typename Function>
+    ALWAYS_INLINE static void Apply(const SubViewType& view, const size_t chunk, Function& function)
     {
-      function(*std::get<std::remove_cvref_t<Args>*>(data)...);
+      function(ChunkSpan<Args>(view, chunk)...);
     }
   };
 
   template<typename Class, typename... Args>
-  struct EntityApplyHelper<void (Class::*)(Args...)>
+  struct EntityForEachSpanHelper<void (Class::*)(Args...)>
   {
-    template<typename Function, typename... DataTypes>
-    FLATTEN ALWAYS_INLINE static constexpr void Apply(Function&& function, const std::tuple<DataTypes*...>& data)
+    template<typename SubViewType, typename Function>
+    ALWAYS_INLINE static void Apply(const SubViewType& view, const size_t chunk, Function& function)
     {
-      function(*std::get<std::remove_cvref_t<Args>*>(data)...);
+      function(ChunkSpan<Args>(view, chunk)...);
     }
   };
 
-  template<typename SubViewType, typename Function>
-  struct EntityForEachHelper;
-
-  template<typename... Components, typename Class, typename... Args>
-  struct EntityForEachHelper<SubView<Components...>, void (Class::*)(Args...) const>
+  ///
+  /// Invokes the function for every entity of contiguous data.
+  ///
+  /// @tparam Function Function to apply at each iteration.
+  /// @tparam DataTypes Types of data to unpack.
+  ///
+  /// @param[in] data Pointers to the data of the first entity.
+  /// @param[in] count Amount of entities.
+  /// @param[in] function The function object to apply at every iteration.
+  ///
+  template<typename Function, typename... DataTypes>
+  ALWAYS_INLINE constexpr void EntityForEachData(std::tuple<DataTypes*...> data, const size_t count, Function& function)
   {
+    using FunctionPtr = decltype(&std::remove_cvref_t<Function>::operator());
+    using Helper = EntityApplyHelper<FunctionPtr>;
+
+    const auto odd_iterations = count & 1;
+
+    auto trip_count = count >> 1;
+
     // clang-format off
-    static auto begin(const SubView<Components...>& view) noexcept { return view.template begin<Args...>(); }
-    static auto end(const SubView<Components...>& view) noexcept { return view.template end<Args...>(); }
+
+    for (; trip_count > 0; --trip_count)
+    {
+      Helper::Apply(function, data); AdvanceData(data, 1);
+      Helper::Apply(function, data); AdvanceData(data, 1);
+    }
+
+    if(odd_iterations)
+    {
+      Helper::Apply(function, data);
+    }
+
     // clang-format on
-  };
+  }
 
-  template<typename... Components, typename Class, typename... Args>
-  struct EntityForEachHelper<SubView<Components...>, void (Class::*)(Args...)>
+  ///
+  /// Invokes the function for every entity with an index in the range of the sub view.
+  ///
+  /// @tparam SubViewType The sub view type.
+  /// @tparam Function Function to apply at each iteration.
+  ///
+  /// @param[in] view The sub view to iterate.
+  /// @param[in] first, last The range of entity indices to apply the function to.
+  /// @param[in] function The function object to apply at every iteration.
+  ///
+  template<typename SubViewType, typename Function>
+  void EntityForEachRange(const SubViewType& view, size_t first, const size_t last, Function& function)
   {
-    // clang-format off
-    static auto begin(const SubView<Components...>& view) noexcept { return view.template begin<Args...>(); }
-    static auto end(const SubView<Components...>& view) noexcept { return view.template end<Args...>(); }
-    // clang-format on
-  };
+    using FunctionPtr = decltype(&std::remove_cvref_t<Function>::operator());
+    using Helper = EntityForEachHelper<SubViewType, FunctionPtr>;
+
+    const size_t capacity = view.ChunkCapacity();
+
+    while (first < last)
+    {
+      const size_t offset = first & (capacity - 1);
+      const size_t count = std::min(last - first, capacity - offset);
+
+      auto data = Helper::ChunkData(view, first / capacity);
+      AdvanceData(data, static_cast<ptrdiff_t>(offset));
+
+      Helper::MarkChanged(view, first / capacity);
+
+      EntityForEachData(data, count, function);
+
+      first += count;
+    }
+  }
+
+  ///
+  /// Schedules the iteration of a range of the sub view on the thread pool.
+  ///
+  /// @tparam SubViewType The sub view type.
+  /// @tparam Function Function to apply at each iteration.
+  ///
+  /// @param[in] pool Thread pool to execute on.
+  /// @param[in] view The sub view to iterate.
+  /// @param[in] first, last The range of entity indices to apply the function to.
+  /// @param[in] function The function object to apply at every iteration.
+  ///
+  /// @return Task that iterates the range once awaited.
+  ///
+  template<typename SubViewType, typename Function>
+  Task<> ParallelEntityForEachRange(
+    ThreadPool& pool, const SubViewType view, const size_t first, const size_t last, Function& function)
+  {
+    co_await pool.Schedule();
+
+    EntityForEachRange(view, first, last, function);
+  }
 } // namespace details
 
 // clang-format off
@@ -864,6 +2615,9 @@ concept ViewIterator = requires(Type value)
 /// It is recommended to always use this method for iterating over entities instead manually iterating. It is both safer
 /// and more efficient in many cases.
 ///
+/// Like for the whole sub view, the components the function takes by mutable reference are marked changed in every
+/// chunk of the range.
+///
 /// @tparam Iterator SubView iterator type.
 /// @tparam Function Function to apply at each iteration.
 ///
@@ -873,28 +2627,7 @@ concept ViewIterator = requires(Type value)
 template<SubViewIterator Iterator, typename Function>
 ALWAYS_INLINE constexpr void EntityForEach(Iterator first, Iterator last, Function&& function)
 {
-  using FunctionPtr = decltype(&std::remove_cvref_t<Function>::operator());
-  using Helper = details::EntityApplyHelper<FunctionPtr>;
-
-  const auto iterations = (last - first);
-  const auto odd_iterations = iterations & 1;
-
-  auto trip_count = iterations >> 1;
-
-  // clang-format off
-
-  for (; trip_count > 0; --trip_count)
-  {
-    Helper::Apply(function, *first); ++first;
-    Helper::Apply(function, *first); ++first;
-  }
-
-  if(odd_iterations)
-  {
-    Helper::Apply(function, *first);
-  }
-
-  // clang-format on
+  details::EntityForEachRange(first.GetSubView(), first.Index(), last.Index(), function);
 }
 
 ///
@@ -904,6 +2637,8 @@ ALWAYS_INLINE constexpr void EntityForEach(Iterator first, Iterator last, Functi
 /// It is recommended to always use this method for iterating over entities instead manually iterating. It is both safer
 /// and more efficient in many cases.
 ///
+/// Walks the sub view one chunk at a time, the data of the entities in a chunk is contiguous.
+///
 /// @tparam SubViewType The sub view type.
 /// @tparam Function Function to apply at each iteration.
 ///
@@ -913,11 +2648,18 @@ ALWAYS_INLINE constexpr void EntityForEach(Iterator first, Iterator last, Functi
 template<InstanceOfSubView SubViewType, typename Function>
 ALWAYS_INLINE constexpr void EntityForEach(SubViewType&& view, Function&& function)
 {
-  // Obtain optimal iterator type from function arguments
+  // Obtain optimal data types from function arguments
   using FunctionPtr = decltype(&std::remove_cvref_t<Function>::operator());
   using Helper = details::EntityForEachHelper<std::remove_cvref_t<SubViewType>, FunctionPtr>;
 
-  EntityForEach(Helper::begin(view), Helper::end(view), function);
+  const size_t chunk_count = view.ChunkCount();
+
+  for (size_t chunk = 0; chunk < chunk_count; chunk++)
+  {
+    Helper::MarkChanged(view, chunk);
+
+    details::EntityForEachData(Helper::ChunkData(view, chunk), view.ChunkSize(chunk), function);
+  }
 }
 
 ///
@@ -958,12 +2700,308 @@ ALWAYS_INLINE void EntityForEach(Iterator first, Iterator last, Function functio
 template<InstanceOfView ViewType, typename Function>
 ALWAYS_INLINE void EntityForEach(ViewType&& view, Function function)
 {
+  static_assert(details::ViewConstFunction<ViewType, Function>, "Components declared const cannot be modified");
+
   for (auto&& sub_view : std::forward<ViewType>(view))
   {
     EntityForEach(sub_view, function);
   }
 }
 
+///
+/// Iterates over every chunk of the sub view. For each chunk, the given function is invoked once with spans over the
+/// data of every entity in the chunk.
+///
+/// The function takes a std::span<Component> for every component it modifies, a std::span<const Component> for every
+/// component it only reads and optionally a std::span<const Entity>. All spans have the same size. Every span starts on
+/// a Storage::cChunkAlignment boundary and every chunk but the last of the sub view is full, which lets the loops
+/// over the spans be vectorized with aligned loads.
+///
+/// Components taken as mutable spans are marked as changed for the whole chunk.
+///
+/// @tparam SubViewType The sub view type.
+/// @tparam Function Function to apply to every chunk.
+///
+/// @param[in] view The sub view to iterate.
+/// @param[in] function The function object to apply to every chunk.
+///
+template<InstanceOfSubView SubViewType, typename Function>
+void EntityForEachSpan(SubViewType&& view, Function&& function)
+{
+  using FunctionPtr = decltype(&std::remove_cvref_t<Function>::operator());
+  using Helper = details::EntityForEachSpanHelper<FunctionPtr>;
+
+  const size_t chunk_count = view.ChunkCount();
+
+  for (size_t chunk = 0; chunk < chunk_count; chunk++)
+  {
+    Helper::Apply(view, chunk, function);
+  }
+}
+
+///
+/// Iterates over every chunk of the view. For each chunk, the given function is invoked once with spans over the data
+/// of every entity in the chunk.
+///
+/// @see EntityForEachSpan for sub views.
+///
+/// @tparam ViewType The view type.
+/// @tparam Function Function to apply to every chunk.
+///
+/// @param[in] view The view to iterate.
+/// @param[in] function The function object to apply to every chunk.
+///
+template<InstanceOfView ViewType, typename Function>
+void EntityForEachSpan(ViewType&& view, Function function)
+{
+  static_assert(details::ViewConstFunction<ViewType, Function>, "Components declared const cannot be modified");
+
+  for (auto&& sub_view : std::forward<ViewType>(view))
+  {
+    EntityForEachSpan(sub_view, function);
+  }
+}
+
+///
+/// Filter for the entities whose component was changed after a tick.
+///
+/// Changes are tracked per chunk. Mutably accessing the component of any entity marks the component of every entity in
+/// the same chunk as changed, so the filter can visit entities that were not changed but never misses one that was.
+///
+/// @tparam Component The component type to check for changes.
+///
+template<typename Component>
+struct Changed
+{
+  static_assert(!std::is_empty_v<Component>, "Empty components are not tracked");
+
+  Tick since;
+};
+
+///
+/// Filter for the entities whose component was added after a tick. Added components are tracked per entity.
+///
+/// @tparam Component The component type to check for additions.
+///
+template<typename Component>
+struct Added
+{
+  static_assert(!std::is_empty_v<Component>, "Empty components are not tracked");
+
+  Tick since;
+};
+
+///
+/// Iterates over every entity of the sub view whose component was changed after the since tick of the filter. For each
+/// entity, its components will be unpacked and the given function will be invoked.
+///
+/// Chunks that were not changed are skipped entirely.
+///
+/// @tparam SubViewType The sub view type.
+/// @tparam Component The component type to check for changes.
+/// @tparam Function Function to apply at each iteration.
+///
+/// @param[in] view The sub view to iterate.
+/// @param[in] filter Changed filter.
+/// @param[in] function The function object to apply at every iteration.
+///
+template<InstanceOfSubView SubViewType, typename Component, typename Function>
+void EntityForEach(SubViewType&& view, const Changed<Component> filter, Function&& function)
+{
+  using FunctionPtr = decltype(&std::remove_cvref_t<Function>::operator());
+  using Helper = details::EntityForEachHelper<std::remove_cvref_t<SubViewType>, FunctionPtr>;
+
+  const size_t chunk_count = view.ChunkCount();
+
+  for (size_t chunk = 0; chunk < chunk_count; chunk++)
+  {
+    if (!IsNewerTick(view.template ChunkChangedTick<Component>(chunk), filter.since)) continue;
+
+    Helper::MarkChanged(view, chunk);
+
+    details::EntityForEachData(Helper::ChunkData(view, chunk), view.ChunkSize(chunk), function);
+  }
+}
+
+///
+/// Iterates over every entity of the sub view whose component was added after the since tick of the filter. For each
+/// entity, its components will be unpacked and the given function will be invoked.
+///
+/// Chunks without any added component are skipped entirely, other chunks are iterated in runs of added entities.
+///
+/// @tparam SubViewType The sub view type.
+/// @tparam Component The component type to check for additions.
+/// @tparam Function Function to apply at each iteration.
+///
+/// @param[in] view The sub view to iterate.
+/// @param[in] filter Added filter.
+/// @param[in] function The function object to apply at every iteration.
+///
+template<InstanceOfSubView SubViewType, typename Component, typename Function>
+void EntityForEach(SubViewType&& view, const Added<Component> filter, Function&& function)
+{
+  using FunctionPtr = decltype(&std::remove_cvref_t<Function>::operator());
+  using Helper = details::EntityForEachHelper<std::remove_cvref_t<SubViewType>, FunctionPtr>;
+
+  const size_t chunk_count = view.ChunkCount();
+
+  for (size_t chunk = 0; chunk < chunk_count; chunk++)
+  {
+    if (!IsNewerTick(view.template ChunkAddedTick<Component>(chunk), filter.since)) continue;
+
+    Helper::MarkChanged(view, chunk);
+
+    const Tick* ticks = view.template ChunkAddedTicks<Component>(chunk);
+    const size_t size = view.ChunkSize(chunk);
+
+    size_t first = 0;
+
+    while (first < size)
+    {
+      if (!IsNewerTick(ticks[first], filter.since))
+      {
+        ++first;
+        continue;
+      }
+
+      size_t last = first + 1;
+
+      while (last < size && IsNewerTick(ticks[last], filter.since)) ++last;
+
+      auto data = Helper::ChunkData(view, chunk);
+      details::AdvanceData(data, static_cast<ptrdiff_t>(first));
+
+      details::EntityForEachData(data, last - first, function);
+
+      first = last;
+    }
+  }
+}
+
+///
+/// Iterates over every entity of the view whose component was changed after the since tick of the filter. For each
+/// entity, its components will be unpacked and the given function will be invoked.
+///
+/// @tparam ViewType The view type.
+/// @tparam Component The component type to check for changes.
+/// @tparam Function Function to apply at each iteration.
+///
+/// @param[in] view The view to iterate.
+/// @param[in] filter Changed filter.
+/// @param[in] function The function object to apply at every iteration.
+///
+template<InstanceOfView ViewType, typename Component, typename Function>
+void EntityForEach(ViewType&& view, const Changed<Component> filter, Function function)
+{
+  static_assert(details::ViewConstFunction<ViewType, Function>, "Components declared const cannot be modified");
+
+  for (auto&& sub_view : std::forward<ViewType>(view))
+  {
+    EntityForEach(sub_view, filter, function);
+  }
+}
+
+///
+/// Iterates over every entity of the view whose component was added after the since tick of the filter. For each
+/// entity, its components will be unpacked and the given function will be invoked.
+///
+/// @tparam ViewType The view type.
+/// @tparam Component The component type to check for additions.
+/// @tparam Function Function to apply at each iteration.
+///
+/// @param[in] view The view to iterate.
+/// @param[in] filter Added filter.
+/// @param[in] function The function object to apply at every iteration.
+///
+template<InstanceOfView ViewType, typename Component, typename Function>
+void EntityForEach(ViewType&& view, const Added<Component> filter, Function function)
+{
+  static_assert(details::ViewConstFunction<ViewType, Function>, "Components declared const cannot be modified");
+
+  for (auto&& sub_view : std::forward<ViewType>(view))
+  {
+    EntityForEach(sub_view, filter, function);
+  }
+}
+
+///
+/// Iterates over every entity of the snapshot view. For each entity, its components will be unpacked and the given
+/// function will be invoked.
+///
+/// @tparam Components Constant component types of the view.
+/// @tparam Function Function to apply at each iteration, takes the components by value or by constant reference.
+///
+/// @param[in] view The snapshot view to iterate.
+/// @param[in] function The function object to apply at every iteration.
+///
+template<typename... Components, typename Function>
+void EntityForEach(const SnapshotView<Components...>& view, Function&& function)
+{
+  static_assert(details::ReadOnlyEntityFunction<Function>, "Components of a snapshot cannot be modified");
+
+  EntityForEach(view.view_, std::forward<Function>(function));
+}
+
+///
+/// Default amount of entities a single task iterates when iterating in parallel.
+///
+constexpr size_t cDefaultParallelGrainSize = 4096;
+
+///
+/// Iterates over every entity of the view in parallel on the thread pool. For each entity, its components will be
+/// unpacked and the given function will be invoked.
+///
+/// Every sub view is split into contiguous ranges of at least the grain size, rounded up to whole chunks, and each
+/// range is executed as a separate task on the pool. Views with no more entities than the grain size are iterated
+/// serially on the awaiting thread.
+///
+/// @warning
+///     The function is invoked concurrently from multiple threads. It must not write to shared state without
+///     synchronization, and the view must not be modified until the returned task completes.
+///
+/// @tparam ViewType The view type.
+/// @tparam Function Function to apply at each iteration.
+///
+/// @param[in] view The view to iterate.
+/// @param[in] pool Thread pool to execute on.
+/// @param[in] function The function object to apply at every iteration.
+/// @param[in] grain_size Minimum amount of entities iterated by a single task.
+///
+/// @return Task that completes when every entity was iterated.
+///
+template<InstanceOfView ViewType, typename Function>
+Task<> ParallelEntityForEach(
+  ViewType view, ThreadPool& pool, Function function, const size_t grain_size = cDefaultParallelGrainSize)
+{
+  static_assert(details::ViewConstFunction<ViewType, Function>, "Components declared const cannot be modified");
+
+  ASSERT(grain_size > 0, "Grain size cannot be zero");
+
+  if (view.Size() <= grain_size || pool.ThreadCount() == 1)
+  {
+    EntityForEach(view, function);
+    co_return;
+  }
+
+  Vector<Task<>> tasks;
+
+  for (auto&& sub_view : view)
+  {
+    const size_t size = sub_view.Size();
+    const size_t capacity = sub_view.ChunkCapacity();
+    const size_t range = (grain_size + capacity - 1) & ~(capacity - 1);
+
+    for (size_t first = 0; first < size; first += range)
+    {
+      const size_t last = std::min(first + range, size);
+
+      tasks.push_back(details::ParallelEntityForEachRange(pool, sub_view, first, last, function));
+    }
+  }
+
+  co_await WhenAll(std::move(tasks));
+}
+
 } // namespace plex
 
 #endif
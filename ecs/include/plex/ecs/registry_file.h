@@ -0,0 +1,80 @@
+#ifndef PLEX_ECS_REGISTRY_FILE_H
+#define PLEX_ECS_REGISTRY_FILE_H
+
+#include <cstdint>
+
+namespace plex::details
+{
+///
+/// Binary file format of a registry, written by Registry::Save and read by Registry::Load.
+///
+/// A file starts with its metadata: the header, the recycled entities, the component table with the names of the
+/// components and the archetype records. Every archetype record is followed by the indices of its components in the
+/// component table and by the layout of its component arrays in a chunk.
+///
+/// The chunks of every archetype come after the metadata, as raw images of the chunks of the storages. Each chunk
+/// starts on a multiple of the chunk alignment, so a memory mapped snapshot can be used in place by the storages.
+///
+/// Every offset is relative to the start of the snapshot. The snapshot uses the byte order of the machine.
+///
+
+inline constexpr uint64_t cRegistryFileMagic = 0x50414E5358454C50; // "PLEXSNAP"
+inline constexpr uint32_t cRegistryFileVersion = 1;
+
+///
+/// Header of a snapshot.
+///
+struct RegistryFileHeader
+{
+  uint64_t magic;
+  uint32_t version;
+  uint32_t entity_size;
+  uint32_t generation_bits;
+  uint32_t tick;
+  uint64_t generated; // Amount of entity identifiers generated by the entity manager
+  uint64_t recycled; // Amount of recycled entities, they follow the header
+  uint64_t components; // Offset of the component table
+  uint64_t component_count;
+  uint64_t archetypes; // Offset of the first archetype record
+  uint64_t archetype_count;
+};
+
+///
+/// Entry of the component table.
+///
+struct RegistryFileComponent
+{
+  uint64_t name; // Offset of the name
+  uint64_t name_size;
+  uint64_t size; // Size of the component, 0 for empty components
+  uint64_t alignment;
+};
+
+///
+/// Record of an archetype.
+///
+struct RegistryFileArchetype
+{
+  uint64_t size; // Amount of entities
+  uint64_t component_count; // Amount of component indices that follow the record
+  uint64_t array_count; // Amount of component arrays that follow the component indices
+  uint64_t chunks; // Offset of the first chunk
+  uint64_t chunk_count;
+  uint64_t chunk_capacity;
+  uint64_t chunk_bytes;
+  uint64_t chunk_alignment;
+  uint64_t chunk_stride; // Distance between two chunks, the chunk size rounded up to the chunk alignment
+};
+
+///
+/// Layout of a component array in a chunk.
+///
+struct RegistryFileArray
+{
+  uint64_t component; // Index in the component table
+  uint64_t offset; // Offset of the component array in a chunk
+  uint64_t ticks; // Offset of the tick array in a chunk
+};
+} // namespace plex::details
+
+#endif
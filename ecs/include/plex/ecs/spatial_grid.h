@@ -0,0 +1,507 @@
+#ifndef PLEX_ECS_SPATIAL_GRID_H
+#define PLEX_ECS_SPATIAL_GRID_H
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <span>
+#include <utility>
+
+#include "plex/containers/vector.h"
+#include "plex/debug/assertion.h"
+#include "plex/ecs/registry.h"
+#include "plex/math/vec3.h"
+
+namespace plex
+{
+///
+/// Spatial index over the position component of the entities, a uniform grid whose cells are hashed into buckets.
+///
+/// Every entity of the index is stored with a copy of its position in the bucket of the cell that contains it. Queries
+/// only visit the buckets of the cells they overlap and test contiguous positions, without accessing the registry.
+/// Distinct cells can share a bucket, collisions only cost extra tests since the positions are always checked.
+///
+/// The index is updated incrementally, see Update. Entities that stop having the component are removed from the index
+/// when the observers of the registry are flushed, until then queries can still return them. Entities whose position
+/// is not finite are not indexed.
+///
+/// @note The cell size should be around the typical query radius. Smaller cells make queries visit more buckets, larger
+/// cells make queries test more positions.
+///
+/// @warning The registry must outlive the grid.
+///
+/// @tparam Component The component that holds the position of the entities.
+/// @tparam Projection Invocable or member pointer that returns the position of a component, convertible to float3.
+///
+template<typename Component, typename Projection = std::identity>
+class SpatialGrid
+{
+public:
+  ///
+  /// Constructor. Builds the index from every entity that has the component.
+  ///
+  /// @param[in] registry Registry of the entities to index.
+  /// @param[in] cell_size Size of the cells of the grid.
+  /// @param[in] projection Projection from the component to its position.
+  ///
+  SpatialGrid(Registry& registry, const float cell_size, Projection projection = {})
+    : registry_(registry), projection_(std::move(projection)), inverse_cell_size_(1.0f / cell_size), size_(0),
+      last_update_(0)
+  {
+    ASSERT(cell_size > 0, "Cell size must be positive");
+
+    Observers<Entity>::Handler handler;
+    handler.template Bind<SpatialGrid, &SpatialGrid::OnRemoved>(this);
+
+    observer_ = registry_.template OnRemove<Component>(handler);
+
+    Rebuild();
+  }
+
+  ///
+  /// Destructor.
+  ///
+  ~SpatialGrid()
+  {
+    registry_.Unobserve(observer_);
+  }
+
+  SpatialGrid(const SpatialGrid&) = delete;
+  SpatialGrid(SpatialGrid&&) = delete;
+  SpatialGrid& operator=(const SpatialGrid&) = delete;
+  SpatialGrid& operator=(SpatialGrid&&) = delete;
+
+  ///
+  /// Rebuilds the index from every entity that has the component.
+  ///
+  /// Also resizes the bucket table to the amount of entities. Prefer Update when only some of the positions changed.
+  ///
+  void Rebuild()
+  {
+    const auto view = registry_.template ViewFor<const Component>();
+
+    buckets_.clear();
+    buckets_.resize(std::bit_ceil(std::max(view.Size(), cMinBucketCount)));
+
+    locations_.clear();
+    size_ = 0;
+
+    last_update_ = registry_.CurrentTick();
+
+    EntityForEach(view, [this](const Entity entity, const Component& component) { Insert(entity, component); });
+  }
+
+  ///
+  /// Updates the positions of the entities whose component was changed or added since the previous update.
+  ///
+  /// Changes are tracked per chunk, every entity of a chunk whose component was changed is re-read. The tick of the
+  /// registry is left as is. Chunks stamped with the tick of the previous update are re-read as well, so that changes
+  /// made later in the same tick are not missed, advancing the tick between updates avoids re-reading them.
+  ///
+  void Update()
+  {
+    // Changes stamped with the tick of the previous update may have happened after it
+    const Tick since = last_update_ - 1;
+
+    last_update_ = registry_.CurrentTick();
+
+    const auto insert = [this](const Entity entity, const Component& component) { Insert(entity, component); };
+
+    for (auto&& sub_view : registry_.template ViewFor<const Component>())
+    {
+      const size_t capacity = sub_view.ChunkCapacity();
+      const size_t chunk_count = sub_view.ChunkCount();
+
+      for (size_t chunk = 0; chunk < chunk_count; chunk++)
+      {
+        if (!IsNewerTick(sub_view.template ChunkChangedTick<Component>(chunk), since)
+            && !IsNewerTick(sub_view.template ChunkAddedTick<Component>(chunk), since))
+        {
+          continue;
+        }
+
+        const size_t first = chunk * capacity;
+
+        details::EntityForEachRange(sub_view, first, first + sub_view.ChunkSize(chunk), insert);
+      }
+    }
+
+    if (size_ > buckets_.size() * cMaxLoadFactor) Rehash(buckets_.size() * 2);
+  }
+
+  ///
+  /// Returns the entities whose position is inside the box.
+  ///
+  /// @param[in] min Minimum corner of the box.
+  /// @param[in] max Maximum corner of the box.
+  ///
+  /// @return Span of the entities, valid until the next query or update.
+  ///
+  [[nodiscard]] std::span<const Entity> QueryAABB(const float3& min, const float3& max)
+  {
+    results_.clear();
+
+    QueryAABB(min, max, results_);
+
+    return results_;
+  }
+
+  ///
+  /// Appends the entities whose position is inside the box to the results.
+  ///
+  /// @note Safe to call from multiple threads with different results, as long as the grid is not updated.
+  ///
+  /// @param[in] min Minimum corner of the box.
+  /// @param[in] max Maximum corner of the box.
+  /// @param[out] results Vector to append the entities to.
+  ///
+  void QueryAABB(const float3& min, const float3& max, Vector<Entity>& results) const
+  {
+    Query(min,
+      max,
+      [&](const float3& position)
+      {
+        return position.x >= min.x && position.y >= min.y && position.z >= min.z && position.x <= max.x
+            && position.y <= max.y && position.z <= max.z;
+      },
+      results);
+  }
+
+  ///
+  /// Returns the entities whose position is inside the sphere.
+  ///
+  /// @param[in] center Center of the sphere.
+  /// @param[in] radius Radius of the sphere.
+  ///
+  /// @return Span of the entities, valid until the next query or update.
+  ///
+  [[nodiscard]] std::span<const Entity> QueryRadius(const float3& center, const float radius)
+  {
+    results_.clear();
+
+    QueryRadius(center, radius, results_);
+
+    return results_;
+  }
+
+  ///
+  /// Appends the entities whose position is inside the sphere to the results.
+  ///
+  /// @note Safe to call from multiple threads with different results, as long as the grid is not updated.
+  ///
+  /// @param[in] center Center of the sphere.
+  /// @param[in] radius Radius of the sphere.
+  /// @param[out] results Vector to append the entities to.
+  ///
+  void QueryRadius(const float3& center, const float radius, Vector<Entity>& results) const
+  {
+    const float squared_radius = radius * radius;
+
+    Query(center - radius,
+      center + radius,
+      [&](const float3& position)
+      {
+        const float3 offset = position - center;
+
+        return offset.x * offset.x + offset.y * offset.y + offset.z * offset.z <= squared_radius;
+      },
+      results);
+  }
+
+  ///
+  /// Returns whether or not the entity is in the index.
+  ///
+  /// @param[in] entity Entity to find.
+  ///
+  /// @return True if the entity is in the index, false otherwise.
+  ///
+  [[nodiscard]] bool Contains(const Entity entity) const noexcept
+  {
+    return Find(entity) != nullptr;
+  }
+
+  ///
+  /// Returns the amount of entities in the index.
+  ///
+  /// @return Amount of entities.
+  ///
+  [[nodiscard]] size_t Size() const noexcept
+  {
+    return size_;
+  }
+
+private:
+  ///
+  /// Entity of the index with a copy of its position.
+  ///
+  struct Entry
+  {
+    float3 position;
+    Entity entity;
+  };
+
+  ///
+  /// Location of the entry of an entity, indexed by the index of the entity.
+  ///
+  struct Location
+  {
+    uint32_t bucket;
+    uint32_t slot;
+  };
+
+  ///
+  /// Integer coordinates of a cell.
+  ///
+  struct Cell
+  {
+    int32_t x, y, z;
+
+    [[nodiscard]] constexpr bool operator==(const Cell&) const noexcept = default;
+  };
+
+  ///
+  /// Returns the cell that contains the position. Coordinates are clamped to keep far positions representable, NaN
+  /// coordinates are in the cell at zero.
+  ///
+  /// @param[in] position Position to get cell for.
+  ///
+  /// @return Cell of the position.
+  ///
+  [[nodiscard]] Cell CellOf(const float3& position) const noexcept
+  {
+    const auto coordinate = [this](const float value)
+    {
+      const float scaled = value * inverse_cell_size_;
+
+      if (std::isnan(scaled)) [[unlikely]] return int32_t { 0 };
+
+      return static_cast<int32_t>(std::floor(std::clamp(scaled, -cMaxCoordinate, cMaxCoordinate)));
+    };
+
+    return { coordinate(position.x), coordinate(position.y), coordinate(position.z) };
+  }
+
+  ///
+  /// Returns the bucket of the cell.
+  ///
+  /// @param[in] cell Cell to get bucket for.
+  ///
+  /// @return Index of the bucket.
+  ///
+  [[nodiscard]] uint32_t BucketOf(const Cell cell) const noexcept
+  {
+    const uint32_t hash = (static_cast<uint32_t>(cell.x) * 73856093u) ^ (static_cast<uint32_t>(cell.y) * 19349663u)
+                        ^ (static_cast<uint32_t>(cell.z) * 83492791u);
+
+    return hash & static_cast<uint32_t>(buckets_.size() - 1);
+  }
+
+  ///
+  /// Returns the location of the entity, or null if the entity is not in the index.
+  ///
+  /// @param[in] entity Entity to find.
+  ///
+  /// @return Pointer to the location of the entity.
+  ///
+  [[nodiscard]] const Location* Find(const Entity entity) const noexcept
+  {
+    const size_t index = EntityTraits<Entity>::Index(entity);
+
+    if (index >= locations_.size()) return nullptr;
+
+    const Location& location = locations_[index];
+
+    if (location.bucket == cInvalidBucket || buckets_[location.bucket][location.slot].entity != entity) return nullptr;
+
+    return &location;
+  }
+
+  ///
+  /// Inserts the entity in the index, or updates its position if it is already in the index. An entity that recycled
+  /// the index of the entity replaces it. Entities whose position is not finite are erased from the index instead.
+  ///
+  /// @param[in] entity Entity to insert.
+  /// @param[in] component Component of the entity.
+  ///
+  void Insert(const Entity entity, const Component& component)
+  {
+    const float3 position = std::invoke(projection_, component);
+
+    const size_t index = EntityTraits<Entity>::Index(entity);
+
+    if (index >= locations_.size()) locations_.resize(index + 1, Location { cInvalidBucket, 0 });
+
+    Location& location = locations_[index];
+
+    if (!std::isfinite(position.x) || !std::isfinite(position.y) || !std::isfinite(position.z)) [[unlikely]]
+    {
+      if (location.bucket != cInvalidBucket) Erase(location);
+      return;
+    }
+
+    const uint32_t bucket = BucketOf(CellOf(position));
+
+    if (location.bucket == bucket)
+    {
+      buckets_[bucket][location.slot] = { position, entity };
+      return;
+    }
+
+    if (location.bucket != cInvalidBucket) Erase(location);
+
+    location = { bucket, static_cast<uint32_t>(buckets_[bucket].size()) };
+
+    buckets_[bucket].push_back({ position, entity });
+    ++size_;
+  }
+
+  ///
+  /// Erases the entry at the location, the location becomes invalid.
+  ///
+  /// @param[in] location Location of the entry to erase.
+  ///
+  void Erase(Location& location)
+  {
+    Vector<Entry>& entries = buckets_[location.bucket];
+
+    if (location.slot != entries.size() - 1)
+    {
+      locations_[EntityTraits<Entity>::Index(entries.back().entity)].slot = location.slot;
+    }
+
+    entries.SwapAndPop(entries.begin() + location.slot);
+    location.bucket = cInvalidBucket;
+
+    --size_;
+  }
+
+  ///
+  /// Changes the amount of buckets, redistributing the entries.
+  ///
+  /// @param[in] bucket_count New amount of buckets, a power of two.
+  ///
+  void Rehash(const size_t bucket_count)
+  {
+    Vector<Vector<Entry>> buckets;
+    buckets.resize(bucket_count);
+
+    buckets_.swap(buckets);
+
+    for (const Vector<Entry>& entries : buckets)
+    {
+      for (const Entry& entry : entries)
+      {
+        const uint32_t bucket = BucketOf(CellOf(entry.position));
+
+        const uint32_t slot = static_cast<uint32_t>(buckets_[bucket].size());
+
+        locations_[EntityTraits<Entity>::Index(entry.entity)] = { bucket, slot };
+
+        buckets_[bucket].push_back(entry);
+      }
+    }
+  }
+
+  ///
+  /// Appends the entities in the box that pass the test to the results.
+  ///
+  /// Visits the bucket of every cell overlapping the box, an entry is only taken from the bucket of its own cell so
+  /// that cells sharing a bucket do not produce duplicates. Boxes overlapping more cells than there are buckets visit
+  /// every bucket once instead.
+  ///
+  /// @tparam Test Type of the test.
+  ///
+  /// @param[in] min Minimum corner of the box.
+  /// @param[in] max Maximum corner of the box.
+  /// @param[in] test Test of the positions in the box.
+  /// @param[out] results Vector to append the entities to.
+  ///
+  template<typename Test>
+  void Query(const float3& min, const float3& max, const Test& test, Vector<Entity>& results) const
+  {
+    const Cell first = CellOf(min);
+    const Cell last = CellOf(max);
+
+    if (first.x > last.x || first.y > last.y || first.z > last.z) return;
+
+    // Clamped coordinates span up to 2^31 cells per axis, the count is computed in 64 bits and stops growing once it
+    // exceeds the amount of buckets
+    const auto span = [](const int32_t from, const int32_t to)
+    { return static_cast<uint64_t>(int64_t { to } - from) + 1; };
+
+    uint64_t cell_count = span(first.x, last.x) * span(first.y, last.y);
+
+    if (cell_count <= buckets_.size()) cell_count *= span(first.z, last.z);
+
+    if (cell_count > buckets_.size())
+    {
+      for (const Vector<Entry>& entries : buckets_)
+      {
+        for (const Entry& entry : entries)
+        {
+          if (test(entry.position)) results.push_back(entry.entity);
+        }
+      }
+
+      return;
+    }
+
+    for (int32_t z = first.z; z <= last.z; z++)
+    {
+      for (int32_t y = first.y; y <= last.y; y++)
+      {
+        for (int32_t x = first.x; x <= last.x; x++)
+        {
+          const Cell cell { x, y, z };
+
+          for (const Entry& entry : buckets_[BucketOf(cell)])
+          {
+            if (test(entry.position) && CellOf(entry.position) == cell) results.push_back(entry.entity);
+          }
+        }
+      }
+    }
+  }
+
+  ///
+  /// Removes the entities that stopped having the component from the index.
+  ///
+  /// @param[in] entities Entities that stopped having the component.
+  ///
+  void OnRemoved(std::span<const Entity> entities)
+  {
+    const auto view = registry_.template ViewFor<const Component>();
+
+    for (const Entity entity : entities)
+    {
+      if (!Find(entity) || view.Contains(entity)) continue;
+
+      Erase(locations_[EntityTraits<Entity>::Index(entity)]);
+    }
+  }
+
+private:
+  static constexpr size_t cMinBucketCount = 64;
+  static constexpr size_t cMaxLoadFactor = 2;
+  static constexpr uint32_t cInvalidBucket = std::numeric_limits<uint32_t>::max();
+  static constexpr float cMaxCoordinate = static_cast<float>(1 << 30);
+
+  Registry& registry_;
+  Projection projection_;
+  float inverse_cell_size_;
+
+  Vector<Vector<Entry>> buckets_;
+  Vector<Location> locations_;
+  size_t size_;
+
+  Tick last_update_;
+  ObserverId observer_;
+
+  Vector<Entity> results_;
+};
+} // namespace plex
+
+#endif
@@ -1,10 +1,20 @@
 #ifndef PLEX_ECS_STORAGE_H
 #define PLEX_ECS_STORAGE_H
 
-#include "plex/containers/type_map.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <new>
+#include <span>
+#include <tuple>
+#include <utility>
+
 #include "plex/containers/vector.h"
-#include "plex/utilities/erased_ptr.h"
+#include "plex/ecs/archetype.h"
+#include "plex/ecs/entity_manager.h"
 #include "plex/utilities/memory.h"
+#include "plex/utilities/ref.h"
 #include "plex/utilities/type_info.h"
 
 namespace plex
@@ -18,27 +28,40 @@ namespace plex
 /// reduce memory usage. For example, if there are 10 archetypes, sharing the sparse array could save up to 9 times the
 /// lookup table memory, making it more cache friendly.
 ///
+/// The array is indexed with the index part of the entity and every mapping also stores the generation of the entity
+/// it was assigned for. This is enough to tell whether an entity identifier is still alive with a single load.
+///
+/// Next to the index, every mapping records the archetype of the storage that owns the entity. Finding the storage of
+/// an entity is then a single lookup, no matter how many storages share the sparse array.
+///
+/// Mappings are stored in fixed-size pages that are allocated the first time one of their entities is assured. Pages
+/// that were never assured all point to the same shared page of invalid mappings, so lookups never check for missing
+/// pages. Pages never move once allocated, and memory follows the ranges of identifiers in use rather than the largest
+/// identifier.
+///
 /// @tparam Entity The type of entity to use.
-/// @tparam AllocatorImpl Allocator to allocate memory with.
 ///
 template<std::unsigned_integral Entity>
 class SharedSparseArray
 {
 public:
+  static constexpr size_t cPageShift = 12;
+  static constexpr size_t cPageSize = size_t { 1 } << cPageShift; // Mappings per page
+
   ///
   /// Constructor.
   ///
-  constexpr SharedSparseArray() noexcept : capacity_(32)
-  {
-    array_ = static_cast<Entity*>(std::malloc(sizeof(Entity) * capacity_));
-  }
+  SharedSparseArray() noexcept = default;
 
   ///
   /// Destructor.
   ///
   ~SharedSparseArray()
   {
-    std::free(array_);
+    for (auto page : pages_)
+    {
+      if (page != SharedPage()) std::free(page);
+    }
   }
 
   SharedSparseArray(const SharedSparseArray&) = delete;
@@ -53,13 +76,85 @@ public:
   ///
   void Assure(const Entity entity) noexcept
   {
-    if (entity >= capacity_) [[unlikely]]
+    const size_t page = Traits::Index(entity) >> cPageShift;
+
+    if (page >= pages_.size() || pages_[page] == SharedPage()) [[unlikely]]
+    {
+      AllocatePage(page);
+    }
+  }
+
+  ///
+  /// Assures that every entity with an index in the range can be mapped in the sparse array.
+  ///
+  /// @param[in] first First entity of the range.
+  /// @param[in] last Last entity of the range, inclusive.
+  ///
+  void Assure(const Entity first, const Entity last) noexcept
+  {
+    ASSERT(Traits::Index(first) <= Traits::Index(last), "Invalid range");
+
+    for (size_t page = Traits::Index(first) >> cPageShift; page <= (Traits::Index(last) >> cPageShift); ++page)
     {
-      capacity_ += static_cast<uint32_t>(entity); // Growth < factor 2
-      array_ = static_cast<Entity*>(std::realloc(array_, capacity_ * sizeof(Entity)));
+      if (page >= pages_.size() || pages_[page] == SharedPage()) AllocatePage(page);
     }
   }
 
+  ///
+  /// Maps the entity to the index. The generation of the entity is stored along with the index.
+  ///
+  /// @param[in] entity Entity to map.
+  /// @param[in] index Index to map the entity to.
+  /// @param[in] archetype Archetype of the storage that owns the entity.
+  ///
+  constexpr void Assign(const Entity entity, const Entity index, const ArchetypeId archetype = 0) noexcept
+  {
+    ASSERT(Assured(entity) && pages_[Traits::Index(entity) >> cPageShift] != SharedPage(), "Entity not assured");
+
+    At(entity) = { static_cast<uint32_t>(Traits::Combine(index, Traits::Generation(entity))),
+      static_cast<uint32_t>(archetype) };
+  }
+
+  ///
+  /// Removes the mapping of the entity. The entity will not be valid anymore.
+  ///
+  /// @param[in] entity Entity to invalidate.
+  ///
+  constexpr void Invalidate(const Entity entity) noexcept
+  {
+    ASSERT(Assured(entity) && pages_[Traits::Index(entity) >> cPageShift] != SharedPage(), "Entity not assured");
+
+    At(entity).index = static_cast<uint32_t>(Traits::Combine(Traits::cIndexMask, Traits::Generation(entity) + 1));
+  }
+
+  ///
+  /// Checks whether or not the entity is mapped with the same generation.
+  ///
+  /// @param[in] entity Entity to check.
+  ///
+  /// @return True if the entity is mapped, false if it was never mapped or invalidated.
+  ///
+  [[nodiscard]] constexpr bool Valid(const Entity entity) const noexcept
+  {
+    if (!Assured(entity)) return false;
+
+    const Entity mapping = At(entity).index;
+
+    return Traits::Index(mapping) != Traits::cIndexMask && Traits::Generation(mapping) == Traits::Generation(entity);
+  }
+
+  ///
+  /// Checks whether or not the index of the entity is within the capacity of the sparse array.
+  ///
+  /// @param[in] entity Entity to check.
+  ///
+  /// @return True if the entity can be looked up, false otherwise.
+  ///
+  [[nodiscard]] constexpr bool Assured(const Entity entity) const noexcept
+  {
+    return (Traits::Index(entity) >> cPageShift) < pages_.size();
+  }
+
   ///
   /// Const array access operator.
   ///
@@ -69,19 +164,22 @@ public:
   ///
   [[nodiscard]] constexpr Entity operator[](const Entity entity) const noexcept
   {
-    return array_[entity];
+    return Traits::Index(At(entity).index);
   }
 
   ///
-  /// Array access operator.
+  /// Returns the archetype of the storage that owns the entity.
   ///
-  /// @param[in] entity Entity to access the index for.
+  /// @warning
+  ///    The entity must be mapped, otherwise the returned archetype is meaningless.
   ///
-  /// @return Entity index.
+  /// @param[in] entity Entity to access the archetype for.
+  ///
+  /// @return Archetype identifier.
   ///
-  [[nodiscard]] constexpr Entity& operator[](const Entity entity) noexcept
+  [[nodiscard]] constexpr ArchetypeId Archetype(const Entity entity) const noexcept
   {
-    return array_[entity];
+    return At(entity).archetype;
   }
 
   ///
@@ -91,20 +189,357 @@ public:
   ///
   [[nodiscard]] constexpr size_t Capacity() const noexcept
   {
-    return capacity_;
+    return pages_.size() << cPageShift;
+  }
+
+  ///
+  /// Returns the amount of pages that are allocated. Pages that were never assured are not counted.
+  ///
+  /// @return Amount of allocated pages.
+  ///
+  [[nodiscard]] size_t AllocatedPages() const noexcept
+  {
+    return static_cast<size_t>(std::ranges::count_if(pages_, [](auto page) { return page != SharedPage(); }));
+  }
+
+private:
+  using Traits = EntityTraits<Entity>;
+
+  ///
+  /// Mapping of an entity. The index and generation always fit in 32 bits, see EntityTraits.
+  ///
+  struct Mapping
+  {
+    uint32_t index;
+    uint32_t archetype;
+  };
+
+  static constexpr Mapping cInvalid = { static_cast<uint32_t>(Traits::cIndexMask), 0 }; // Invalid index of generation 0
+
+  static constexpr std::array<Mapping, cPageSize> cInvalidPage = []()
+  {
+    std::array<Mapping, cPageSize> page;
+    page.fill(cInvalid);
+    return page;
+  }();
+
+  ///
+  /// Returns the page shared by every page that was never assured.
+  ///
+  /// @note The shared page is never written to.
+  ///
+  /// @return Shared page of invalid mappings.
+  ///
+  [[nodiscard]] static Mapping* SharedPage() noexcept
+  {
+    return const_cast<Mapping*>(cInvalidPage.data());
+  }
+
+  ///
+  /// Returns the mapping of the entity. The page of the entity must be in the page directory.
+  ///
+  /// @param[in] entity Entity to access the mapping for.
+  ///
+  /// @return Mapping of the entity.
+  ///
+  [[nodiscard]] constexpr Mapping& At(const Entity entity) const noexcept
+  {
+    const Entity index = Traits::Index(entity);
+
+    return pages_[index >> cPageShift][index & (cPageSize - 1)];
+  }
+
+  ///
+  /// Allocates the page, growing the page directory if needed.
+  ///
+  /// @param[in] page Index of the page to allocate.
+  ///
+  COLD_SECTION NO_INLINE void AllocatePage(const size_t page) noexcept
+  {
+    if (page >= pages_.size()) pages_.resize(page + 1, SharedPage());
+
+    Mapping* mappings = static_cast<Mapping*>(std::malloc(sizeof(Mapping) * cPageSize));
+
+    std::fill_n(mappings, cPageSize, cInvalid);
+
+    pages_[page] = mappings;
   }
 
 private:
-  Entity* array_;
-  size_t capacity_;
+  Vector<Mapping*> pages_;
+};
+
+///
+/// Tick used to track when components were added or changed.
+///
+using Tick = uint32_t;
+
+///
+/// Returns whether or not the tick is newer than the other tick.
+///
+/// Ticks wrap around, the comparison is correct as long as the ticks are less than 2^31 apart.
+///
+/// @param[in] tick Tick to check.
+/// @param[in] since Tick to compare with.
+///
+/// @return True if the tick is strictly newer, false otherwise.
+///
+[[nodiscard]] constexpr bool IsNewerTick(const Tick tick, const Tick since) noexcept
+{
+  return static_cast<int32_t>(tick - since) > 0;
+}
+
+///
+/// Type erased information about a component type.
+///
+/// Contains everything a storage needs to manage components without knowing the component type. This allows storages
+/// to be created at runtime, for example when an entity moves to an archetype that never existed.
+///
+/// Functions are nullptr when the operation is trivial, this lets storages use a bitwise copy or skip destruction
+/// without an indirect call.
+///
+/// Empty components are never stored, they only take part in the archetype identity. For them, the instance points to
+/// a single shared instance of the component.
+///
+struct ComponentInfo
+{
+  ComponentId id;
+  std::string_view name;
+
+  size_t size;
+  size_t alignment;
+
+  void* empty_instance;
+
+  void (*relocate)(void* source, void* destination);
+  void (*destroy)(void* component);
+  void (*copy)(const void* source, void* destination);
+};
+
+namespace details
+{
+  ///
+  /// Holds the single shared instance of an empty component.
+  ///
+  /// Empty components have no state, so every entity can share the same instance.
+  ///
+  /// @tparam Component Empty component type.
+  ///
+  template<typename Component>
+  requires std::is_empty_v<Component>
+  struct EmptyComponentStorage
+  {
+    static inline Component instance {};
+  };
+
+  ///
+  /// Relocates the component into uninitialized memory.
+  ///
+  /// @tparam Component Component type.
+  ///
+  /// @param[in] source Component to relocate.
+  /// @param[in] destination Uninitialized memory to relocate to.
+  ///
+  template<typename Component>
+  void RelocateComponent(void* source, void* destination)
+  {
+    RelocateAt(static_cast<Component*>(source), static_cast<Component*>(destination));
+  }
+
+  ///
+  /// Destroys the component.
+  ///
+  /// @tparam Component Component type.
+  ///
+  /// @param[in] component Component to destroy.
+  ///
+  template<typename Component>
+  void DestroyComponent(void* component)
+  {
+    static_cast<Component*>(component)->~Component();
+  }
+
+  ///
+  /// Copy constructs the component into uninitialized memory.
+  ///
+  /// @tparam Component Component type.
+  ///
+  /// @param[in] source Component to copy.
+  /// @param[in] destination Uninitialized memory to copy to.
+  ///
+  template<typename Component>
+  void CopyComponent(const void* source, void* destination)
+  {
+    if constexpr (std::is_copy_constructible_v<Component>)
+    {
+      ::new (destination) Component(*static_cast<const Component*>(source));
+    }
+    else
+    {
+      ASSERT(false, "Component is not copy constructible");
+      std::abort();
+    }
+  }
+
+  TYPE_TRAITS_DETECTOR(IsStoredOutOfLine);
+} // namespace details
+
+///
+/// Whether or not the component is stored out of line.
+///
+/// Components stored out of line are allocated on their own and never move, the chunks of the storage only hold a
+/// handle to them. Erasing entities and moving them between archetypes then only moves the handle, no matter how large
+/// the component is. Worth it for very large components (a few KiB) that are rarely iterated all at once, since every
+/// access goes through one more pointer.
+///
+/// @note For a component to be stored out of line, it must either have a specialization for this struct or have a
+/// using tag IsStoredOutOfLine = std::true_type. Empty components are never stored.
+///
+/// @tparam Component Component type to check.
+///
+template<typename Component>
+struct IsStoredOutOfLine
+  : public std::bool_constant<details::Detect_IsStoredOutOfLine<Component> && !std::is_empty_v<Component>>
+{};
+
+///
+/// Handle kept in the chunks in place of a component stored out of line.
+///
+/// @tparam Component Component type stored out of line.
+///
+template<typename Component>
+struct OutOfLineHandle
+{
+  Component* component;
 };
 
+///
+/// Type of the elements in the chunk arrays of the component. Either the component itself or its handle.
+///
+/// @tparam Component Component type.
+///
+template<typename Component>
+using StoredComponent =
+  std::conditional_t<IsStoredOutOfLine<Component>::value, OutOfLineHandle<Component>, Component>;
+
+namespace details
+{
+  ///
+  /// Destroys and frees the component stored out of line.
+  ///
+  /// @tparam Component Component type stored out of line.
+  ///
+  /// @param[in] handle Handle of the component to destroy.
+  ///
+  template<typename Component>
+  void DestroyOutOfLineComponent(void* handle)
+  {
+    delete static_cast<OutOfLineHandle<Component>*>(handle)->component;
+  }
+
+  ///
+  /// Copies the component stored out of line into a new allocation.
+  ///
+  /// @tparam Component Component type stored out of line.
+  ///
+  /// @param[in] source Handle of the component to copy.
+  /// @param[in] destination Uninitialized memory for the handle of the copy.
+  ///
+  template<typename Component>
+  void CopyOutOfLineComponent(const void* source, void* destination)
+  {
+    if constexpr (std::is_copy_constructible_v<Component>)
+    {
+      const Component& component = *static_cast<const OutOfLineHandle<Component>*>(source)->component;
+
+      ::new (destination) OutOfLineHandle<Component> { new Component(component) };
+    }
+    else
+    {
+      ASSERT(false, "Component is not copy constructible");
+      std::abort();
+    }
+  }
+
+  ///
+  /// Concept for the integral keys that storages can be radix sorted by.
+  ///
+  template<typename Type>
+  concept SortKey = std::integral<Type> && !std::same_as<Type, bool>;
+} // namespace details
+
+///
+/// Returns the type erased information about the component type.
+///
+/// @tparam Component Component type to get information for.
+///
+/// @return Pointer to static component information.
+///
+template<typename Component>
+const ComponentInfo* GetComponentInfo()
+{
+  if constexpr (std::is_empty_v<Component>)
+  {
+    static const ComponentInfo info {
+      GetComponentId<Component>(),
+      TypeName<Component>(),
+      0,
+      alignof(Component),
+      &details::EmptyComponentStorage<Component>::instance,
+      nullptr,
+      nullptr,
+      nullptr,
+    };
+
+    return &info;
+  }
+  else if constexpr (IsStoredOutOfLine<Component>::value)
+  {
+    // Only the handle lives in the chunks, it is relocated with a memory copy
+    static const ComponentInfo info {
+      GetComponentId<Component>(),
+      TypeName<Component>(),
+      sizeof(OutOfLineHandle<Component>),
+      alignof(OutOfLineHandle<Component>),
+      nullptr,
+      nullptr,
+      details::DestroyOutOfLineComponent<Component>,
+      details::CopyOutOfLineComponent<Component>,
+    };
+
+    return &info;
+  }
+  else
+  {
+    static const ComponentInfo info {
+      GetComponentId<Component>(),
+      TypeName<Component>(),
+      sizeof(Component),
+      alignof(Component),
+      nullptr,
+      IsTriviallyRelocatable<Component>::value ? nullptr : details::RelocateComponent<Component>,
+      std::is_trivially_destructible_v<Component> ? nullptr : details::DestroyComponent<Component>,
+      std::is_trivially_copyable_v<Component> ? nullptr : details::CopyComponent<Component>,
+    };
+
+    return &info;
+  }
+}
+
 ///
 /// Storage container for a single archetype.
 ///
 /// Basically a sparse set, but optimized for storing extra type erased data, in this case component data.
 ///
-/// Components are stores as SOA, and every component array is dense.
+/// Entities and components are stored in fixed size chunks. Every chunk holds an SOA slice of the archetype: an array
+/// of entities followed by one array per component, each starting on a cache line. Chunks are never reallocated, so
+/// inserting only ever allocates a single new chunk, and iterating walks one chunk at a time. Chunks are also a natural
+/// unit of work to split between threads.
+///
+/// The chunk capacity is a power of two, an index is split into its chunk and its slot with a shift and a mask.
+///
+/// Empty components are never stored, they only take part in the archetype identity. Components stored out of line
+/// only keep a handle in the chunks, see IsStoredOutOfLine.
 ///
 /// Insertion and erasing is constant time.
 ///
@@ -116,44 +551,108 @@ template<std::unsigned_integral Entity>
 class Storage
 {
 public:
+  ///
+  /// Maximum size in bytes of a chunk. Chunks of archetypes with very large components may be bigger.
+  ///
+  static constexpr size_t cChunkSize = 16384;
+
+  ///
+  /// Alignment of every array in a chunk.
+  ///
+  static constexpr size_t cChunkAlignment = 64;
+
+  ///
+  /// Random access iterator over the entities of the storage.
+  ///
+  class EntityIterator
+  {
+  private:
+    using Self = EntityIterator;
+
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = Entity;
+    using difference_type = ptrdiff_t;
+    using pointer = const Entity*;
+    using reference = const Entity&;
+
+    constexpr EntityIterator() noexcept = default;
+
+    constexpr EntityIterator(const Storage* storage, size_t index) noexcept : storage_(storage), index_(index) {}
+
+    // clang-format off
+
+    constexpr Self& operator+=(difference_type amount) noexcept { index_ += static_cast<size_t>(amount); return *this; }
+    constexpr Self& operator-=(difference_type amount) noexcept { index_ -= static_cast<size_t>(amount); return *this; }
+
+    constexpr Self& operator++() noexcept { return ++index_, *this; }
+    constexpr Self& operator--() noexcept { return --index_, *this; }
+
+    constexpr Self operator++(int) noexcept { Self copy(*this); operator++(); return copy; }
+    constexpr Self operator--(int) noexcept { Self copy(*this); operator--(); return copy; }
+
+    [[nodiscard]] friend constexpr Self operator+(const Self& it, difference_type amount) noexcept
+    { Self tmp = it; tmp += amount; return tmp; }
+    [[nodiscard]] friend constexpr Self operator-(const Self& it, difference_type amount) noexcept
+    { Self tmp = it; tmp -= amount; return tmp; }
+    [[nodiscard]] friend constexpr Self operator+(difference_type amount, const Self& it) noexcept
+    { return it + amount; }
+
+    [[nodiscard]] friend constexpr difference_type operator-(const Self& lhs, const Self& rhs) noexcept
+    {
+      return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+    }
+
+    [[nodiscard]] constexpr reference operator*() const noexcept { return (*storage_)[index_]; }
+    [[nodiscard]] constexpr reference operator[](difference_type index) const noexcept { return *(*this + index); }
+
+    [[nodiscard]] friend constexpr bool operator==(const Self& lhs, const Self& rhs) noexcept
+    {
+      return lhs.index_ == rhs.index_;
+    }
+
+    [[nodiscard]] friend constexpr std::strong_ordering operator<=>(const Self& lhs, const Self& rhs) noexcept
+    {
+      return lhs.index_ <=> rhs.index_;
+    }
+
+    // clang-format on
+
+  private:
+    const Storage* storage_ = nullptr;
+    size_t index_ = 0;
+  };
+
   // Style Exception: STL
   // clang-format off
 
   using size_type = size_t;
 
-  using iterator = Entity*;
-  using const_iterator = const Entity*;
+  using iterator = EntityIterator;
+  using const_iterator = EntityIterator;
   using const_reverse_iterator = std::reverse_iterator<const_iterator>;
   using reverse_iterator = std::reverse_iterator<iterator>;
 
   using reference = Entity&;
   using const_reference = const Entity&;
-  using pointer = Entity*;
-  using const_pointer = const Entity*;
 
   // Forward iterator creation methods.
-  [[nodiscard]] iterator begin() { return dense_.begin(); }
-  [[nodiscard]] const_iterator begin() const { return dense_.begin(); }
-  [[nodiscard]] iterator end() { return dense_.end(); }
-  [[nodiscard]] const_iterator end() const { return dense_.end(); }
+  [[nodiscard]] const_iterator begin() const { return { this, 0 }; }
+  [[nodiscard]] const_iterator end() const { return { this, size_ }; }
 
   // Explicit const forward iterator creation methods.
-  [[nodiscard]] const_iterator cbegin() const { return dense_.cbegin(); }
-  [[nodiscard]] const_iterator cend() const { return dense_.cend(); }
+  [[nodiscard]] const_iterator cbegin() const { return begin(); }
+  [[nodiscard]] const_iterator cend() const { return end(); }
 
   // Reverse iterator creation methods.
-  [[nodiscard]] reverse_iterator rbegin() { return reverse_iterator(end()); }
   [[nodiscard]] const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
-  [[nodiscard]] reverse_iterator rend() { return reverse_iterator(begin()); }
   [[nodiscard]] const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
 
   // Internal array accessors
-  [[nodiscard]] pointer data() { return pointer(begin()); }
-  [[nodiscard]] const_pointer data() const { return const_pointer(begin()); }
-  [[nodiscard]] reference front() { return begin()[0]; }
-  [[nodiscard]] const_reference front() const { return begin()[0]; }
-  [[nodiscard]] reference back() { return end()[-1]; }
-  [[nodiscard]] const_reference back() const { return end()[-1]; }
+  [[nodiscard]] reference front() { return (*this)[0]; }
+  [[nodiscard]] const_reference front() const { return (*this)[0]; }
+  [[nodiscard]] reference back() { return (*this)[size_ - 1]; }
+  [[nodiscard]] const_reference back() const { return (*this)[size_ - 1]; }
 
   // clang-format on
 
@@ -166,7 +665,7 @@ public:
   ///
   [[nodiscard]] constexpr const_reference operator[](const size_type index) const noexcept
   {
-    return dense_[index];
+    return reinterpret_cast<const Entity*>(chunks_.data()[index >> chunk_shift_])[Slot(index)];
   }
 
   ///
@@ -178,7 +677,7 @@ public:
   ///
   [[nodiscard]] constexpr reference operator[](const size_type index) noexcept
   {
-    return dense_[index];
+    return const_cast<reference>(static_cast<const Storage*>(this)->operator[](index));
   }
 
 public:
@@ -186,18 +685,30 @@ public:
   /// Constructor.
   ///
   /// @param[in] sparse Shared sparse array.
+  /// @param[in] tick Current tick to stamp added and changed components with, the tick stays 0 if nullptr.
+  /// @param[in] archetype Archetype recorded in the sparse array for the entities of the storage.
   ///
-  explicit Storage(SharedSparseArray<Entity>* sparse) noexcept
+  explicit Storage(
+    SharedSparseArray<Entity>* sparse, const Tick* tick = nullptr, const ArchetypeId archetype = 0) noexcept
+    : sparse_(sparse), size_(0), version_(0), adopted_chunks_(0), chunk_capacity_(0), chunk_shift_(0),
+      chunk_bytes_(0), chunk_alignment_(0), tick_(tick ? tick : &cNoTick), archetype_(archetype)
   {
     ASSERT(sparse != nullptr, "Sparse array cannot be nullptr");
-
-    sparse_ = sparse;
   }
 
   ///
   /// Destructor.
   ///
-  ~Storage() = default;
+  ~Storage()
+  {
+    DestroyComponents();
+
+    // Adopted chunks are owned by whoever provided them
+    for (size_t i = adopted_chunks_; i != chunks_.size(); ++i)
+    {
+      ::operator delete(chunks_[i], chunk_bytes_, std::align_val_t(chunk_alignment_));
+    }
+  }
 
   Storage(const Storage&) = delete;
   Storage(Storage&&) = delete;
@@ -220,245 +731,1831 @@ public:
     ...>
     COLD_SECTION NO_INLINE void Initialize() noexcept
   {
-    ASSERT(!initialized_, "Already initialized");
+    Vector<const ComponentInfo*> components;
+    components.reserve(sizeof...(Components));
 
-    // Set up all the component arrays with type erased vectors.
-    ((component_arrays_.template Assure<std::remove_cvref_t<Components>>() =
-         std::move(MakeErased<Vector<std::remove_cvref_t<Components>>>())),
-      ...);
+    (components.push_back(GetComponentInfo<std::remove_cvref_t<Components>>()), ...);
 
-    // Store functors for the operations that need type information and don't have it.
-    erase_function_ = []([[maybe_unused]] auto* storage, [[maybe_unused]] const size_t index)
-    { (AccessAndEraseAt<std::remove_cvref_t<Components>>(storage, index), ...); };
-    clear_function_ = []([[maybe_unused]] auto storage)
-    { ((storage->template Access<std::remove_cvref_t<Components>>().clear()), ...); };
-
-#ifndef NDEBUG
-    // When debugging it is useful to have the list of components used at initialization.
-    ((components_.push_back(TypeName<Components>())), ...);
-    initialized_ = true;
-#endif
+    Initialize(components);
   }
 
   ///
-  /// Inserts the entity with its component data into the storage.
+  /// Initializes the storage for the component types described by the component information.
   ///
-  /// @note
-  ///    Order of the components does not matter.
+  /// Computes the layout of the chunks. The chunk capacity is the largest power of two that fits in a chunk.
   ///
-  /// @tparam Components List of component types to add.
+  /// Every component array is followed by its ticks: the last tick the chunk was changed, the newest tick a row of the
+  /// chunk was added and the tick every row was added.
   ///
-  /// @param[in] entity Entity to insert into the storage.
-  /// @param[in] components Component data to move into the storage.
+  /// @warning
+  ///    Must be correctly called before doing anything with the registry, or else behaviour
+  ///    of the storage is undefined.
+  ///
+  /// @param[in] components Information about every component type of the archetype.
+  ///
+  COLD_SECTION NO_INLINE void Initialize(const Vector<const ComponentInfo*>& components) noexcept
+  {
+    ASSERT(!initialized_, "Already initialized");
+
+    components_.reserve(components.size());
+
+    size_t row_size = sizeof(Entity);
+    size_t max_padding = 0;
+
+    chunk_alignment_ = cChunkAlignment;
+
+    for (const auto info : components)
+    {
+      ASSERT(!HasComponent(info->id), "Component types must be unique");
+
+      if (info->id >= offsets_.size())
+      {
+        offsets_.resize(info->id + 1, cNoOffset);
+        tick_offsets_.resize(info->id + 1, cNoOffset);
+      }
+
+      if (info->empty_instance)
+      {
+        empty_components_.push_back(info);
+        offsets_[info->id] = 0;
+      }
+      else
+      {
+        components_.push_back({ info, 0, info->size, 0 });
+
+        row_size += info->size + sizeof(Tick);
+        max_padding += std::max(info->alignment, cChunkAlignment) + alignof(Tick) + cRowTicks * sizeof(Tick);
+        chunk_alignment_ = std::max(chunk_alignment_, info->alignment);
+      }
+    }
+
+    const size_t fit = cChunkSize > max_padding + row_size ? (cChunkSize - max_padding) / row_size : 1;
+
+    chunk_shift_ = std::bit_width(fit) - 1;
+    chunk_capacity_ = size_t { 1 } << chunk_shift_;
+
+    size_t offset = chunk_capacity_ * sizeof(Entity);
+
+    for (auto& component : components_)
+    {
+      const size_t alignment = std::max(component.info->alignment, cChunkAlignment);
+
+      offset = (offset + alignment - 1) & ~(alignment - 1);
+
+      component.offset = offset;
+      offsets_[component.info->id] = offset;
+
+      offset += chunk_capacity_ * component.info->size;
+      offset = (offset + alignof(Tick) - 1) & ~(alignof(Tick) - 1);
+
+      component.ticks = offset;
+      tick_offsets_[component.info->id] = offset;
+
+      offset += (cRowTicks + chunk_capacity_) * sizeof(Tick);
+    }
+
+    chunk_bytes_ = offset;
+
+#ifndef NDEBUG
+    initialized_ = true;
+#endif
+  }
+
+  ///
+  /// Inserts the entity with its component data into the storage.
+  ///
+  /// @note
+  ///    Order of the components does not matter.
+  ///
+  /// @tparam Components List of component types to add.
+  ///
+  /// @param[in] entity Entity to insert into the storage.
+  /// @param[in] components Component data to move into the storage.
+  ///
+  template<typename... Components>
+  requires UniqueTypes<std::remove_cvref_t<Components>
+    ...> void
+    Insert(const Entity entity, Components&&... components) noexcept
+  {
+    ASSERT(initialized_, "Not initialized");
+    ASSERT(!Contains(entity), "Entity already exists");
+    ASSERT(sizeof...(Components) == components_.size() + empty_components_.size(), "Invalid amount of components");
+
+    // Runtime check that the components are the same as the ones used to initialize the storage
+    ASSERT((HasComponent<std::remove_cvref_t<Components>>() && ...), "Component type not valid");
+
+    const size_t index = size_;
+
+    AssureChunk(index);
+
+    sparse_->Assure(entity);
+    sparse_->Assign(entity, static_cast<Entity>(index), archetype_);
+
+    const Location location = Locate(index);
+
+    reinterpret_cast<Entity*>(location.chunk)[location.slot] = entity;
+    (Emplace(location, std::forward<Components>(components)), ...);
+
+    for (const auto& component : components_)
+    {
+      StampAdded(TicksAt(location.chunk, component.ticks), location.slot);
+    }
+
+    ++size_;
+    ++version_;
+  }
+
+  ///
+  /// Inserts a block of entities with contiguous identifiers into the storage.
+  ///
+  /// Chunks and the sparse array are assured once for the whole block, then the components are constructed in place
+  /// chunk by chunk.
+  ///
+  /// @tparam Components List of component types to add.
+  /// @tparam Generator Invocable with an entity that returns a tuple of the component data for the entity.
+  ///
+  /// @param[in] first First entity of the block.
+  /// @param[in] amount Amount of entities to insert.
+  /// @param[in] generator Generator of the component data.
+  ///
+  template<typename... Components, typename Generator>
+  requires UniqueTypes<std::remove_cvref_t<Components>...>
+  void InsertMany(const Entity first, const size_t amount, Generator&& generator)
+  {
+    ASSERT(initialized_, "Not initialized");
+    ASSERT(sizeof...(Components) == components_.size() + empty_components_.size(), "Invalid amount of components");
+    ASSERT((HasComponent<std::remove_cvref_t<Components>>() && ...), "Component type not valid");
+
+    if (amount == 0) return;
+
+    const size_t end = size_ + amount;
+
+    Reserve(end);
+
+    sparse_->Assure(first, static_cast<Entity>(first + amount - 1));
+
+    Entity entity = first;
+
+    for (size_t index = size_; index != end;)
+    {
+      const Location chunk_location = Locate(index);
+      const size_t chunk_end = std::min(end, index + (chunk_capacity_ - chunk_location.slot));
+
+      Entity* entities = reinterpret_cast<Entity*>(chunk_location.chunk);
+
+      const size_t chunk_rows = chunk_end - index;
+
+      for (const auto& component : components_)
+      {
+        Tick* ticks = TicksAt(chunk_location.chunk, component.ticks);
+
+        ticks[cChangedTick] = ticks[cAddedTick] = *tick_;
+
+        std::fill_n(ticks + cRowTicks + chunk_location.slot, chunk_rows, *tick_);
+      }
+
+      for (Location location = chunk_location; index != chunk_end; ++index, ++location.slot, ++entity)
+      {
+        ASSERT(!Contains(entity), "Entity already exists");
+
+        entities[location.slot] = entity;
+        sparse_->Assign(entity, static_cast<Entity>(index), archetype_);
+
+        std::apply([&](auto&&... components)
+          { (Emplace(location, std::forward<decltype(components)>(components)), ...); },
+          static_cast<std::tuple<Components...>>(generator(entity)));
+      }
+    }
+
+    size_ = end;
+    ++version_;
+  }
+
+  ///
+  /// Inserts a block of entities with contiguous identifiers into the storage, every entity is a copy of the source
+  /// entity of the storage.
+  ///
+  /// Chunks and the sparse array are assured once for the whole block. Trivially copyable components are broadcast
+  /// with memory copies that double the amount of copied rows every time.
+  ///
+  /// @warning Every component of the storage must be copy constructible.
+  ///
+  /// @param[in] first First entity of the block.
+  /// @param[in] amount Amount of entities to insert.
+  /// @param[in] source Entity of the storage to copy.
+  ///
+  void InsertCopies(const Entity first, const size_t amount, const Entity source)
+  {
+    ASSERT(initialized_, "Not initialized");
+    ASSERT(Contains(source), "Source entity does not exist");
+
+    if (amount == 0) return;
+
+    const size_t end = size_ + amount;
+
+    Reserve(end);
+
+    sparse_->Assure(first, static_cast<Entity>(first + amount - 1));
+
+    const Location origin = Locate((*sparse_)[source]);
+
+    Entity entity = first;
+
+    for (size_t index = size_; index != end;)
+    {
+      const Location location = Locate(index);
+      const size_t rows = std::min(end - index, chunk_capacity_ - location.slot);
+
+      Entity* entities = reinterpret_cast<Entity*>(location.chunk);
+
+      for (size_t slot = location.slot; slot != location.slot + rows; ++slot, ++index, ++entity)
+      {
+        ASSERT(!Contains(entity), "Entity already exists");
+
+        entities[slot] = entity;
+        sparse_->Assign(entity, static_cast<Entity>(index), archetype_);
+      }
+
+      for (const auto& component : components_)
+      {
+        Tick* ticks = TicksAt(location.chunk, component.ticks);
+
+        ticks[cChangedTick] = ticks[cAddedTick] = *tick_;
+
+        std::fill_n(ticks + cRowTicks + location.slot, rows, *tick_);
+
+        BroadcastComponent(*component.info, ComponentAt(origin, component), ComponentAt(location, component), rows);
+      }
+    }
+
+    size_ = end;
+    ++version_;
+  }
+
+  ///
+  /// Adopts chunks laid out exactly like the chunks of the storage as its own, without copying them. The storage must
+  /// not have any chunk of its own.
+  ///
+  /// Adopted chunks are used like any other chunk, but they are never freed by the storage, and neither are the
+  /// components in them. They must outlive it.
+  ///
+  /// A storage that already adopted chunks is updated in place: only the entities of the chunks that are not at the
+  /// same position as before are mapped again. The previously adopted chunks must still be alive.
+  ///
+  /// @warning Every component must be trivially copyable if the storage is modified after adopting chunks.
+  ///
+  /// @param[in] chunks Chunks to adopt, every chunk is full except the last one.
+  /// @param[in] size Amount of entities in the chunks.
+  ///
+  void Adopt(const std::span<std::byte* const> chunks, const size_t size)
+  {
+    ASSERT(initialized_, "Not initialized");
+    ASSERT(chunks_.size() == adopted_chunks_, "Storage has chunks of its own");
+    ASSERT(((size + chunk_capacity_ - 1) >> chunk_shift_) == chunks.size(), "Invalid amount of chunks");
+
+    const size_t previous = chunks_.size();
+
+    // Entities may have been mapped by another storage already, they are only unmapped if they are still mapped here
+    for (size_t chunk = 0; chunk != previous; ++chunk)
+    {
+      if (chunk < chunks.size() && chunks_[chunk] == chunks[chunk]) continue;
+
+      const size_t last = std::min(size_, (chunk + 1) << chunk_shift_);
+
+      for (size_t index = chunk << chunk_shift_; index != last; ++index)
+      {
+        const Entity entity = (*this)[index];
+
+        if (sparse_->Valid(entity) && sparse_->Archetype(entity) == archetype_ && (*sparse_)[entity] == index)
+        {
+          sparse_->Invalidate(entity);
+        }
+      }
+    }
+
+    chunks_.resize(chunks.size());
+
+    for (size_t chunk = 0; chunk != chunks.size(); ++chunk)
+    {
+      if (chunk < previous && chunks_[chunk] == chunks[chunk]) continue;
+
+      chunks_[chunk] = chunks[chunk];
+
+      const size_t last = std::min(size, (chunk + 1) << chunk_shift_);
+
+      for (size_t index = chunk << chunk_shift_; index != last; ++index)
+      {
+        const Entity entity = (*this)[index];
+
+        sparse_->Assure(entity);
+        sparse_->Assign(entity, static_cast<Entity>(index), archetype_);
+      }
+    }
+
+    adopted_chunks_ = chunks.size();
+
+    size_ = size;
+    ++version_;
+  }
+
+  ///
+  /// Inserts the rows of a chunk that is laid out differently than the chunks of the storage, for example a chunk of
+  /// another process. Entities, components and their ticks are copied with memory copies.
+  ///
+  /// The entities of the chunk start at its beginning, the component and tick arrays are at the given offsets.
+  ///
+  /// @warning Every component of the storage must be trivially copyable.
+  ///
+  /// @param[in] chunk Chunk to copy the rows from.
+  /// @param[in] amount Amount of rows to copy.
+  /// @param[in] offsets Offsets of the component arrays in the chunk indexed by component id.
+  /// @param[in] tick_offsets Offsets of the tick arrays in the chunk indexed by component id.
+  ///
+  void InsertChunk(const std::byte* chunk, const size_t amount, const std::span<const size_t> offsets,
+    const std::span<const size_t> tick_offsets)
+  {
+    ASSERT(initialized_, "Not initialized");
+    ASSERT(std::ranges::none_of(components_, [](const auto& component) { return component.info->copy; }),
+      "Components must be trivially copyable");
+    ASSERT(std::ranges::all_of(components_, [&](const auto& component) { return component.info->id < offsets.size(); }),
+      "Missing component array");
+
+    if (amount == 0) return;
+
+    const Entity* entities = reinterpret_cast<const Entity*>(chunk);
+
+    const size_t end = size_ + amount;
+
+    Reserve(end);
+
+    for (size_t row = 0; row != amount;)
+    {
+      const Location location = Locate(size_);
+      const size_t rows = std::min(amount - row, chunk_capacity_ - location.slot);
+
+      std::memcpy(reinterpret_cast<Entity*>(location.chunk) + location.slot, entities + row, rows * sizeof(Entity));
+
+      for (const auto& component : components_)
+      {
+        const ComponentId id = component.info->id;
+
+        const Tick* from = reinterpret_cast<const Tick*>(chunk + tick_offsets[id]);
+        Tick* to = TicksAt(location.chunk, component.ticks);
+
+        MergeTick(to[cChangedTick], from[cChangedTick]);
+        MergeTick(to[cAddedTick], from[cAddedTick]);
+
+        std::memcpy(to + cRowTicks + location.slot, from + cRowTicks + row, rows * sizeof(Tick));
+        const std::byte* source = chunk + offsets[id] + row * component.size;
+
+        std::memcpy(ComponentAt(location, component), source, rows * component.size);
+      }
+
+      for (size_t i = 0; i != rows; ++i, ++size_)
+      {
+        const Entity entity = entities[row + i];
+
+        ASSERT(!Contains(entity), "Entity already exists");
+
+        sparse_->Assure(entity);
+        sparse_->Assign(entity, static_cast<Entity>(size_), archetype_);
+      }
+
+      row += rows;
+    }
+
+    ++version_;
+  }
+
+  ///
+  /// Allocates enough chunks to hold at least the given amount of entities.
+  ///
+  /// @param[in] capacity Amount of entities to hold.
+  ///
+  void Reserve(const size_t capacity)
+  {
+    ASSERT(initialized_, "Not initialized");
+
+    const size_t chunk_count = (capacity + chunk_capacity_ - 1) >> chunk_shift_;
+
+    if (chunk_count > chunks_.size())
+    {
+      chunks_.reserve(chunk_count);
+
+      while (chunks_.size() != chunk_count)
+      {
+        chunks_.push_back(AllocateChunk());
+      }
+    }
+  }
+
+  ///
+  /// Erases the entity from the storage.
+  ///
+  /// The mapping of the entity in the sparse array is invalidated.
+  ///
+  /// @param[in] entity Entity to erase.
+  ///
+  void Erase(const Entity entity) noexcept
+  {
+    ASSERT(initialized_, "Not initialized");
+    ASSERT(Contains(entity), "Entity does not exist");
+
+    const size_t index = (*sparse_)[entity];
+    const size_t last = --size_;
+    ++version_;
+
+    const Location hole = Locate(index);
+    const Location back = Locate(last);
+
+    for (const auto& component : components_)
+    {
+      const ComponentInfo& info = *component.info;
+
+      void* instance = ComponentAt(hole, component);
+
+      if (info.destroy) info.destroy(instance);
+
+      if (index != last)
+      {
+        RelocateComponent(info, ComponentAt(back, component), instance);
+        MoveTicks(TicksAt(back.chunk, component.ticks), back.slot, TicksAt(hole.chunk, component.ticks), hole.slot);
+      }
+    }
+
+    FillHole(index, last);
+
+    sparse_->Invalidate(entity);
+  }
+
+  ///
+  /// Erases the entities at the indices.
+  ///
+  /// The destroyed entities are compacted away by moving the runs of surviving entities between them, the surviving
+  /// entities keep their relative order.
+  ///
+  /// @param[in] holes Indices of the entities to erase, in increasing order.
+  /// @param[out] erased Vector to append the erased entities to.
+  ///
+  void EraseRows(const std::span<const size_t> holes, Vector<Entity>& erased)
+  {
+    ASSERT(initialized_, "Not initialized");
+    ASSERT(std::ranges::is_sorted(holes), "Indices must be in increasing order");
+    ASSERT(holes.empty() || holes.back() < size_, "Index out of bounds");
+
+    if (holes.empty()) return;
+
+    const size_t first = erased.size();
+
+    erased.resize(first + holes.size());
+
+    for (size_t i = 0; i != holes.size(); ++i)
+    {
+      erased[first + i] = (*this)[holes[i]];
+    }
+
+    for (const auto& component : components_)
+    {
+      if (!component.info->destroy) continue;
+
+      for (const size_t hole : holes)
+      {
+        component.info->destroy(ComponentAt(Locate(hole), component));
+      }
+    }
+
+    size_t destination = holes[0];
+
+    for (size_t i = 0; i != holes.size(); ++i)
+    {
+      const size_t source = holes[i] + 1;
+      const size_t count = (i + 1 != holes.size() ? holes[i + 1] : size_) - source;
+
+      MoveRows(source, destination, count);
+
+      destination += count;
+    }
+
+    size_ = destination;
+    ++version_;
+
+    for (size_t i = first; i != erased.size(); ++i)
+    {
+      sparse_->Invalidate(erased[i]);
+    }
+  }
+
+  ///
+  /// Moves the entity and its component data into the destination storage.
+  ///
+  /// Components that the destination storage shares with this storage are relocated, components that the destination
+  /// does not have are destroyed. Components that only the destination has must be provided.
+  ///
+  /// This is how entities change archetype without being destroyed and created again.
+  ///
+  /// @warning Both storages must share the same sparse array.
+  ///
+  /// @tparam Components List of component types that only the destination storage has.
+  ///
+  /// @param[in] entity Entity to move.
+  /// @param[in] destination Storage to move the entity into.
+  /// @param[in] components Component data to move into the destination storage.
+  ///
+  template<typename... Components>
+  requires UniqueTypes<std::remove_cvref_t<Components>
+    ...> void
+    Relocate(const Entity entity, Storage& destination, Components&&... components)
+  {
+    ASSERT(initialized_, "Not initialized");
+    ASSERT(destination.initialized_, "Destination not initialized");
+    ASSERT(this != &destination, "Cannot relocate into the same storage");
+    ASSERT(sparse_ == destination.sparse_, "Storages must share the same sparse array");
+    ASSERT(Contains(entity), "Entity does not exist");
+
+    const size_t index = (*sparse_)[entity];
+    const size_t last = --size_;
+    ++version_;
+
+    const size_t destination_index = destination.size_;
+
+    destination.AssureChunk(destination_index);
+
+    const Location hole = Locate(index);
+    const Location back = Locate(last);
+    const Location target = destination.Locate(destination_index);
+
+    for (const auto& component : components_)
+    {
+      const ComponentInfo& info = *component.info;
+
+      void* instance = ComponentAt(hole, component);
+
+      if (destination.HasComponent(info.id))
+      {
+        void* destination_instance = target.chunk + destination.offsets_[info.id] + target.slot * component.size;
+
+        RelocateComponent(info, instance, destination_instance);
+
+        MoveTicks(TicksAt(hole.chunk, component.ticks),
+          hole.slot,
+          TicksAt(target.chunk, destination.tick_offsets_[info.id]),
+          target.slot);
+      }
+      else if (info.destroy)
+      {
+        info.destroy(instance);
+      }
+
+      if (index != last)
+      {
+        RelocateComponent(info, ComponentAt(back, component), instance);
+        MoveTicks(TicksAt(back.chunk, component.ticks), back.slot, TicksAt(hole.chunk, component.ticks), hole.slot);
+      }
+    }
+
+    FillHole(index, last);
+
+    sparse_->Assign(entity, static_cast<Entity>(destination_index), destination.archetype_);
+    reinterpret_cast<Entity*>(target.chunk)[target.slot] = entity;
+
+    (destination.Emplace(target, std::forward<Components>(components)), ...);
+    (destination.template StampAdded<std::remove_cvref_t<Components>>(target), ...);
+
+    ++destination.size_;
+    ++destination.version_;
+  }
+
+  ///
+  /// Clears the entire storage. The mappings of the entities in the sparse array are invalidated.
+  ///
+  /// @note Chunks are kept for reuse.
+  ///
+  void Clear()
+  {
+    ASSERT(initialized_, "Not initialized");
+
+    DestroyComponents();
+
+    for (size_t index = 0; index != size_; ++index)
+    {
+      sparse_->Invalidate((*this)[index]);
+    }
+
+    size_ = 0;
+    ++version_;
+  }
+
+  ///
+  /// Sorts the entities of the storage by one of their components.
+  ///
+  /// The order is either given by a comparison of two components or by an integral key of every component. Keys are
+  /// sorted with a radix sort, in linear time. Both sorts are stable.
+  ///
+  /// Once the order is known, the entities, every component array, the ticks and the sparse mappings are moved
+  /// together into new chunks in a single pass. Nothing is moved if the entities are already sorted.
+  ///
+  /// @note Moved rows keep their ticks, sorting does not mark components as changed.
+  ///
+  /// @tparam Component Component type to sort by.
+  /// @tparam Compare Invocable with two components that returns whether or not the first goes before the second, or
+  /// invocable with one component that returns its integral key.
+  ///
+  /// @param[in] compare Comparison or key of the components.
+  ///
+  template<typename Component, typename Compare>
+  requires(std::is_invocable_r_v<bool, Compare&, const Component&, const Component&>
+           || details::SortKey<std::invoke_result_t<Compare&, const Component&>>)
+  void Sort(Compare compare)
+  {
+    ASSERT(initialized_, "Not initialized");
+    ASSERT(HasComponent<Component>(), "Component type not valid");
+
+    if (size_ < 2) return;
+
+    constexpr bool cComparison = std::is_invocable_r_v<bool, Compare&, const Component&, const Component&>;
+
+    // Already sorted storages are only scanned, nothing is allocated
+    size_t unsorted = 1;
+
+    for (; unsorted != size_; ++unsorted)
+    {
+      const Component& previous = ComponentAt<Component>(unsorted - 1);
+      const Component& current = ComponentAt<Component>(unsorted);
+
+      if constexpr (cComparison)
+      {
+        if (compare(current, previous)) break;
+      }
+      else
+      {
+        if (compare(current) < compare(previous)) break;
+      }
+    }
+
+    if (unsorted == size_) return;
+
+    Vector<size_t> order;
+    order.resize(size_);
+
+    for (size_t index = 0; index != size_; ++index)
+    {
+      order[index] = index;
+    }
+
+    if constexpr (cComparison)
+    {
+      const auto less = [this, &compare](const size_t lhs, const size_t rhs)
+      { return compare(ComponentAt<Component>(lhs), ComponentAt<Component>(rhs)); };
+
+      std::ranges::stable_sort(order, less);
+    }
+    else
+    {
+      using Key = std::invoke_result_t<Compare&, const Component&>;
+      using UnsignedKey = std::make_unsigned_t<Key>;
+
+      // Flipping the sign bit orders signed keys like unsigned keys
+      constexpr UnsignedKey cSignBit =
+        std::is_signed_v<Key> ? UnsignedKey { 1 } << (std::numeric_limits<UnsignedKey>::digits - 1) : 0;
+
+      Vector<UnsignedKey> keys;
+      keys.resize(size_);
+
+      for (size_t index = 0; index != size_; ++index)
+      {
+        keys[index] = static_cast<UnsignedKey>(compare(ComponentAt<Component>(index))) ^ cSignBit;
+      }
+
+      RadixSort(keys, order);
+    }
+
+    Permute(order);
+  }
+
+  ///
+  /// Checks if the entity is in the storage.
+  ///
+  /// @param[in] entity The entity to check.
+  ///
+  /// @return True if the entity is in the storage, false otherwise.
+  ///
+  [[nodiscard]] constexpr bool Contains(const Entity entity) const noexcept
+  {
+    ASSERT(initialized_, "Not initialized");
+
+    size_t index;
+
+    return sparse_->Assured(entity) && (index = (*sparse_)[entity]) < size_ && (*this)[index] == entity;
+  }
+
+  ///
+  /// Returns a reference to the component data for the entity.
+  ///
+  /// @note
+  ///    This method of unpacking is slightly slower than the unpacking during iteration.
+  ///
+  /// @tparam Component The component to obtain reference of.
+  ///
+  /// @param[in] entity Entity to unpack data for.
+  ///
+  /// @return The unpacked component data.
+  ///
+  template<typename Component>
+  [[nodiscard]] const Component& Unpack(const Entity entity) const noexcept
+  {
+    ASSERT(Contains(entity), "Entity does not exist");
+
+    return ComponentAt<Component>(sparse_->operator[](entity));
+  }
+
+  ///
+  /// Returns a reference to the component data for the entity.
+  ///
+  /// @note
+  ///    This method of unpacking is slightly slower than the unpacking during iteration.
+  ///
+  /// @tparam Component The component to obtain reference of.
+  ///
+  /// @param[in] entity Entity to unpack data for.
+  ///
+  /// @return The unpacked component data.
+  ///
+  template<typename Component>
+  [[nodiscard]] Component& Unpack(const Entity entity) noexcept
+  {
+    return const_cast<Component&>(static_cast<const Storage*>(this)->Unpack<Component>(entity));
+  }
+
+  ///
+  /// Returns a reference to the component at the index.
+  ///
+  /// Empty components always return the same shared instance.
+  ///
+  /// @tparam Component The component type to access.
+  ///
+  /// @param[in] index Index of the component.
+  ///
+  /// @return Reference to the component.
+  ///
+  template<typename Component>
+  [[nodiscard]] const Component& ComponentAt(const size_type index) const noexcept
+  {
+    ASSERT(index < size_, "Index out of bounds");
+
+    if constexpr (std::is_empty_v<Component>)
+    {
+      ASSERT(HasComponent<Component>(), "Component type not valid");
+
+      return details::EmptyComponentStorage<Component>::instance;
+    }
+    else if constexpr (IsStoredOutOfLine<Component>::value)
+    {
+      return *ChunkComponents<Component>(index >> chunk_shift_)[Slot(index)].component;
+    }
+    else
+    {
+      return ChunkComponents<Component>(index >> chunk_shift_)[Slot(index)];
+    }
+  }
+
+  ///
+  /// Returns a reference to the component at the index.
+  ///
+  /// Empty components always return the same shared instance.
+  ///
+  /// @tparam Component The component type to access.
+  ///
+  /// @param[in] index Index of the component.
+  ///
+  /// @return Reference to the component.
+  ///
+  template<typename Component>
+  [[nodiscard]] Component& ComponentAt(const size_type index) noexcept
+  {
+    return const_cast<Component&>(static_cast<const Storage*>(this)->ComponentAt<Component>(index));
+  }
+
+  ///
+  /// Directly accesses the array of components of a chunk.
+  ///
+  /// @note Empty components have no array, the pointer to their shared instance is returned instead.
+  ///
+  /// @note The array of a component stored out of line holds the handles to the components.
+  ///
+  /// @tparam Component The component type to access array for.
+  ///
+  /// @param[in] chunk Index of the chunk.
+  ///
+  /// @return Pointer to the first component of the chunk.
+  ///
+  template<typename Component>
+  [[nodiscard]] const StoredComponent<Component>* ChunkComponents(const size_type chunk) const noexcept
+  {
+    ASSERT(initialized_, "Not initialized");
+    ASSERT(HasComponent<Component>(), "Component type not valid");
+    ASSERT(chunk < chunks_.size(), "Chunk out of bounds");
+
+    if constexpr (std::is_empty_v<Component>)
+    {
+      return &details::EmptyComponentStorage<Component>::instance;
+    }
+    else
+    {
+      return reinterpret_cast<const StoredComponent<Component>*>(
+        chunks_.data()[chunk] + offsets_.data()[GetComponentId<Component>()]);
+    }
+  }
+
+  ///
+  /// Directly accesses the array of components of a chunk.
+  ///
+  /// @note Empty components have no array, the pointer to their shared instance is returned instead.
+  ///
+  /// @note The array of a component stored out of line holds the handles to the components.
+  ///
+  /// @tparam Component The component type to access array for.
+  ///
+  /// @param[in] chunk Index of the chunk.
+  ///
+  /// @return Pointer to the first component of the chunk.
+  ///
+  template<typename Component>
+  [[nodiscard]] StoredComponent<Component>* ChunkComponents(const size_type chunk) noexcept
+  {
+    return const_cast<StoredComponent<Component>*>(
+      static_cast<const Storage*>(this)->ChunkComponents<Component>(chunk));
+  }
+
+  ///
+  /// Directly accesses the array of entities of a chunk.
+  ///
+  /// @param[in] chunk Index of the chunk.
+  ///
+  /// @return Pointer to the first entity of the chunk.
+  ///
+  [[nodiscard]] const Entity* ChunkEntities(const size_type chunk) const noexcept
+  {
+    ASSERT(chunk < chunks_.size(), "Chunk out of bounds");
+
+    return reinterpret_cast<const Entity*>(chunks_.data()[chunk]);
+  }
+
+  ///
+  /// Directly accesses the array of entities of a chunk.
+  ///
+  /// @param[in] chunk Index of the chunk.
+  ///
+  /// @return Pointer to the first entity of the chunk.
+  ///
+  [[nodiscard]] Entity* ChunkEntities(const size_type chunk) noexcept
+  {
+    return const_cast<Entity*>(static_cast<const Storage*>(this)->ChunkEntities(chunk));
+  }
+
+  ///
+  /// Returns the amount of chunks that contain entities.
+  ///
+  /// @return Amount of chunks in use.
+  ///
+  [[nodiscard]] size_t ChunkCount() const noexcept
+  {
+    return (size_ + chunk_capacity_ - 1) >> chunk_shift_;
+  }
+
+  ///
+  /// Returns the amount of entities in the chunk.
+  ///
+  /// @param[in] chunk Index of the chunk.
+  ///
+  /// @return Amount of entities in the chunk.
+  ///
+  [[nodiscard]] size_t ChunkSize(const size_type chunk) const noexcept
+  {
+    ASSERT(chunk < ChunkCount(), "Chunk out of bounds");
+
+    return std::min(chunk_capacity_, size_ - (chunk << chunk_shift_));
+  }
+
+  ///
+  /// Returns the maximum amount of entities a single chunk can hold. Always a power of two.
+  ///
+  /// @return Capacity of a chunk.
+  ///
+  [[nodiscard]] size_t ChunkCapacity() const noexcept
+  {
+    return chunk_capacity_;
+  }
+
+  ///
+  /// Returns the size in bytes of a chunk.
+  ///
+  /// @return Size of a chunk.
+  ///
+  [[nodiscard]] size_t ChunkBytes() const noexcept
+  {
+    return chunk_bytes_;
+  }
+
+  ///
+  /// Returns the alignment of a chunk, the largest alignment of its arrays.
+  ///
+  /// @return Alignment of a chunk.
+  ///
+  [[nodiscard]] size_t ChunkAlignment() const noexcept
+  {
+    return chunk_alignment_;
+  }
+
+  ///
+  /// Directly accesses the raw memory of a chunk.
+  ///
+  /// @param[in] chunk Index of the chunk.
+  ///
+  /// @return Pointer to the first byte of the chunk.
+  ///
+  [[nodiscard]] const std::byte* ChunkData(const size_type chunk) const noexcept
+  {
+    ASSERT(chunk < chunks_.size(), "Chunk out of bounds");
+
+    return chunks_.data()[chunk];
+  }
+
+  ///
+  /// Copies the rows of a chunk into memory laid out like a chunk of the storage. The entities, the components and
+  /// their ticks are copied, components that are not trivially copyable are copy constructed.
+  ///
+  /// @param[in] chunk Index of the chunk to copy.
+  /// @param[out] destination Uninitialized memory of ChunkBytes bytes aligned to ChunkAlignment.
+  ///
+  void CopyChunk(const size_type chunk, std::byte* destination) const
+  {
+    ASSERT(chunk < ChunkCount(), "Chunk out of bounds");
+
+    const std::byte* source = chunks_.data()[chunk];
+    const size_t rows = ChunkSize(chunk);
+
+    std::memcpy(destination, source, rows * sizeof(Entity));
+
+    for (const auto& component : components_)
+    {
+      std::memcpy(destination + component.ticks, source + component.ticks, (cRowTicks + rows) * sizeof(Tick));
+
+      if (!component.info->copy)
+      {
+        std::memcpy(destination + component.offset, source + component.offset, rows * component.size);
+      }
+      else
+      {
+        for (size_t row = 0; row != rows; ++row)
+        {
+          const size_t offset = component.offset + row * component.size;
+
+          component.info->copy(source + offset, destination + offset);
+        }
+      }
+    }
+  }
+
+  ///
+  /// Returns whether or not a component was changed or added in the chunk at or after the tick.
+  ///
+  /// @param[in] chunk Index of the chunk.
+  /// @param[in] tick Tick to compare with.
+  ///
+  /// @return True if the chunk may have been modified since the tick, false otherwise.
+  ///
+  [[nodiscard]] bool ChunkModifiedSince(const size_type chunk, const Tick tick) const noexcept
+  {
+    ASSERT(chunk < chunks_.size(), "Chunk out of bounds");
+
+    for (const auto& component : components_)
+    {
+      const Tick* ticks = TicksAt(chunks_.data()[chunk], component.ticks);
+
+      if (!IsNewerTick(tick, ticks[cChangedTick]) || !IsNewerTick(tick, ticks[cAddedTick])) return true;
+    }
+
+    return false;
+  }
+
+  ///
+  /// Returns the offset of the array of the component in a chunk.
+  ///
+  /// @param[in] component Identifier of a component that is not empty.
+  ///
+  /// @return Offset in bytes.
+  ///
+  [[nodiscard]] size_t ComponentOffset(const ComponentId component) const noexcept
+  {
+    ASSERT(HasComponent(component), "Component type not valid");
+
+    return offsets_.data()[component];
+  }
+
+  ///
+  /// Returns the offset of the ticks of the component in a chunk.
+  ///
+  /// @param[in] component Identifier of a component that is not empty.
+  ///
+  /// @return Offset in bytes.
+  ///
+  [[nodiscard]] size_t TicksOffset(const ComponentId component) const noexcept
+  {
+    ASSERT(HasComponent(component), "Component type not valid");
+
+    return tick_offsets_.data()[component];
+  }
+
+  ///
+  /// Returns the current tick that added and changed components are stamped with.
+  ///
+  /// @return Current tick.
+  ///
+  [[nodiscard]] Tick CurrentTick() const noexcept
+  {
+    return *tick_;
+  }
+
+  ///
+  /// Returns the last tick the component was changed in the chunk.
+  ///
+  /// Changes are tracked per chunk, every row of the chunk is considered changed.
+  ///
+  /// @tparam Component The component type.
+  ///
+  /// @param[in] chunk Index of the chunk.
+  ///
+  /// @return Last changed tick.
+  ///
+  template<typename Component>
+  requires(!std::is_empty_v<Component>)
+  [[nodiscard]] Tick ChunkChangedTick(const size_t chunk) const noexcept
+  {
+    return ChunkTicks<Component>(chunk)[cChangedTick];
+  }
+
+  ///
+  /// Returns the newest tick the component was added to a row of the chunk.
+  ///
+  /// @tparam Component The component type.
+  ///
+  /// @param[in] chunk Index of the chunk.
+  ///
+  /// @return Newest added tick.
+  ///
+  template<typename Component>
+  requires(!std::is_empty_v<Component>)
+  [[nodiscard]] Tick ChunkAddedTick(const size_t chunk) const noexcept
+  {
+    return ChunkTicks<Component>(chunk)[cAddedTick];
+  }
+
+  ///
+  /// Directly accesses the ticks the component was added at for every row of the chunk.
+  ///
+  /// @tparam Component The component type.
+  ///
+  /// @param[in] chunk Index of the chunk.
+  ///
+  /// @return Pointer to the added tick of the first row of the chunk.
+  ///
+  template<typename Component>
+  requires(!std::is_empty_v<Component>)
+  [[nodiscard]] const Tick* ChunkAddedTicks(const size_t chunk) const noexcept
+  {
+    return ChunkTicks<Component>(chunk) + cRowTicks;
+  }
+
+  ///
+  /// Marks the component as changed at the current tick for every row of the chunk. Empty components are not tracked.
+  ///
+  /// @tparam Component The component type.
+  ///
+  /// @param[in] chunk Index of the chunk.
+  ///
+  template<typename Component>
+  void MarkChunkChanged(const size_t chunk) noexcept
+  {
+    if constexpr (!std::is_empty_v<Component>) ChunkTicks<Component>(chunk)[cChangedTick] = *tick_;
+  }
+
+  ///
+  /// Marks the component of the entity as changed at the current tick.
+  ///
+  /// @tparam Component The component type.
+  ///
+  /// @param[in] entity Entity whose component changed.
+  ///
+  template<typename Component>
+  void MarkChanged(const Entity entity) noexcept
+  {
+    ASSERT(Contains(entity), "Entity does not exist");
+
+    MarkChunkChanged<Component>((*sparse_)[entity] >> chunk_shift_);
+  }
+
+  ///
+  /// Marks the component at the index as changed at the current tick.
+  ///
+  /// @tparam Component The component type.
+  ///
+  /// @param[in] index Index of the component.
+  ///
+  template<typename Component>
+  void MarkChangedAt(const size_type index) noexcept
+  {
+    ASSERT(index < size_, "Index out of bounds");
+
+    MarkChunkChanged<Component>(index >> chunk_shift_);
+  }
+
+  ///
+  /// Returns whether or not the storage contains any entities.
+  ///
+  /// @return True if the storage is empty, false otherwise.
+  ///
+  [[nodiscard]] bool Empty() const noexcept
+  {
+    return size_ == 0;
+  }
+
+  ///
+  /// Returns the amount of entities in the storage.
+  ///
+  /// @return Size of storage.
+  ///
+  [[nodiscard]] size_t Size() const noexcept
+  {
+    return size_;
+  }
+
+  ///
+  /// Returns the version of the layout of the storage. The version changes whenever entities are added to or removed
+  /// from the storage or moved within it, not when their components are modified.
+  ///
+  /// @return Version of the layout.
+  ///
+  [[nodiscard]] size_t Version() const noexcept
+  {
+    return version_;
+  }
+
+  ///
+  /// Returns whether or not the storage was initialized with the component type.
+  ///
+  /// @param[in] component Component identifier to check.
+  ///
+  /// @return True if the storage was initialized with component, false otherwise.
+  ///
+  [[nodiscard]] bool HasComponent(const ComponentId component) const noexcept
+  {
+    return component < offsets_.size() && offsets_.data()[component] != cNoOffset;
+  }
+
+  ///
+  /// Returns whether or not the storage was initialized with the component type.
+  ///
+  /// @tparam Component Component type to check.
+  ///
+  /// @return True if the storage was initialized with component, false otherwise.
+  ///
+  template<typename Component>
+  [[nodiscard]] bool HasComponent() const noexcept
+  {
+    return HasComponent(GetComponentId<Component>());
+  }
+
   ///
-  template<typename... Components>
-  requires UniqueTypes<std::remove_cvref_t<Components>
-    ...> void
-    Insert(const Entity entity, Components&&... components) noexcept
+  /// Returns the information about every component type of the storage.
+  ///
+  /// @return List of component information.
+  ///
+  [[nodiscard]] Vector<const ComponentInfo*> ComponentInfos() const
   {
-    ASSERT(initialized_, "Not initialized");
-    ASSERT(!Contains(entity), "Entity already exists");
-    ASSERT(sizeof...(Components) == components_.size(), "Invalid amount of components");
+    Vector<const ComponentInfo*> infos;
+    infos.reserve(components_.size() + empty_components_.size());
 
-    // Runtime check that the components are the same as the ones used to initialize the storage
-#ifndef NDEBUG // Because of parameter pack
-    ((ASSERT(HasComponent<std::remove_cvref_t<Components>>(), "Component type not valid")), ...);
-#endif
+    for (const auto& component : components_)
+    {
+      infos.push_back(component.info);
+    }
 
-    sparse_->Assure(entity);
-    (*sparse_)[entity] = static_cast<Entity>(dense_.size());
+    for (const auto info : empty_components_)
+    {
+      infos.push_back(info);
+    }
 
-    dense_.push_back(entity);
-    ((Access<std::remove_cvref_t<Components>>().emplace_back(std::forward<Components>(components))), ...);
+    return infos;
   }
 
+private:
   ///
-  /// Erases the entity from the storage.
+  /// Returns the slot of the index in its chunk.
   ///
-  /// @param[in] entity Entity to erase.
+  /// @param[in] index Index to get slot for.
   ///
-  void Erase(const Entity entity) noexcept
+  /// @return Slot in the chunk.
+  ///
+  [[nodiscard]] constexpr size_t Slot(const size_t index) const noexcept
   {
-    ASSERT(initialized_, "Not initialized");
-    ASSERT(Contains(entity), "Entity does not exist");
+    return index & (chunk_capacity_ - 1);
+  }
+
+  ///
+  /// Component array in a chunk with its component information.
+  ///
+  struct ComponentArray
+  {
+    const ComponentInfo* info;
+    size_t offset;
+    size_t size;
+    size_t ticks;
+  };
 
-    const auto index = (*sparse_)[entity];
-    const auto back_entity = dense_.back();
+  ///
+  /// Chunk and slot of an index.
+  ///
+  struct Location
+  {
+    std::byte* chunk;
+    size_t slot;
+  };
 
-    (*sparse_)[back_entity] = index;
-    dense_[index] = back_entity;
+  ///
+  /// Returns the chunk and slot of the index.
+  ///
+  /// @param[in] index Index to locate.
+  ///
+  /// @return Location of the index.
+  ///
+  [[nodiscard]] Location Locate(const size_t index) const noexcept
+  {
+    return { chunks_.data()[index >> chunk_shift_], Slot(index) };
+  }
 
-    dense_.pop_back();
+  ///
+  /// Returns the type erased component at the location.
+  ///
+  /// @param[in] location Chunk and slot of the component.
+  /// @param[in] component Component array to access.
+  ///
+  /// @return Pointer to the component.
+  ///
+  [[nodiscard]] static void* ComponentAt(const Location& location, const ComponentArray& component) noexcept
+  {
+    return location.chunk + component.offset + location.slot * component.size;
+  }
 
-    erase_function_(this, index);
+  ///
+  /// Allocates a new chunk if the index is not in an allocated chunk.
+  ///
+  /// @param[in] index Index to assure a chunk for.
+  ///
+  void AssureChunk(const size_t index)
+  {
+    if ((index >> chunk_shift_) == chunks_.size()) [[unlikely]]
+    {
+      chunks_.push_back(AllocateChunk());
+    }
   }
 
   ///
-  /// Clears the entire storage.
+  /// Allocates the memory of a chunk.
   ///
-  void Clear()
+  /// @return Uninitialized chunk memory.
+  ///
+  [[nodiscard]] std::byte* AllocateChunk() const
   {
-    ASSERT(initialized_, "Not initialized");
+    std::byte* chunk = static_cast<std::byte*>(::operator new(chunk_bytes_, std::align_val_t(chunk_alignment_)));
+
+    for (const auto& component : components_)
+    {
+      Tick* ticks = TicksAt(chunk, component.ticks);
 
-    dense_.clear();
+      ticks[cChangedTick] = ticks[cAddedTick] = 0;
+    }
 
-    clear_function_(this);
+    return chunk;
   }
 
   ///
-  /// Checks if the entity is in the storage.
+  /// Returns the ticks of a component array in a chunk.
   ///
-  /// @param[in] entity The entity to check.
+  /// @param[in] chunk Chunk memory.
+  /// @param[in] offset Offset of the ticks in the chunk.
   ///
-  /// @return True if the entity is in the storage, false otherwise.
+  /// @return Pointer to the ticks.
   ///
-  [[nodiscard]] constexpr bool Contains(const Entity entity) const noexcept
+  [[nodiscard]] static Tick* TicksAt(std::byte* chunk, const size_t offset) noexcept
   {
-    ASSERT(initialized_, "Not initialized");
+    return reinterpret_cast<Tick*>(chunk + offset);
+  }
 
-    size_t index;
+  ///
+  /// Returns the ticks of the component in the chunk.
+  ///
+  /// @tparam Component Component type.
+  ///
+  /// @param[in] chunk Index of the chunk.
+  ///
+  /// @return Pointer to the ticks.
+  ///
+  template<typename Component>
+  [[nodiscard]] Tick* ChunkTicks(const size_t chunk) const noexcept
+  {
+    ASSERT(HasComponent<Component>(), "Component type not valid");
+    ASSERT(chunk < ChunkCount(), "Chunk out of bounds");
 
-    return entity < sparse_->Capacity() && (index = (*sparse_)[entity]) < dense_.size() && dense_[index] == entity;
+    return TicksAt(chunks_.data()[chunk], tick_offsets_.data()[GetComponentId<Component>()]);
   }
 
   ///
-  /// Returns a reference to the component data for the entity.
+  /// Keeps the newest of both ticks.
   ///
-  /// @note
-  ///    This method of unpacking is slightly slower than the unpacking during iteration.
+  /// @param[in] tick Tick to update.
+  /// @param[in] other Other tick.
   ///
-  /// @tparam Component The component to obtain reference of.
+  static void MergeTick(Tick& tick, const Tick other) noexcept
+  {
+    if (IsNewerTick(other, tick)) tick = other;
+  }
+
   ///
-  /// @param[in] entity Entity to unpack data for.
+  /// Moves the added tick of a row and merges the chunk ticks into the destination chunk.
   ///
-  /// @return The unpacked component data.
+  /// Chunk ticks are only ever merged, they are the newest tick of any row that was in the chunk.
   ///
-  template<typename Component>
-  [[nodiscard]] const Component& Unpack(const Entity entity) const noexcept
+  /// @param[in] from Ticks of the source chunk.
+  /// @param[in] from_slot Slot of the row in the source chunk.
+  /// @param[in] to Ticks of the destination chunk.
+  /// @param[in] to_slot Slot of the row in the destination chunk.
+  ///
+  static void MoveTicks(const Tick* from, const size_t from_slot, Tick* to, const size_t to_slot) noexcept
   {
-    ASSERT(Contains(entity), "Entity does not exist");
+    to[cRowTicks + to_slot] = from[cRowTicks + from_slot];
 
-    return Access<Component>()[sparse_->operator[](entity)];
+    MergeTick(to[cChangedTick], from[cChangedTick]);
+    MergeTick(to[cAddedTick], from[cRowTicks + from_slot]);
   }
 
   ///
-  /// Returns a reference to the component data for the entity.
+  /// Stamps the row and the chunk as added and changed at the current tick.
   ///
-  /// @note
-  ///    This method of unpacking is slightly slower than the unpacking during iteration.
+  /// @param[in] ticks Ticks of the component array in the chunk.
+  /// @param[in] slot Slot of the added row.
   ///
-  /// @tparam Component The component to obtain reference of.
+  void StampAdded(Tick* ticks, const size_t slot) const noexcept
+  {
+    ticks[cChangedTick] = ticks[cAddedTick] = ticks[cRowTicks + slot] = *tick_;
+  }
+
   ///
-  /// @param[in] entity Entity to unpack data for.
+  /// Stamps the component of the row as added at the current tick. Empty components are not tracked.
   ///
-  /// @return The unpacked component data.
+  /// @tparam Component Component type.
+  ///
+  /// @param[in] location Chunk and slot of the added row.
   ///
   template<typename Component>
-  [[nodiscard]] Component& Unpack(const Entity entity) noexcept
+  void StampAdded(const Location& location) const noexcept
   {
-    return const_cast<Component&>(static_cast<const Storage*>(this)->Unpack<Component>(entity));
+    if constexpr (!std::is_empty_v<Component>)
+    {
+      StampAdded(TicksAt(location.chunk, tick_offsets_.data()[GetComponentId<Component>()]), location.slot);
+    }
   }
 
   ///
-  /// Directly accesses the internal array of the dense storage of the component.
+  /// Relocates the type erased component.
   ///
-  /// @tparam Component The component type to access array for.
+  /// @param[in] info Information about the component type.
+  /// @param[in] source Component to relocate.
+  /// @param[in] destination Uninitialized memory to relocate to.
+  ///
+  ALWAYS_INLINE static void RelocateComponent(const ComponentInfo& info, void* source, void* destination) noexcept
+  {
+    if (info.relocate) info.relocate(source, destination);
+    else
+    {
+      std::memcpy(destination, source, info.size);
+    }
+  }
+
   ///
-  /// @return Reference to dense array for the component type.
+  /// Copies the type erased component into contiguous uninitialized memory.
   ///
-  template<typename Component>
-  [[nodiscard]] const Vector<Component>& Access() const noexcept
+  /// @param[in] info Information about the component type.
+  /// @param[in] source Component to copy.
+  /// @param[in] destination Uninitialized memory for the copies.
+  /// @param[in] count Amount of copies.
+  ///
+  static void BroadcastComponent(const ComponentInfo& info, const void* source, void* destination, const size_t count)
   {
-    ASSERT(initialized_, "Not initialized");
-    ASSERT(HasComponent<Component>(), "Component type not valid");
+    std::byte* bytes = static_cast<std::byte*>(destination);
+
+    if (info.copy)
+    {
+      for (size_t i = 0; i < count; i++)
+      {
+        info.copy(source, bytes + i * info.size);
+      }
+    }
+    else
+    {
+      std::memcpy(bytes, source, info.size);
+
+      for (size_t copied = 1; copied < count;)
+      {
+        const size_t amount = std::min(copied, count - copied);
 
-    return *static_cast<Vector<Component>*>(component_arrays_.template Get<Component>().get());
+        std::memcpy(bytes + copied * info.size, bytes, amount * info.size);
+
+        copied += amount;
+      }
+    }
   }
 
   ///
-  /// Directly accesses the internal array of the dense storage of the component.
-  ///
-  /// @tparam Component The component type to access array for.
+  /// Moves the last entity into the hole left at the index.
   ///
-  /// @return Reference to dense array for the component type.
+  /// @param[in] index Index of the hole.
+  /// @param[in] last Index of the last entity.
   ///
-  template<typename Component>
-  [[nodiscard]] Vector<Component>& Access() noexcept
+  void FillHole(const size_t index, const size_t last) noexcept
   {
-    return const_cast<Vector<Component>&>(static_cast<const Storage*>(this)->Access<Component>());
+    if (index != last)
+    {
+      const Entity back_entity = (*this)[last];
+
+      (*this)[index] = back_entity;
+      sparse_->Assign(back_entity, static_cast<Entity>(index), archetype_);
+    }
   }
 
   ///
-  /// Returns whether or not the storage contains any entities.
+  /// Moves a run of entities and their components towards the front of the storage.
   ///
-  /// @return True if the storage is empty, false otherwise.
+  /// The run is moved in pieces that do not cross chunk boundaries, arrays of trivially relocatable components are
+  /// moved with a single memmove per piece.
   ///
-  [[nodiscard]] bool Empty() const noexcept
+  /// @param[in] source Index of the first entity to move.
+  /// @param[in] destination Index to move the first entity to, must not be greater than the source.
+  /// @param[in] count Amount of entities to move.
+  ///
+  void MoveRows(size_t source, size_t destination, size_t count) noexcept
   {
-    return dense_.empty();
+    while (count != 0)
+    {
+      const Location from = Locate(source);
+      const Location to = Locate(destination);
+
+      const size_t piece = std::min({ count, chunk_capacity_ - from.slot, chunk_capacity_ - to.slot });
+
+      Entity* entities = reinterpret_cast<Entity*>(to.chunk) + to.slot;
+
+      std::memmove(entities, reinterpret_cast<Entity*>(from.chunk) + from.slot, piece * sizeof(Entity));
+
+      for (size_t i = 0; i != piece; ++i)
+      {
+        sparse_->Assign(entities[i], static_cast<Entity>(destination + i), archetype_);
+      }
+
+      for (const auto& component : components_)
+      {
+        std::byte* from_component = static_cast<std::byte*>(ComponentAt(from, component));
+        std::byte* to_component = static_cast<std::byte*>(ComponentAt(to, component));
+
+        if (component.info->relocate)
+        {
+          for (size_t i = 0; i != piece; ++i)
+          {
+            component.info->relocate(from_component + i * component.size, to_component + i * component.size);
+          }
+        }
+        else
+        {
+          std::memmove(to_component, from_component, piece * component.size);
+        }
+
+        Tick* from_ticks = TicksAt(from.chunk, component.ticks);
+        Tick* to_ticks = TicksAt(to.chunk, component.ticks);
+
+        std::memmove(to_ticks + cRowTicks + to.slot, from_ticks + cRowTicks + from.slot, piece * sizeof(Tick));
+
+        MergeTick(to_ticks[cChangedTick], from_ticks[cChangedTick]);
+        MergeTick(to_ticks[cAddedTick], from_ticks[cAddedTick]);
+      }
+
+      source += piece;
+      destination += piece;
+      count -= piece;
+    }
   }
 
   ///
-  /// Returns the amount of entities in the storage.
+  /// Sorts indices by their keys with a least significant digit radix sort. The sort is stable.
   ///
-  /// @return Size of storage.
+  /// Every digit is a byte of the keys, the histograms of all the digits are counted in a single pass. Digits that are
+  /// the same for every key are skipped, small keys stored in wide types only cost the passes of their used bytes.
   ///
-  [[nodiscard]] size_t Size() const noexcept
+  /// @tparam Key Unsigned integral key type.
+  ///
+  /// @param[in] keys Keys of the indices, they are sorted too.
+  /// @param[in] order Indices to sort.
+  ///
+  template<std::unsigned_integral Key>
+  static void RadixSort(Vector<Key>& keys, Vector<size_t>& order)
   {
-    return dense_.size();
+    constexpr size_t cDigits = sizeof(Key);
+    constexpr size_t cRadix = 256;
+
+    const size_t size = keys.size();
+
+    Vector<std::array<size_t, cRadix>> histograms;
+    histograms.resize(cDigits);
+
+    for (const Key key : keys)
+    {
+      for (size_t digit = 0; digit != cDigits; ++digit)
+      {
+        ++histograms[digit][(key >> (digit * 8)) & (cRadix - 1)];
+      }
+    }
+
+    Vector<Key> sorted_keys;
+    sorted_keys.resize(size);
+
+    Vector<size_t> sorted_order;
+    sorted_order.resize(size);
+
+    for (size_t digit = 0; digit != cDigits; ++digit)
+    {
+      auto& histogram = histograms[digit];
+
+      if (std::ranges::find(histogram, size) != histogram.end()) continue;
+
+      size_t offset = 0;
+
+      for (auto& count : histogram)
+      {
+        offset += std::exchange(count, offset);
+      }
+
+      for (size_t index = 0; index != size; ++index)
+      {
+        const size_t position = histogram[(keys[index] >> (digit * 8)) & (cRadix - 1)]++;
+
+        sorted_keys[position] = keys[index];
+        sorted_order[position] = order[index];
+      }
+
+      std::swap(keys, sorted_keys);
+      std::swap(order, sorted_order);
+    }
   }
 
-private:
-#ifndef NDEBUG
   ///
-  /// Debug utility for checking if the storage was initialized with a component type.
+  /// Moves the entities into new chunks in the given order, with their components, their ticks and their mappings.
   ///
-  /// @tparam Component Component type to check.
+  /// Adopted chunks are let go, the new chunks are owned by the storage.
   ///
-  /// @return True if the storage was initialized with component, false otherwise.
+  /// @param[in] order Index of the entity that goes at every index.
   ///
-  template<typename Component>
-  [[nodiscard]] bool HasComponent() const noexcept
+  void Permute(const Vector<size_t>& order)
   {
-    return std::ranges::find(components_, TypeName<Component>()) != components_.end();
+    Vector<std::byte*> chunks;
+    chunks.reserve(chunks_.size());
+
+    for (size_t i = 0; i != chunks_.size(); ++i)
+    {
+      chunks.push_back(AllocateChunk());
+    }
+
+    for (size_t index = 0; index != size_; ++index)
+    {
+      const Location from = Locate(order[index]);
+      const Location to { chunks[index >> chunk_shift_], Slot(index) };
+
+      const Entity entity = reinterpret_cast<Entity*>(from.chunk)[from.slot];
+
+      reinterpret_cast<Entity*>(to.chunk)[to.slot] = entity;
+      sparse_->Assign(entity, static_cast<Entity>(index), archetype_);
+
+      for (const auto& component : components_)
+      {
+        RelocateComponent(*component.info, ComponentAt(from, component), ComponentAt(to, component));
+        MoveTicks(TicksAt(from.chunk, component.ticks), from.slot, TicksAt(to.chunk, component.ticks), to.slot);
+      }
+    }
+
+    for (size_t i = adopted_chunks_; i != chunks_.size(); ++i)
+    {
+      ::operator delete(chunks_[i], chunk_bytes_, std::align_val_t(chunk_alignment_));
+    }
+
+    chunks_ = std::move(chunks);
+    adopted_chunks_ = 0;
+
+    ++version_;
   }
-#endif
 
   ///
-  /// Static utility function for accessing and erasing at an index.
+  /// Constructs the component at the location. Empty components are not stored, components stored out of line are
+  /// allocated and only their handle is constructed at the location.
   ///
-  /// @tparam Component Component type to access.
+  /// @tparam Component Component type to emplace.
   ///
-  /// @param[in] storage This storage.
-  /// @param[in] index Index to erase at.
+  /// @param[in] location Chunk and slot to construct at.
+  /// @param[in] component Component data to move into the storage.
   ///
   template<typename Component>
-  static void AccessAndEraseAt(Storage<Entity>* storage, size_t index)
+  ALWAYS_INLINE void Emplace(const Location& location, Component&& component)
+  {
+    using Type = std::remove_cvref_t<Component>;
+    using Stored = StoredComponent<Type>;
+
+    if constexpr (!std::is_empty_v<Type>)
+    {
+      Stored* array = reinterpret_cast<Stored*>(location.chunk + offsets_.data()[GetComponentId<Type>()]);
+
+      if constexpr (IsStoredOutOfLine<Type>::value)
+      {
+        ::new (static_cast<void*>(array + location.slot)) Stored { new Type(std::forward<Component>(component)) };
+      }
+      else
+      {
+        ::new (static_cast<void*>(array + location.slot)) Type(std::forward<Component>(component));
+      }
+    }
+  }
+
+  ///
+  /// Destroys every component in the storage.
+  ///
+  void DestroyComponents() noexcept
   {
-    auto& component_array = storage->template Access<Component>();
-    component_array.SwapAndPop(component_array.begin() + index);
+    // Components in adopted chunks are owned by whoever provided the chunks
+    const size_t first = std::min(size_, adopted_chunks_ << chunk_shift_);
+
+    for (const auto& component : components_)
+    {
+      if (!component.info->destroy) continue;
+
+      for (size_t index = first; index < size_; index++)
+      {
+        component.info->destroy(ComponentAt(Locate(index), component));
+      }
+    }
   }
 
 private:
-  using EraseFunction = void (*)(Storage<Entity>* storage, const size_t);
-  using ClearFunction = void (*)(Storage<Entity>* storage);
+  static constexpr size_t cNoOffset = std::numeric_limits<size_t>::max();
+
+  static constexpr size_t cChangedTick = 0; // Index of the tick the chunk was last changed
+  static constexpr size_t cAddedTick = 1; // Index of the newest tick a row of the chunk was added
+  static constexpr size_t cRowTicks = 2; // Index of the tick the first row of the chunk was added
+
+  static constexpr Tick cNoTick = 0;
 
   SharedSparseArray<Entity>* sparse_;
-  Vector<Entity> dense_;
+  size_t size_;
+  size_t version_; // Incremented whenever rows are added, removed or moved
+
+  Vector<std::byte*> chunks_;
+  size_t adopted_chunks_; // Amount of chunks at the front that are not owned by the storage
+
+  size_t chunk_capacity_;
+  size_t chunk_shift_;
+  size_t chunk_bytes_;
+  size_t chunk_alignment_;
+
+  Vector<ComponentArray> components_;
+  Vector<const ComponentInfo*> empty_components_;
+  Vector<size_t> offsets_; // Offsets of the component arrays in a chunk indexed by component id
+  Vector<size_t> tick_offsets_; // Offsets of the tick arrays in a chunk indexed by component id
 
-  TypeMap<ErasedPtr<void>> component_arrays_;
+  const Tick* tick_;
 
-  // Indirect functions
-  EraseFunction erase_function_;
-  ClearFunction clear_function_;
+  ArchetypeId archetype_;
 
   // Used for debugging purposes
 #ifndef NDEBUG
   bool initialized_ = false;
-  Vector<std::string_view> components_;
 #endif
 };
 
+///
+/// Copy of a chunk of a storage that can be shared between threads.
+///
+/// The copy owns its components, they are destroyed with it. It does not depend on the storage and may outlive it.
+///
+/// @tparam Entity Entity of integral type.
+///
+template<std::unsigned_integral Entity>
+class SharedChunk final : public AtomicRefCounted
+{
+public:
+  ///
+  /// Constructor. Copies the chunk of the storage.
+  ///
+  /// @param[in] storage Storage to copy the chunk of.
+  /// @param[in] chunk Index of the chunk to copy.
+  /// @param[in] tick Tick the chunk is copied at.
+  ///
+  SharedChunk(const Storage<Entity>& storage, const size_t chunk, const Tick tick)
+    : size_(storage.ChunkSize(chunk)), bytes_(storage.ChunkBytes()), alignment_(storage.ChunkAlignment()), tick_(tick)
+  {
+    data_ = static_cast<std::byte*>(::operator new(bytes_, std::align_val_t(alignment_)));
+
+    storage.CopyChunk(chunk, data_);
+
+    for (const auto info : storage.ComponentInfos())
+    {
+      if (info->destroy) destructors_.push_back({ info->destroy, storage.ComponentOffset(info->id), info->size });
+    }
+  }
+
+  ///
+  /// Destructor.
+  ///
+  ~SharedChunk()
+  {
+    for (const auto& destructor : destructors_)
+    {
+      for (size_t row = 0; row != size_; ++row)
+      {
+        destructor.destroy(data_ + destructor.offset + row * destructor.size);
+      }
+    }
+
+    ::operator delete(data_, bytes_, std::align_val_t(alignment_));
+  }
+
+  SharedChunk(const SharedChunk&) = delete;
+  SharedChunk(SharedChunk&&) = delete;
+  SharedChunk& operator=(const SharedChunk&) = delete;
+  SharedChunk& operator=(SharedChunk&&) = delete;
+
+  ///
+  /// Returns the memory of the copy, laid out like a chunk of the storage.
+  ///
+  /// @return Pointer to the first byte of the copy.
+  ///
+  [[nodiscard]] std::byte* Data() const noexcept
+  {
+    return data_;
+  }
+
+  ///
+  /// Returns the amount of entities in the copy.
+  ///
+  /// @return Amount of entities.
+  ///
+  [[nodiscard]] size_t Size() const noexcept
+  {
+    return size_;
+  }
+
+  ///
+  /// Returns the entities of the copy.
+  ///
+  /// @return Pointer to the first entity.
+  ///
+  [[nodiscard]] const Entity* Entities() const noexcept
+  {
+    return reinterpret_cast<const Entity*>(data_);
+  }
+
+  ///
+  /// Returns the tick the chunk was copied at.
+  ///
+  /// @return Tick of the copy.
+  ///
+  [[nodiscard]] Tick CopyTick() const noexcept
+  {
+    return tick_;
+  }
+
+private:
+  ///
+  /// Destructor of a component array that is not trivially destructible.
+  ///
+  struct Destructor
+  {
+    void (*destroy)(void* component);
+    size_t offset;
+    size_t size;
+  };
+
+  std::byte* data_;
+  size_t size_;
+  size_t bytes_;
+  size_t alignment_;
+  Tick tick_;
+
+  Vector<Destructor> destructors_;
+};
+
 } // namespace plex
 
 #endif
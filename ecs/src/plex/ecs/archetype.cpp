@@ -1,29 +1,124 @@
 #include "plex/ecs/archetype.h"
 
+#include <bit>
+#include <map>
+#include <vector>
+
 namespace plex
 {
-void ViewRelations::AddView(ViewId id)
+ArchetypeId GetArchetypeId(const Vector<ComponentId>& components)
+{
+  static std::map<std::vector<ComponentId>, ArchetypeId> mappings;
+  static std::mutex mutex;
+
+  // Not performance critical. Only gets called once per unique archetype.
+
+  ASSERT(std::ranges::is_sorted(components), "Components must be sorted");
+
+  const std::scoped_lock<std::mutex> lock(mutex);
+
+  const auto [it, inserted] =
+    mappings.try_emplace(std::vector<ComponentId>(components.begin(), components.end()), mappings.size());
+
+  return it->second;
+}
+
+ViewId ViewRelations::InitializeView(
+  const ViewId global, const Vector<ComponentId>& required, const Vector<ComponentId>& excluded)
 {
-  if (id >= view_archetypes_.size()) view_archetypes_.resize(id + 1);
+  std::lock_guard lg(mutex_);
+
+  ViewId id = view_locals_.Find(global);
+
+  if (id == cInvalidView)
+  {
+    id = view_components_.size();
+
+    view_components_.push_back(required);
+    view_archetypes_.emplace_back();
+
+    AddView(id, excluded);
+
+    view_locals_.Assign(global, id);
+  }
+
+  return id;
+}
+
+ArchetypeId ViewRelations::InitializeArchetype(const ArchetypeId global, const Vector<ComponentId>& components)
+{
+  // Not performance critical. Only gets called once per unique archetype.
+
+  std::lock_guard lg(mutex_);
+
+  ArchetypeId id = archetype_locals_.Find(global);
+
+  if (id == cInvalidArchetype)
+  {
+    id = archetype_components_.size();
+
+    archetype_components_.push_back(components);
+    archetype_edges_.emplace_back();
+
+    AddArchetype(id);
+
+    archetype_locals_.Assign(global, id);
+  }
+
+  return id;
+}
 
+void ViewRelations::AddView(ViewId id, const Vector<ComponentId>& excluded)
+{
   auto& view_components = view_components_[id];
 
-  for (ArchetypeId i = 0; i < archetype_components_.size(); i++)
+  view_signatures_.Assign(id, view_components);
+  view_excluded_signatures_.Assign(id, excluded);
+
+  // Both view tables are always tested together, keep them the same shape
+  const size_t words = std::max(view_signatures_.Words(), view_excluded_signatures_.Words());
+
+  view_signatures_.Assure(id + 1, words);
+  view_excluded_signatures_.Assure(id + 1, words);
+
+  const size_t archetypes = archetype_signatures_.Rows();
+
+  Vector<uint64_t> mismatches;
+  mismatches.resize(archetypes, 0);
+
+  for (size_t word = 0; word < view_signatures_.Words(); word++)
   {
-    if (archetype_states_[i])
+    const uint64_t required = view_signatures_.Word(id, word);
+    const uint64_t excluded_word = view_excluded_signatures_.Word(id, word);
+
+    if (!required && !excluded_word) continue;
+
+    if (word >= archetype_signatures_.Words())
     {
-      auto& archetype_components = archetype_components_[i];
+      // No archetype has any of the components of the word
+      if (required) return;
 
-      if (std::includes(
-            archetype_components.begin(), archetype_components.end(), view_components.begin(), view_components.end()))
-      {
-        view_archetypes_[id].push_back(i);
+      continue;
+    }
+
+    const uint64_t* column = archetype_signatures_.Column(word);
+
+    for (size_t i = 0; i < archetypes; i++)
+    {
+      mismatches[i] |= (required & ~column[i]) | (excluded_word & column[i]);
+    }
+  }
+
+  for (ArchetypeId i = 0; i < archetypes; i++)
+  {
+    if (!mismatches[i])
+    {
+      view_archetypes_[id].push_back(i);
 
-        if (view_components.size() == archetype_components.size())
-        {
-          // Guarantee exact match O(1) operations
-          std::swap(view_archetypes_[id].front(), view_archetypes_[id].back());
-        }
+      if (view_components.size() == archetype_components_[i].size())
+      {
+        // Guarantee exact match O(1) operations
+        std::swap(view_archetypes_[id].front(), view_archetypes_[id].back());
       }
     }
   }
@@ -33,24 +128,102 @@ void ViewRelations::AddArchetype(ArchetypeId id)
 {
   auto& archetype_components = archetype_components_[id];
 
-  for (ViewId i = 0; i < view_components_.size(); i++)
+  archetype_signatures_.Assign(id, archetype_components);
+
+  const size_t views = view_signatures_.Rows();
+
+  Vector<uint64_t> mismatches;
+  mismatches.resize(views, 0);
+
+  for (size_t word = 0; word < view_signatures_.Words(); word++)
   {
-    if (view_states_[i])
+    const uint64_t archetype_word = archetype_signatures_.Word(id, word);
+
+    const uint64_t* required = view_signatures_.Column(word);
+    const uint64_t* excluded = view_excluded_signatures_.Column(word);
+
+    for (size_t i = 0; i < views; i++)
     {
-      auto& view_components = view_components_[i];
+      mismatches[i] |= (required[i] & ~archetype_word) | (excluded[i] & archetype_word);
+    }
+  }
 
-      if (std::includes(
-            archetype_components.begin(), archetype_components.end(), view_components.begin(), view_components.end()))
-      {
-        view_archetypes_[i].push_back(id);
+  for (ViewId i = 0; i < views; i++)
+  {
+    if (!mismatches[i])
+    {
+      view_archetypes_[i].push_back(id);
 
-        if (view_components.size() == archetype_components.size())
-        {
-          // Guarantee exact match O(1) operations
-          std::swap(view_archetypes_[i].front(), view_archetypes_[i].back());
-        }
+      if (view_components_[i].size() == archetype_components.size())
+      {
+        // Guarantee exact match O(1) operations
+        std::swap(view_archetypes_[i].front(), view_archetypes_[i].back());
       }
     }
   }
 }
+
+void ViewRelations::AddTransition(ArchetypeId source, ComponentId component, ArchetypeId destination)
+{
+  ASSERT(source < archetype_edges_.size(), "Source archetype not initialized");
+  ASSERT(destination < archetype_edges_.size(), "Destination archetype not initialized");
+
+  std::lock_guard lg(mutex_);
+
+  auto assure_edge = [component](Vector<ArchetypeEdge>& edges) -> ArchetypeEdge&
+  {
+    for (auto& edge : edges)
+    {
+      if (edge.component == component) return edge;
+    }
+
+    edges.push_back({ component, cInvalidArchetype, cInvalidArchetype });
+
+    return edges.back();
+  };
+
+  assure_edge(archetype_edges_[source]).add = destination;
+  assure_edge(archetype_edges_[destination]).remove = source;
+}
+
+namespace details
+{
+  void SignatureTable::Assign(const size_t row, const Vector<ComponentId>& components)
+  {
+    Assure(row + 1, components.empty() ? 0 : components.back() / cWordBits + 1);
+
+    for (size_t word = 0; word < words_; word++)
+    {
+      data_[word * capacity_ + row] = 0;
+    }
+
+    for (const auto component : components)
+    {
+      data_[component / cWordBits * capacity_ + row] |= uint64_t { 1 } << (component % cWordBits);
+    }
+  }
+
+  void SignatureTable::Assure(const size_t rows, const size_t words)
+  {
+    if (rows > capacity_ || words > words_)
+    {
+      const size_t capacity = rows > capacity_ ? std::max(std::bit_ceil(rows), size_t { 64 }) : capacity_;
+      const size_t new_words = std::max(words, words_);
+
+      Vector<uint64_t> data;
+      data.resize(capacity * new_words, 0);
+
+      for (size_t word = 0; word < words_; word++)
+      {
+        std::copy_n(data_.data() + word * capacity_, rows_, data.data() + word * capacity);
+      }
+
+      data_ = std::move(data);
+      capacity_ = capacity;
+      words_ = new_words;
+    }
+
+    rows_ = std::max(rows_, rows);
+  }
+} // namespace details
 } // namespace plex
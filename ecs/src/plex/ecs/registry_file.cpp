@@ -0,0 +1,530 @@
+#include "plex/ecs/registry.h"
+
+#include <bit>
+#include <cstring>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+#include "plex/ecs/registry_file.h"
+
+namespace plex
+{
+namespace
+{
+  ///
+  /// Appends raw data at the end of the buffer.
+  ///
+  /// @param[in] buffer Buffer to append to.
+  /// @param[in] data Data to append.
+  /// @param[in] size Size in bytes of the data.
+  ///
+  void AppendBytes(Vector<std::byte>& buffer, const void* data, const size_t size)
+  {
+    const size_t offset = buffer.size();
+
+    buffer.resize(offset + size);
+
+    if (size != 0) std::memcpy(buffer.data() + offset, data, size);
+  }
+
+  ///
+  /// Pads the buffer with zeros until its size is a multiple of the alignment.
+  ///
+  /// @param[in] buffer Buffer to pad.
+  /// @param[in] alignment Power of two alignment.
+  ///
+  void AlignBytes(Vector<std::byte>& buffer, const size_t alignment)
+  {
+    const size_t size = (buffer.size() + alignment - 1) & ~(alignment - 1);
+
+    buffer.resize(size, std::byte { 0 });
+  }
+
+  ///
+  /// Bounds checked access to the content of a snapshot.
+  ///
+  class FileReader
+  {
+  public:
+    ///
+    /// Constructor.
+    ///
+    /// @param[in] data Content of the snapshot.
+    /// @param[in] size Size in bytes of the snapshot.
+    ///
+    FileReader(const std::byte* data, const size_t size) noexcept : data_(data), size_(size) {}
+
+    ///
+    /// Returns the array at the offset of the snapshot.
+    ///
+    /// @tparam Type Type of the elements of the array.
+    ///
+    /// @param[in] offset Offset of the array.
+    /// @param[in] count Amount of elements in the array.
+    ///
+    /// @return Pointer to the array, nullptr if the array is not aligned or not entirely in the snapshot.
+    ///
+    template<typename Type>
+    [[nodiscard]] const Type* Read(const uint64_t offset, const uint64_t count = 1) const noexcept
+    {
+      if (offset > size_ || count > (size_ - offset) / sizeof(Type)) return nullptr;
+
+      if ((reinterpret_cast<uintptr_t>(data_) + offset) % alignof(Type) != 0) return nullptr;
+
+      return reinterpret_cast<const Type*>(data_ + offset);
+    }
+
+    ///
+    /// Returns whether or not the range is entirely in the snapshot.
+    ///
+    /// @param[in] offset Offset of the range.
+    /// @param[in] size Size in bytes of the range.
+    ///
+    /// @return True if the range is in the snapshot, false otherwise.
+    ///
+    [[nodiscard]] bool Contains(const uint64_t offset, const uint64_t size) const noexcept
+    {
+      return offset <= size_ && size <= size_ - offset;
+    }
+
+  private:
+    const std::byte* data_;
+    size_t size_;
+  };
+} // namespace
+
+bool Registry::Save(const char* path) const
+{
+  Vector<const Storage<Entity>*> storages;
+  Vector<const ComponentInfo*> components;
+
+  for (const auto storage : storages_)
+  {
+    if (!storage || storage->Size() == 0) continue;
+
+    storages.push_back(storage);
+
+    for (const auto info : storage->ComponentInfos())
+    {
+      // Pointers held by the components would be meaningless once loaded
+      if (info->copy) return false;
+
+      if (std::ranges::find(components, info) == components.end()) components.push_back(info);
+    }
+  }
+
+  const std::span<const Entity> recycled = entity_manager_.Recycled();
+
+  details::RegistryFileHeader header {};
+  header.magic = details::cRegistryFileMagic;
+  header.version = details::cRegistryFileVersion;
+  header.entity_size = sizeof(Entity);
+  header.generation_bits = EntityTraits<Entity>::cGenerationBits;
+  header.tick = tick_;
+  header.generated = entity_manager_.GeneratedCount();
+  header.recycled = recycled.size();
+  header.component_count = components.size();
+  header.archetype_count = storages.size();
+
+  Vector<std::byte> metadata;
+
+  AppendBytes(metadata, &header, sizeof(header));
+  AppendBytes(metadata, recycled.data(), recycled.size_bytes());
+  AlignBytes(metadata, alignof(uint64_t));
+
+  header.components = metadata.size();
+
+  size_t name = metadata.size() + components.size() * sizeof(details::RegistryFileComponent);
+
+  for (const auto info : components)
+  {
+    const details::RegistryFileComponent component { name, info->name.size(), info->size, info->alignment };
+
+    AppendBytes(metadata, &component, sizeof(component));
+
+    name += info->name.size();
+  }
+
+  for (const auto info : components)
+  {
+    AppendBytes(metadata, info->name.data(), info->name.size());
+  }
+
+  AlignBytes(metadata, alignof(uint64_t));
+
+  header.archetypes = metadata.size();
+
+  Vector<size_t> records;
+
+  for (const auto storage : storages)
+  {
+    const auto infos = storage->ComponentInfos();
+
+    details::RegistryFileArchetype archetype {};
+    archetype.size = storage->Size();
+    archetype.component_count = infos.size();
+    archetype.array_count = static_cast<uint64_t>(std::ranges::count(infos, nullptr, &ComponentInfo::empty_instance));
+    archetype.chunk_count = storage->ChunkCount();
+    archetype.chunk_capacity = storage->ChunkCapacity();
+    archetype.chunk_bytes = storage->ChunkBytes();
+    archetype.chunk_alignment = storage->ChunkAlignment();
+    archetype.chunk_stride = (storage->ChunkBytes() + storage->ChunkAlignment() - 1)
+                             & ~(storage->ChunkAlignment() - 1);
+
+    records.push_back(metadata.size());
+
+    AppendBytes(metadata, &archetype, sizeof(archetype));
+
+    for (const auto info : infos)
+    {
+      const uint64_t index = static_cast<uint64_t>(std::ranges::find(components, info) - components.begin());
+
+      AppendBytes(metadata, &index, sizeof(index));
+    }
+
+    for (const auto info : infos)
+    {
+      if (info->empty_instance) continue;
+
+      const details::RegistryFileArray array { static_cast<uint64_t>(
+                                             std::ranges::find(components, info) - components.begin()),
+        storage->ComponentOffset(info->id), storage->TicksOffset(info->id) };
+
+      AppendBytes(metadata, &array, sizeof(array));
+    }
+  }
+
+  // Chunks are laid out after the metadata, their offsets are patched into the records
+  size_t offset = metadata.size();
+
+  for (size_t i = 0; i != storages.size(); ++i)
+  {
+    auto archetype = reinterpret_cast<details::RegistryFileArchetype*>(metadata.data() + records[i]);
+
+    offset = (offset + archetype->chunk_alignment - 1) & ~(archetype->chunk_alignment - 1);
+
+    archetype->chunks = offset;
+
+    offset += archetype->chunk_count * archetype->chunk_stride;
+  }
+
+  std::memcpy(metadata.data(), &header, sizeof(header));
+
+  static constexpr std::byte cZeros[64] {};
+
+  // The file may be the mapping of a loaded snapshot whose chunks were adopted, it must not be truncated while they
+  // are written. The snapshot is written next to it and renamed over it once complete.
+  const std::string temporary = std::string(path) + ".tmp";
+
+  std::FILE* file = std::fopen(temporary.c_str(), "wb");
+
+  if (!file) return false;
+
+  bool success = std::fwrite(metadata.data(), 1, metadata.size(), file) == metadata.size();
+
+  offset = metadata.size();
+
+  for (size_t i = 0; i != storages.size() && success; ++i)
+  {
+    const auto archetype = reinterpret_cast<const details::RegistryFileArchetype*>(metadata.data() + records[i]);
+
+    const std::align_val_t alignment { archetype->chunk_alignment };
+    const auto buffer = static_cast<std::byte*>(::operator new(archetype->chunk_bytes, alignment));
+
+    for (size_t chunk = 0; chunk != archetype->chunk_count && success; ++chunk)
+    {
+      const size_t position = archetype->chunks + chunk * archetype->chunk_stride;
+
+      // Pad up to the alignment of the chunk
+      for (; offset != position && success; offset += std::min(position - offset, sizeof(cZeros)))
+      {
+        const size_t padding = std::min(position - offset, sizeof(cZeros));
+
+        success = std::fwrite(cZeros, 1, padding, file) == padding;
+      }
+
+      // Chunks are written whole, the component arrays and ticks are at the same offsets when loaded
+      const size_t bytes = archetype->chunk_bytes;
+
+      std::memset(buffer, 0, bytes);
+      storages[i]->CopyChunk(chunk, buffer);
+
+      success = success && std::fwrite(buffer, 1, bytes, file) == bytes;
+
+      offset += bytes;
+    }
+
+    ::operator delete(buffer, alignment);
+  }
+
+  success = std::fclose(file) == 0 && success;
+
+  std::error_code error;
+
+  if (success) std::filesystem::rename(temporary, path, error);
+
+  if (!success || error)
+  {
+    std::remove(temporary.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+bool Registry::Load(const char* path, const Vector<const ComponentInfo*>& components)
+{
+  if (entity_manager_.GeneratedCount() != 0) return false;
+
+  MappedFile file;
+
+  if (!file.Open(path)) return false;
+
+  const FileReader reader(file.Data(), file.Size());
+
+  const auto header = reader.Read<details::RegistryFileHeader>(0);
+
+  if (!header || header->magic != details::cRegistryFileMagic || header->version != details::cRegistryFileVersion
+      || header->entity_size != sizeof(Entity) || header->generation_bits != EntityTraits<Entity>::cGenerationBits
+      || header->generated > EntityTraits<Entity>::cIndexMask)
+  {
+    return false;
+  }
+
+  const auto recycled = reader.Read<Entity>(sizeof(details::RegistryFileHeader), header->recycled);
+  const auto table = reader.Read<details::RegistryFileComponent>(header->components, header->component_count);
+
+  if (!recycled || !table) return false;
+
+  // Match the components of the snapshot with the component types by name
+  Vector<const ComponentInfo*> infos;
+  infos.reserve(header->component_count);
+
+  for (size_t i = 0; i != header->component_count; ++i)
+  {
+    const auto name = reader.Read<char>(table[i].name, table[i].name_size);
+
+    if (!name) return false;
+
+    const auto info = std::ranges::find(components, std::string_view(name, table[i].name_size), &ComponentInfo::name);
+
+    if (info == components.end() || (*info)->size != table[i].size || (*info)->alignment != table[i].alignment
+        || (*info)->copy)
+    {
+      return false;
+    }
+
+    infos.push_back(*info);
+  }
+
+  // Validate every archetype before loading anything
+  Vector<const details::RegistryFileArchetype*> archetypes;
+  archetypes.reserve(header->archetype_count);
+
+  // Sorted component indices of every archetype, an archetype may only be in the snapshot once
+  Vector<Vector<uint64_t>> component_sets;
+  component_sets.reserve(header->archetype_count);
+
+  uint64_t offset = header->archetypes;
+  uint64_t live = 0;
+
+  for (size_t i = 0; i != header->archetype_count; ++i)
+  {
+    const auto archetype = reader.Read<details::RegistryFileArchetype>(offset);
+
+    if (!archetype) return false;
+
+    offset += sizeof(details::RegistryFileArchetype);
+
+    const auto indices = reader.Read<uint64_t>(offset, archetype->component_count);
+
+    offset += archetype->component_count * sizeof(uint64_t);
+
+    const auto arrays = reader.Read<details::RegistryFileArray>(offset, archetype->array_count);
+
+    offset += archetype->array_count * sizeof(details::RegistryFileArray);
+
+    const uint64_t capacity = archetype->chunk_capacity;
+    const uint64_t chunks_size = (archetype->chunk_count - 1) * archetype->chunk_stride + archetype->chunk_bytes;
+
+    if (!indices || !arrays || !std::has_single_bit(capacity) || capacity > file.Size() || archetype->size == 0
+        || archetype->chunk_count != (archetype->size + capacity - 1) / capacity
+        || archetype->chunk_bytes < capacity * sizeof(Entity) || archetype->chunk_stride < archetype->chunk_bytes
+        || archetype->chunk_count > file.Size() / archetype->chunk_stride
+        || !reader.Contains(archetype->chunks, chunks_size)
+        || archetype->chunks % alignof(Entity) != 0 || archetype->chunk_stride % alignof(Entity) != 0)
+    {
+      return false;
+    }
+
+    Vector<uint64_t> sorted(indices, indices + archetype->component_count);
+    std::ranges::sort(sorted);
+
+    if (std::ranges::adjacent_find(sorted) != sorted.end()
+        || std::ranges::find(component_sets, sorted) != component_sets.end())
+    {
+      return false;
+    }
+
+    size_t stored = 0;
+
+    for (size_t j = 0; j != archetype->component_count; ++j)
+    {
+      if (indices[j] >= infos.size()) return false;
+
+      if (!infos[indices[j]]->empty_instance) ++stored;
+    }
+
+    if (stored != archetype->array_count) return false;
+
+    for (size_t j = 0; j != archetype->array_count; ++j)
+    {
+      const auto& array = arrays[j];
+
+      // Components are unique, every stored component has exactly one array
+      if (std::ranges::find(indices, indices + archetype->component_count, array.component)
+            == indices + archetype->component_count
+          || std::ranges::find(arrays, arrays + j, array.component, &details::RegistryFileArray::component) != arrays + j
+          || infos[array.component]->empty_instance || array.offset > archetype->chunk_bytes
+          || capacity * infos[array.component]->size > archetype->chunk_bytes - array.offset
+          || array.ticks > archetype->chunk_bytes || array.ticks % alignof(Tick) != 0
+          || (capacity + 2) * sizeof(Tick) > archetype->chunk_bytes - array.ticks)
+      {
+        return false;
+      }
+    }
+
+    archetypes.push_back(archetype);
+    component_sets.push_back(std::move(sorted));
+    live += archetype->size;
+  }
+
+  // Every generated identifier is either alive in exactly one archetype or recycled
+  if (header->generated != live + header->recycled) return false;
+
+  Vector<uint8_t> used;
+  used.resize(header->generated, 0);
+
+  const auto use = [&used](const Entity entity)
+  {
+    const size_t index = EntityTraits<Entity>::Index(entity);
+
+    if (index >= used.size() || used[index]) return false;
+
+    used[index] = 1;
+
+    return true;
+  };
+
+  for (const auto archetype : archetypes)
+  {
+    for (size_t chunk = 0; chunk != archetype->chunk_count; ++chunk)
+    {
+      const size_t rows = std::min(archetype->chunk_capacity, archetype->size - chunk * archetype->chunk_capacity);
+      const Entity* entities = reader.Read<Entity>(archetype->chunks + chunk * archetype->chunk_stride, rows);
+
+      if (!std::all_of(entities, entities + rows, use)) return false;
+    }
+  }
+
+  if (!std::all_of(recycled, recycled + header->recycled, use)) return false;
+
+  bool adopted = false;
+
+  for (const auto archetype : archetypes)
+  {
+    const auto indices = reinterpret_cast<const uint64_t*>(archetype + 1);
+    const auto arrays = reinterpret_cast<const details::RegistryFileArray*>(indices + archetype->component_count);
+
+    Vector<const ComponentInfo*> archetype_components;
+    archetype_components.reserve(archetype->component_count);
+
+    for (size_t j = 0; j != archetype->component_count; ++j)
+    {
+      archetype_components.push_back(infos[indices[j]]);
+    }
+
+    const ArchetypeId id = AssureStorage(archetype_components);
+
+    Storage<Entity>& storage = *storages_[id];
+
+    std::byte* chunks = file.Data() + archetype->chunks;
+
+    bool same_layout = storage.ChunkCapacity() == archetype->chunk_capacity
+                       && storage.ChunkBytes() == archetype->chunk_bytes
+                       && storage.ChunkAlignment() == archetype->chunk_alignment
+                       && reinterpret_cast<uintptr_t>(chunks) % archetype->chunk_alignment == 0
+                       && archetype->chunk_stride % archetype->chunk_alignment == 0;
+
+    for (size_t j = 0; j != archetype->array_count && same_layout; ++j)
+    {
+      const ComponentId component = infos[arrays[j].component]->id;
+
+      same_layout = storage.ComponentOffset(component) == arrays[j].offset
+                    && storage.TicksOffset(component) == arrays[j].ticks;
+    }
+
+    if (same_layout)
+    {
+      Vector<std::byte*> adopted_chunks;
+      adopted_chunks.reserve(archetype->chunk_count);
+
+      for (size_t chunk = 0; chunk != archetype->chunk_count; ++chunk)
+      {
+        adopted_chunks.push_back(chunks + chunk * archetype->chunk_stride);
+      }
+
+      storage.Adopt({ adopted_chunks.data(), adopted_chunks.size() }, archetype->size);
+
+      adopted = true;
+    }
+    else
+    {
+      // Offsets of the arrays in the chunks of the snapshot indexed by component id
+      Vector<size_t> offsets;
+      Vector<size_t> tick_offsets;
+
+      for (size_t j = 0; j != archetype->array_count; ++j)
+      {
+        const ComponentId component = infos[arrays[j].component]->id;
+
+        if (component >= offsets.size())
+        {
+          offsets.resize(component + 1, 0);
+          tick_offsets.resize(component + 1, 0);
+        }
+
+        offsets[component] = arrays[j].offset;
+        tick_offsets[component] = arrays[j].ticks;
+      }
+
+      for (size_t chunk = 0; chunk != archetype->chunk_count; ++chunk)
+      {
+        const size_t rows = std::min(archetype->chunk_capacity, archetype->size - chunk * archetype->chunk_capacity);
+
+        storage.InsertChunk(chunks + chunk * archetype->chunk_stride, rows, { offsets.data(), offsets.size() },
+          { tick_offsets.data(), tick_offsets.size() });
+      }
+    }
+
+    if (!observers_.Empty()) [[unlikely]]
+    {
+      for (size_t chunk = 0; chunk != storage.ChunkCount(); ++chunk)
+      {
+        observers_.RecordMany(
+          cInvalidArchetype, id, std::span<const Entity>(storage.ChunkEntities(chunk), storage.ChunkSize(chunk)));
+      }
+    }
+  }
+
+  entity_manager_.Restore(header->generated, { recycled, header->recycled });
+
+  tick_ = header->tick;
+
+  // Adopted chunks live in the mapping, it is kept until the registry is destroyed
+  if (adopted) mapped_files_.push_back(std::move(file));
+
+  return true;
+}
+} // namespace plex
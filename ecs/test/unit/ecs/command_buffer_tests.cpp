@@ -0,0 +1,239 @@
+#include "plex/ecs/command_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+namespace plex::tests
+{
+namespace
+{
+  struct Position
+  {
+    float x;
+  };
+
+  struct Velocity
+  {
+    float x;
+  };
+
+  struct BatchCounter
+  {
+    size_t batches = 0;
+    size_t entities = 0;
+
+    Observers<Entity>::Handler Handler()
+    {
+      Observers<Entity>::Handler handler;
+      handler.Bind(
+        [this](std::span<const Entity> created)
+        {
+          batches++;
+          entities += created.size();
+        });
+
+      return handler;
+    }
+  };
+} // namespace
+
+TEST(CommandBuffer_Tests, Create_AfterInitialization_NotApplied)
+{
+  Registry registry;
+  CommandBuffer buffer;
+
+  buffer.Create(Position { 1 });
+
+  EXPECT_EQ(buffer.Size(), 1);
+  EXPECT_EQ(registry.EntityCount(), 0);
+}
+
+TEST(CommandBuffer_Tests, Playback_InterleavedCreates_OneBatchPerArchetype)
+{
+  constexpr size_t amount = 5000;
+
+  Registry registry;
+  CommandBuffer buffer;
+  BatchCounter counter;
+
+  registry.OnCreate<>(counter.Handler());
+
+  for (size_t i = 0; i < amount; i++)
+  {
+    buffer.Create(Position { static_cast<float>(i) }, std::to_string(i));
+    buffer.Create(Velocity { static_cast<float>(i) });
+  }
+
+  buffer.Playback(registry);
+  registry.FlushObservers();
+
+  EXPECT_TRUE(buffer.Empty());
+  EXPECT_EQ(counter.batches, 2);
+  EXPECT_EQ(counter.entities, amount * 2);
+  EXPECT_EQ((registry.EntityCount<Position, std::string>()), amount);
+  EXPECT_EQ(registry.EntityCount<Velocity>(), amount);
+
+  EntityForEach(registry.ViewFor<Position, std::string>(),
+    [](const Position& position, const std::string& name)
+    { EXPECT_EQ(name, std::to_string(static_cast<size_t>(position.x))); });
+}
+
+TEST(CommandBuffer_Tests, Playback_DestroyAddRemove_AppliedInOrder)
+{
+  Registry registry;
+  CommandBuffer buffer;
+
+  const Entity first = registry.Create(Position { 1 });
+  const Entity second = registry.Create(Position { 2 }, Velocity { 2 });
+  const Entity third = registry.Create(Position { 3 });
+
+  buffer.Add(first, Velocity { 1 });
+  buffer.Remove<Velocity>(first);
+  buffer.Add(first, std::string("first"));
+  buffer.Remove<Position>(second);
+  buffer.Destroy(third);
+
+  buffer.Playback(registry);
+
+  EXPECT_TRUE((registry.HasComponents<Position, std::string>(first)));
+  EXPECT_FALSE(registry.HasComponents<Velocity>(first));
+  EXPECT_EQ(registry.Unpack<std::string>(first), "first");
+  EXPECT_FALSE(registry.HasComponents<Position>(second));
+  EXPECT_TRUE(registry.HasComponents<Velocity>(second));
+  EXPECT_FALSE(registry.Valid(third));
+}
+
+TEST(CommandBuffer_Tests, Playback_InvalidEntity_Ignored)
+{
+  Registry registry;
+  CommandBuffer buffer;
+
+  const Entity entity = registry.Create(Position { 1 });
+
+  buffer.Destroy(entity);
+  buffer.Destroy(entity);
+  buffer.Add(entity, Velocity { 1 });
+
+  buffer.Playback(registry);
+
+  EXPECT_FALSE(registry.Valid(entity));
+  EXPECT_EQ(registry.EntityCount(), 0);
+}
+
+TEST(CommandBuffer_Tests, Playback_DuplicateAddRemove_LastAddWins)
+{
+  Registry registry;
+  CommandBuffer buffer;
+
+  const Entity first = registry.Create(Position { 1 });
+  const Entity second = registry.Create(Position { 2 });
+
+  buffer.Add(first, Velocity { 1 });
+  buffer.Add(first, Velocity { 2 });
+  buffer.Add(first, Position { 3 });
+  buffer.Remove<Velocity>(second);
+  buffer.Remove<Position>(second);
+  buffer.Remove<Position>(second);
+
+  buffer.Playback(registry);
+
+  EXPECT_EQ(registry.Unpack<Velocity>(first).x, 2);
+  EXPECT_EQ(registry.Unpack<Position>(first).x, 3);
+  EXPECT_TRUE(registry.Valid(second));
+  EXPECT_FALSE(registry.HasComponents<Position>(second));
+}
+
+TEST(CommandBuffer_Tests, Playback_CreatesInDifferentOrder_OneBatch)
+{
+  Registry registry;
+  CommandBuffer buffer;
+  BatchCounter counter;
+
+  registry.OnCreate<>(counter.Handler());
+
+  buffer.Create(Position { 1 }, Velocity { 2 });
+  buffer.Create(Velocity { 4 }, Position { 3 });
+
+  buffer.Playback(registry);
+  registry.FlushObservers();
+
+  EXPECT_EQ(counter.batches, 1);
+  EXPECT_EQ((registry.EntityCount<Position, Velocity>()), 2);
+
+  EntityForEach(registry.ViewFor<Position, Velocity>(),
+    [](const Position& position, const Velocity& velocity) { EXPECT_EQ(velocity.x, position.x + 1); });
+}
+
+TEST(CommandBuffer_Tests, Playback_MultipleBuffers_CreatesMerged)
+{
+  Registry registry;
+  BatchCounter counter;
+
+  registry.OnCreate<>(counter.Handler());
+
+  CommandBuffers pool;
+
+  CommandBuffer& buffer1 = pool.Obtain();
+  CommandBuffer& buffer2 = pool.Obtain();
+
+  buffer1.Create(Position { 1 });
+  buffer2.Create(Position { 2 });
+  buffer1.Create(Position { 3 });
+
+  pool.Playback(registry);
+  registry.FlushObservers();
+
+  EXPECT_EQ(counter.batches, 1);
+  EXPECT_EQ(registry.EntityCount<Position>(), 3);
+  EXPECT_TRUE(buffer1.Empty());
+  EXPECT_TRUE(buffer2.Empty());
+}
+
+TEST(CommandBuffer_Tests, Clear_NonTrivialPayloads_Destroyed)
+{
+  auto shared = std::make_shared<int>(0);
+
+  {
+    CommandBuffer buffer;
+
+    buffer.Create(shared);
+    buffer.Add(0, shared);
+
+    EXPECT_EQ(shared.use_count(), 3);
+
+    buffer.Clear();
+
+    EXPECT_EQ(shared.use_count(), 1);
+    EXPECT_TRUE(buffer.Empty());
+
+    buffer.Create(shared);
+  }
+
+  EXPECT_EQ(shared.use_count(), 1);
+}
+
+TEST(CommandBuffer_Tests, Create_LargePayload_OwnBlock)
+{
+  struct Large
+  {
+    char data[CommandBuffer::cBlockSize * 2];
+  };
+
+  Registry registry;
+  CommandBuffer buffer;
+
+  auto large = std::make_unique<Large>();
+  large->data[0] = 'a';
+
+  buffer.Create(Position { 1 });
+  buffer.Create(*large);
+  buffer.Create(Position { 2 });
+
+  buffer.Playback(registry);
+
+  EXPECT_EQ(registry.EntityCount<Position>(), 2);
+  EXPECT_EQ(registry.EntityCount<Large>(), 1);
+}
+} // namespace plex::tests
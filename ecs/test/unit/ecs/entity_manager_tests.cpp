@@ -50,7 +50,7 @@ TEST(EntityManager_Tests, Obtain_AfterRelease_CorrectlyRecycled)
   manager.Release(manager.Obtain());
 
   EXPECT_EQ(manager.CirculatingCount(), 0);
-  EXPECT_EQ(manager.Obtain(), 0);
+  EXPECT_EQ(EntityTraits<size_t>::Index(manager.Obtain()), 0);
   EXPECT_EQ(manager.CirculatingCount(), 1);
 }
 
@@ -88,4 +88,85 @@ TEST(EntityManager_Tests, Obtain_ReleaseAll_ResetGenerator)
   EXPECT_EQ(manager.CirculatingCount(), 1);
 }
 
+TEST(EntityManager_Tests, GenerateMany_AfterRelease_ContiguousNewIds)
+{
+  EntityManager<size_t> manager;
+
+  manager.Release(manager.Obtain());
+
+  EXPECT_EQ(manager.GenerateMany(10), 1);
+  EXPECT_EQ(manager.Generate(), 11);
+
+  EXPECT_EQ(manager.RecycledCount(), 1);
+  EXPECT_EQ(manager.CirculatingCount(), 11);
+}
+
+TEST(EntityManager_Tests, Generate_OutOfIndices_Terminates)
+{
+  EntityManager<size_t> manager;
+
+  static_cast<void>(manager.GenerateMany(EntityTraits<size_t>::cIndexMask));
+
+  EXPECT_DEATH(static_cast<void>(manager.Generate()), "");
+  EXPECT_DEATH(static_cast<void>(manager.GenerateMany(1)), "");
+}
+
+TEST(EntityManager_Tests, ReleaseMany_Multiple_IncreaseRecycledCount)
+{
+  EntityManager<size_t> manager;
+
+  size_t entities[] = { manager.Obtain(), manager.Obtain(), manager.Obtain() };
+
+  manager.ReleaseMany(entities, 2);
+
+  EXPECT_EQ(manager.RecycledCount(), 2);
+  EXPECT_EQ(manager.CirculatingCount(), 1);
+}
+
+TEST(EntityManager_Tests, Obtain_AfterRelease_NextGeneration)
+{
+  using Traits = EntityTraits<size_t, 8>;
+
+  EntityManager<size_t, 8> manager;
+
+  const size_t entity = manager.Obtain();
+
+  manager.Release(entity);
+
+  const size_t recycled = manager.Obtain();
+
+  EXPECT_EQ(Traits::Index(recycled), Traits::Index(entity));
+  EXPECT_EQ(Traits::Generation(recycled), Traits::Generation(entity) + 1);
+  EXPECT_NE(recycled, entity);
+}
+
+TEST(EntityManager_Tests, Restore_SavedState_SameIdentifiers)
+{
+  EntityManager<size_t> manager;
+
+  const size_t entities[] = { manager.Obtain(), manager.Obtain(), manager.Obtain() };
+
+  manager.Release(entities[1]);
+
+  EntityManager<size_t> restored;
+
+  restored.Restore(manager.GeneratedCount(), manager.Recycled());
+
+  EXPECT_EQ(restored.CirculatingCount(), 2);
+  EXPECT_EQ(restored.RecycledCount(), 1);
+  EXPECT_EQ(restored.Obtain(), manager.Obtain());
+  EXPECT_EQ(restored.Obtain(), manager.Obtain());
+}
+
+TEST(EntityTraits_Tests, Combine_IndexGeneration_RoundTrip)
+{
+  using Traits = EntityTraits<uint32_t, 8>;
+
+  const uint32_t entity = Traits::Combine(1234, 5);
+
+  EXPECT_EQ(Traits::Index(entity), 1234);
+  EXPECT_EQ(Traits::Generation(entity), 5);
+  EXPECT_EQ(Traits::Index(Traits::NextGeneration(entity)), 1234);
+}
+
 } // namespace plex::tests
\ No newline at end of file
@@ -0,0 +1,265 @@
+#include "plex/ecs/hierarchy.h"
+
+#include <gtest/gtest.h>
+
+#include "plex/async/sync_wait.h"
+#include "plex/random/pcg.h"
+
+namespace plex::tests
+{
+namespace
+{
+  struct Local
+  {
+    int value;
+  };
+
+  struct World
+  {
+    int value;
+  };
+
+  struct Tag
+  {
+    int value;
+  };
+
+  ///
+  /// Creates a forest where every node is a child of a random node created before it, in two archetypes.
+  ///
+  Vector<Entity> CreateForest(Registry& registry, const size_t amount)
+  {
+    Vector<Entity> entities;
+
+    PCG random;
+
+    for (size_t i = 0; i < amount; i++)
+    {
+      const int value = static_cast<int>(i % 7) + 1;
+
+      const Entity entity = i % 3 == 0 ? registry.Create(Local { value }, World { 0 })
+                                       : registry.Create(Local { value }, World { 0 }, Tag { value });
+
+      if (i % 50 != 0) SetParent(registry, entity, entities[random(static_cast<uint32_t>(i))]);
+      else
+      {
+        registry.Unpack<World>(entity).value = value;
+      }
+
+      entities.push_back(entity);
+    }
+
+    // Reparenting breaks the order of the storages
+    for (size_t i = 1; i < amount; i += 10)
+    {
+      SetParent(registry, entities[i], entities[random(static_cast<uint32_t>(i))]);
+    }
+
+    return entities;
+  }
+
+  ///
+  /// Returns the expected propagated value, the sum of the local values of the entity and its ancestors.
+  ///
+  int ExpectedWorld(Registry& registry, Entity entity)
+  {
+    int value = registry.Unpack<Local>(entity).value;
+
+    while (registry.HasComponents<Parent>(entity))
+    {
+      entity = registry.Unpack<Parent>(entity).entity;
+      value += registry.Unpack<Local>(entity).value;
+    }
+
+    return value;
+  }
+
+  ///
+  /// Expects every storage of the entities with a parent to be sorted by depth.
+  ///
+  void ExpectSortedByDepth(Registry& registry)
+  {
+    for (auto sub_view : registry.ViewFor<Parent>())
+    {
+      Vector<uint32_t> depths;
+
+      for (auto it = sub_view.begin<Parent>(); it != sub_view.end<Parent>(); ++it)
+      {
+        depths.push_back(std::get<Parent*>(*it)->depth);
+      }
+
+      EXPECT_TRUE(std::ranges::is_sorted(depths));
+    }
+  }
+
+  ///
+  /// Returns the layout version of every storage of the entities with a parent.
+  ///
+  Vector<size_t> ParentVersions(Registry& registry)
+  {
+    Vector<size_t> versions;
+
+    for (auto sub_view : registry.ViewFor<Parent>())
+    {
+      versions.push_back(sub_view.Version());
+    }
+
+    return versions;
+  }
+} // namespace
+
+TEST(Hierarchy_Tests, SetParent_Chain_DepthsFollow)
+{
+  Registry registry;
+
+  const Entity root = registry.Create();
+  const Entity child = registry.Create();
+  const Entity grandchild = registry.Create();
+
+  SetParent(registry, grandchild, child);
+  SetParent(registry, child, root);
+
+  EXPECT_EQ(registry.Unpack<Parent>(child).entity, root);
+  EXPECT_EQ(registry.Unpack<Parent>(child).depth, 1);
+  EXPECT_EQ(registry.Unpack<Parent>(grandchild).depth, 2);
+  EXPECT_FALSE(registry.HasComponents<Parent>(root));
+  EXPECT_EQ(registry.Unpack<Children>(root).entities.size(), 1);
+
+  RemoveParent(registry, child);
+
+  EXPECT_FALSE(registry.HasComponents<Parent>(child));
+  EXPECT_FALSE(registry.HasComponents<Children>(root));
+  EXPECT_EQ(registry.Unpack<Parent>(grandchild).depth, 1);
+}
+
+TEST(Hierarchy_Tests, SetParent_Reparent_MovedBetweenChildren)
+{
+  Registry registry;
+
+  const Entity first = registry.Create();
+  const Entity second = registry.Create();
+  const Entity other = registry.Create();
+  const Entity entity = registry.Create();
+
+  SetParent(registry, second, first);
+  SetParent(registry, entity, other);
+  SetParent(registry, entity, second);
+
+  EXPECT_FALSE(registry.HasComponents<Children>(other));
+  EXPECT_EQ(registry.Unpack<Children>(second).entities[0], entity);
+  EXPECT_EQ(registry.Unpack<Parent>(entity).depth, 2);
+}
+
+TEST(Hierarchy_Tests, DestroyHierarchy_Subtree_DescendantsDestroyed)
+{
+  Registry registry;
+
+  const Entity root = registry.Create();
+  const Entity child = registry.Create();
+  const Entity sibling = registry.Create();
+  const Entity grandchild = registry.Create();
+
+  SetParent(registry, child, root);
+  SetParent(registry, sibling, root);
+  SetParent(registry, grandchild, child);
+
+  DestroyHierarchy(registry, child);
+
+  EXPECT_FALSE(registry.Valid(child));
+  EXPECT_FALSE(registry.Valid(grandchild));
+  EXPECT_TRUE(registry.Valid(sibling));
+  EXPECT_EQ(registry.Unpack<Children>(root).entities.size(), 1);
+  EXPECT_EQ(registry.EntityCount(), 2);
+}
+
+TEST(Hierarchy_Tests, SortHierarchies_Reparented_SortedByDepth)
+{
+  Registry registry;
+
+  CreateForest(registry, 5000);
+
+  SortHierarchies(registry);
+
+  ExpectSortedByDepth(registry);
+}
+
+TEST(Hierarchy_Tests, SortHierarchies_Unchanged_NothingMoved)
+{
+  Registry registry;
+
+  CreateForest(registry, 5000);
+
+  SortHierarchies(registry);
+
+  const Vector<size_t> versions = ParentVersions(registry);
+
+  SortHierarchies(registry);
+
+  EXPECT_EQ(ParentVersions(registry), versions);
+}
+
+TEST(Hierarchy_Tests, SortHierarchies_ChangedAfterSort_SortedAgain)
+{
+  Registry registry;
+  PCG random;
+
+  const Vector<Entity> entities = CreateForest(registry, 5000);
+
+  SortHierarchies(registry);
+
+  // Depths change without moving any entity
+  for (size_t i = 2; i < entities.size(); i += 10)
+  {
+    SetParent(registry, entities[i], entities[random(static_cast<uint32_t>(i))]);
+  }
+
+  SortHierarchies(registry);
+
+  ExpectSortedByDepth(registry);
+
+  // Entities move between storages without changing depth
+  for (size_t i = 1; i < entities.size(); i += 3)
+  {
+    if (registry.HasComponents<Tag>(entities[i])) registry.Remove<Tag>(entities[i]);
+  }
+
+  SortHierarchies(registry);
+
+  ExpectSortedByDepth(registry);
+}
+
+TEST(Hierarchy_Tests, PropagateHierarchies_Forest_ParentsBeforeChildren)
+{
+  Registry registry;
+
+  const Vector<Entity> entities = CreateForest(registry, 5000);
+
+  PropagateHierarchies<Local, World>(registry,
+    [](const World& parent, const Local& local, World& world) { world.value = parent.value + local.value; });
+
+  for (const Entity entity : entities)
+  {
+    EXPECT_EQ(registry.Unpack<World>(entity).value, ExpectedWorld(registry, entity));
+  }
+}
+
+TEST(Hierarchy_Tests, ParallelPropagateHierarchies_Forest_ParentsBeforeChildren)
+{
+  Registry registry;
+
+  const Vector<Entity> entities = CreateForest(registry, 20000);
+
+  ThreadPool pool(4, false);
+
+  SyncWait(ParallelPropagateHierarchies<Local, World>(
+    registry,
+    pool,
+    [](const World& parent, const Local& local, World& world) { world.value = parent.value + local.value; },
+    100));
+
+  for (const Entity entity : entities)
+  {
+    EXPECT_EQ(registry.Unpack<World>(entity).value, ExpectedWorld(registry, entity));
+  }
+}
+} // namespace plex::tests
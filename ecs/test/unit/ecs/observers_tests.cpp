@@ -0,0 +1,220 @@
+#include "plex/ecs/observers.h"
+
+#include <gtest/gtest.h>
+
+#include "plex/ecs/registry.h"
+
+namespace plex::tests
+{
+namespace
+{
+  struct Position
+  {
+    float x;
+  };
+
+  struct Velocity
+  {
+    float x;
+  };
+
+  struct Recorder
+  {
+    Vector<Vector<Entity>> batches;
+
+    Observers<Entity>::Handler Handler()
+    {
+      Observers<Entity>::Handler handler;
+      handler.Bind([this](std::span<const Entity> entities)
+        { batches.push_back(Vector<Entity>(entities.begin(), entities.end())); });
+
+      return handler;
+    }
+
+    size_t Count() const
+    {
+      size_t count = 0;
+
+      for (const auto& batch : batches)
+      {
+        count += batch.size();
+      }
+
+      return count;
+    }
+  };
+} // namespace
+
+TEST(Observers_Tests, OnCreate_CreateMany_SingleBatch)
+{
+  Registry registry;
+  Recorder recorder;
+
+  registry.OnCreate<Position>(recorder.Handler());
+
+  auto entities = registry.CreateMany(5000, Position { 1 });
+  registry.Create(Velocity { 1 });
+
+  EXPECT_TRUE(recorder.batches.empty());
+
+  registry.FlushObservers();
+
+  ASSERT_EQ(recorder.batches.size(), 1);
+  EXPECT_EQ(recorder.batches[0].size(), 5000);
+  EXPECT_EQ(recorder.batches[0].front(), *entities.begin());
+  EXPECT_EQ(recorder.batches[0].back(), *(entities.end() - 1));
+
+  registry.FlushObservers();
+
+  EXPECT_EQ(recorder.batches.size(), 1);
+}
+
+TEST(Observers_Tests, OnCreate_DifferentArchetypes_BatchPerArchetype)
+{
+  Registry registry;
+  Recorder recorder;
+
+  registry.OnCreate<Position>(recorder.Handler());
+
+  registry.Create(Position { 1 });
+  registry.Create(Position { 1 }, Velocity { 1 });
+  registry.Create(Position { 2 });
+
+  registry.FlushObservers();
+
+  ASSERT_EQ(recorder.batches.size(), 2);
+  EXPECT_EQ(recorder.batches[0].size(), 2);
+  EXPECT_EQ(recorder.batches[1].size(), 1);
+}
+
+TEST(Observers_Tests, OnAdd_AddComponent_OnlyWhenStartsMatching)
+{
+  Registry registry;
+  Recorder created;
+  Recorder added;
+
+  registry.OnCreate<Position, Velocity>(created.Handler());
+  registry.OnAdd<Position, Velocity>(added.Handler());
+
+  const Entity entity = registry.Create(Position { 1 });
+  registry.Create(Position { 1 }, Velocity { 1 });
+  registry.Add(entity, Velocity { 1 });
+  registry.Add(entity, 1);
+
+  registry.FlushObservers();
+
+  EXPECT_EQ(created.Count(), 1);
+  EXPECT_EQ(added.Count(), 2);
+}
+
+TEST(Observers_Tests, OnRemove_RemoveAndDestroy_OnlyWhenStopsMatching)
+{
+  Registry registry;
+  Recorder destroyed;
+  Recorder removed;
+
+  registry.OnDestroy<Position>(destroyed.Handler());
+  registry.OnRemove<Position>(removed.Handler());
+
+  const Entity first = registry.Create(Position { 1 }, Velocity { 1 });
+  const Entity second = registry.Create(Position { 1 }, Velocity { 1 });
+  registry.Create(Velocity { 1 });
+
+  registry.FlushObservers();
+
+  registry.Remove<Velocity>(first);
+  registry.Remove<Position>(second);
+  registry.Destroy(first);
+  registry.DestroyAll<Velocity>();
+
+  registry.FlushObservers();
+
+  ASSERT_EQ(destroyed.Count(), 1);
+  EXPECT_EQ(destroyed.batches[0][0], first);
+  EXPECT_EQ(removed.Count(), 2);
+}
+
+TEST(Observers_Tests, OnDestroy_DestroyIf_SingleBatch)
+{
+  Registry registry;
+  Recorder recorder;
+
+  registry.OnDestroy<Position>(recorder.Handler());
+
+  registry.CreateMany(100, Position { 1 });
+
+  const size_t amount = registry.DestroyIf<Position>([](Entity entity) { return entity % 2 == 0; });
+
+  registry.FlushObservers();
+
+  ASSERT_EQ(recorder.batches.size(), 1);
+  EXPECT_EQ(recorder.batches[0].size(), amount);
+}
+
+TEST(Observers_Tests, Unobserve_PendingEvents_NotDispatched)
+{
+  Registry registry;
+  Recorder recorder;
+
+  const ObserverId id = registry.OnCreate<Position>(recorder.Handler());
+
+  registry.Create(Position { 1 });
+  registry.Unobserve(id);
+
+  registry.FlushObservers();
+
+  EXPECT_TRUE(recorder.batches.empty());
+}
+
+TEST(Observers_Tests, FlushObservers_HandlerCreates_DispatchedNextFlush)
+{
+  Registry registry;
+  Recorder recorder;
+
+  Observers<Entity>::Handler spawner;
+  spawner.Bind([&registry](std::span<const Entity>) { registry.Create(Velocity { 1 }); });
+
+  registry.OnCreate<Position>(spawner);
+  registry.OnCreate<Velocity>(recorder.Handler());
+
+  registry.Create(Position { 1 });
+
+  registry.FlushObservers();
+
+  EXPECT_TRUE(recorder.batches.empty());
+
+  registry.FlushObservers();
+
+  EXPECT_EQ(recorder.Count(), 1);
+}
+
+TEST(Observers_Tests, FlushObservers_IdleFlushes_BatchesRecreated)
+{
+  Registry registry;
+  Recorder created;
+  Recorder added;
+
+  registry.OnCreate<Position>(created.Handler());
+  registry.OnAdd<Position, Velocity>(added.Handler());
+
+  const Entity entity = registry.Create(Position { 1 });
+  registry.Create(Position { 2 }, Velocity { 1 });
+
+  registry.FlushObservers();
+  registry.FlushObservers();
+  registry.FlushObservers();
+
+  EXPECT_EQ(created.batches.size(), 2);
+  EXPECT_EQ(added.batches.size(), 1);
+
+  registry.Create(Position { 3 });
+  registry.Add(entity, Velocity { 1 });
+
+  registry.FlushObservers();
+
+  EXPECT_EQ(created.batches.size(), 3);
+  EXPECT_EQ(created.Count(), 3);
+  ASSERT_EQ(added.batches.size(), 2);
+  EXPECT_EQ(added.batches[1].front(), entity);
+}
+} // namespace plex::tests
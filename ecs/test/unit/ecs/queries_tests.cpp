@@ -0,0 +1,196 @@
+#include "plex/ecs/queries.h"
+
+#include <gtest/gtest.h>
+
+#include <span>
+
+#include "plex/system/system.h"
+
+namespace plex::tests
+{
+namespace
+{
+  struct Time
+  {
+    float delta;
+  };
+
+  struct Input
+  {
+    int key;
+  };
+
+  void ReadTimeSystem(Singletons<const Time>) {}
+
+  void ReadTimeInputSystem(Singletons<const Time, const Input>) {}
+
+  void WriteTimeSystem(Singletons<Time>) {}
+
+  struct Position
+  {
+    float x;
+  };
+
+  struct Velocity
+  {
+    float x;
+  };
+
+  void MoveSystem(Entities<const Velocity, Position>) {}
+
+  void AccelerateSystem(Entities<Velocity>) {}
+
+  void ReadPositionSystem(Entities<const Position>) {}
+
+  void ReadVelocitySystem(Entities<const Velocity, Without<Position>>) {}
+} // namespace
+
+static_assert(Query<Singletons<>>);
+static_assert(Query<Singletons<Time>>);
+static_assert(Query<Singletons<const Time, Input>>);
+static_assert(Query<Commands>);
+static_assert(Query<Entities<>>);
+static_assert(Query<Entities<const Position, Velocity>>);
+static_assert(Query<Entities<Position, Without<Velocity>>>);
+
+TEST(Singletons_Tests, GetDataAccess_ConstAndMutable_CorrectDataAccess)
+{
+  QueryDataAccessList auto array = Singletons<const Time, Input>::GetDataAccess();
+
+  ASSERT_EQ(array.size(), 2);
+
+  EXPECT_EQ(array[0].name, TypeName<Time>());
+  EXPECT_EQ(array[0].category, Singletons<>::GetCategory());
+  EXPECT_TRUE(array[0].read_only);
+
+  EXPECT_EQ(array[1].name, TypeName<Input>());
+  EXPECT_FALSE(array[1].read_only);
+}
+
+TEST(Singletons_Tests, FetchData_RegistryInContext_DirectReferences)
+{
+  Registry registry;
+  registry.Set<Time>(0.5f);
+  registry.Set<Input>(3);
+
+  Context global_context;
+  global_context.Insert(&registry, [](void*) {});
+
+  Context local_context;
+
+  const auto singletons = Singletons<const Time, Input>::FetchData(nullptr, global_context, local_context);
+
+  EXPECT_EQ(&singletons.Get<const Time>(), &registry.Get<Time>());
+  EXPECT_EQ(singletons.Get<const Time>().delta, 0.5f);
+
+  singletons.Get<Input>().key = 4;
+
+  EXPECT_EQ(registry.Get<Input>().key, 4);
+  EXPECT_EQ(singletons.Get<const Input>().key, 4);
+}
+
+TEST(Singletons_Tests, HasDependency_ReadersAndWriter_OnlyWriterDepends)
+{
+  const SystemObject reader1(ReadTimeSystem);
+  const SystemObject reader2(ReadTimeInputSystem);
+  const SystemObject writer(WriteTimeSystem);
+
+  EXPECT_FALSE(reader1.HasDependency(reader2));
+  EXPECT_TRUE(reader1.HasDependency(writer));
+  EXPECT_TRUE(writer.HasDependency(reader2));
+}
+
+TEST(Entities_Tests, GetDataAccess_ConstAndMutable_OneAccessPerComponent)
+{
+  QueryDataAccessList auto array = Entities<const Velocity, Position, Without<Time>>::GetDataAccess();
+
+  ASSERT_EQ(array.size(), 2);
+
+  EXPECT_EQ(array[0].name, TypeName<Velocity>());
+  EXPECT_EQ(array[0].category, Entities<>::GetCategory());
+  EXPECT_TRUE(array[0].read_only);
+
+  EXPECT_EQ(array[1].name, TypeName<Position>());
+  EXPECT_FALSE(array[1].read_only);
+}
+
+TEST(Entities_Tests, FetchData_RegistryInContext_IteratesView)
+{
+  Registry registry;
+  registry.Create(Position { 1 }, Velocity { 2 });
+  registry.Create(Position { 1 });
+
+  Context global_context;
+  global_context.Insert(&registry, [](void*) {});
+
+  Context local_context;
+
+  auto entities = Entities<const Velocity, Position>::FetchData(nullptr, global_context, local_context);
+
+  EXPECT_EQ(entities.Size(), 1);
+
+  EntityForEach(entities, [](const Velocity& velocity, Position& position) { position.x += velocity.x; });
+
+  EXPECT_EQ(registry.ViewFor<Position>().Size(), 2);
+  EXPECT_EQ(registry.Unpack<Position>(0).x, 3);
+  EXPECT_EQ(registry.Unpack<Position>(1).x, 1);
+}
+
+TEST(Entities_Tests, EntityForEach_ConstComponent_OnlyReadable)
+{
+  using Query = Entities<const Velocity, Optional<const Time>, Position>;
+
+  static_assert(details::ViewConstFunction<Query, decltype([](const Velocity&, const Time*, Position&) {})>);
+  static_assert(details::ViewConstFunction<Query, decltype([](Velocity, Position) {})>);
+  static_assert(!details::ViewConstFunction<Query, decltype([](Velocity&, Position&) {})>);
+  static_assert(!details::ViewConstFunction<Query, decltype([](Time*) {})>);
+  static_assert(!details::ViewConstFunction<Query, decltype([](std::span<Velocity>) {})>);
+
+  QueryDataAccessList auto array = Query::GetDataAccess();
+
+  ASSERT_EQ(array.size(), 3);
+
+  EXPECT_TRUE(array[0].read_only);
+  EXPECT_TRUE(array[1].read_only);
+  EXPECT_FALSE(array[2].read_only);
+}
+
+TEST(Entities_Tests, HasDependency_DisjointOrReadOnly_NoDependency)
+{
+  const SystemObject move(MoveSystem);
+  const SystemObject accelerate(AccelerateSystem);
+  const SystemObject read_position(ReadPositionSystem);
+  const SystemObject read_velocity(ReadVelocitySystem);
+
+  EXPECT_TRUE(move.HasDependency(accelerate));
+  EXPECT_TRUE(move.HasDependency(read_position));
+  EXPECT_FALSE(move.HasDependency(read_velocity));
+  EXPECT_FALSE(accelerate.HasDependency(read_position));
+  EXPECT_TRUE(accelerate.HasDependency(read_velocity));
+}
+
+TEST(Commands_Tests, FetchData_SameSystem_SameBuffer)
+{
+  Registry registry;
+  CommandBuffers pool;
+
+  Context global_context;
+  global_context.Insert(&registry, [](void*) {});
+  global_context.Insert(&pool, [](void*) {});
+
+  Context local_context1;
+  Context local_context2;
+
+  Commands::FetchData(nullptr, global_context, local_context1).Create(Position { 1 });
+  Commands::FetchData(nullptr, global_context, local_context1).Create(Position { 2 });
+  Commands::FetchData(nullptr, global_context, local_context2).Create(Velocity { 3 });
+
+  EXPECT_EQ(local_context1.Get<CommandBuffer>().Size(), 2);
+  EXPECT_EQ(local_context2.Get<CommandBuffer>().Size(), 1);
+
+  pool.Playback(registry);
+
+  EXPECT_EQ(registry.EntityCount<Position>(), 2);
+  EXPECT_EQ(registry.EntityCount<Velocity>(), 1);
+}
+} // namespace plex::tests
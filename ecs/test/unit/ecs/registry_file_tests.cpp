@@ -0,0 +1,504 @@
+#include "plex/ecs/registry_file.h"
+
+#include "plex/ecs/registry.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+namespace plex::tests
+{
+namespace
+{
+  struct Position
+  {
+    float x;
+    float y;
+  };
+
+  struct Velocity
+  {
+    double x;
+  };
+
+  struct Tag
+  {};
+
+  struct Name
+  {
+    std::string value;
+  };
+
+  std::string SnapshotPath(const char* name)
+  {
+    return (std::filesystem::temp_directory_path() / name).string();
+  }
+
+  Vector<std::byte> ReadSnapshot(const std::string& path)
+  {
+    Vector<std::byte> data;
+    data.resize(std::filesystem::file_size(path));
+
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    EXPECT_EQ(std::fread(data.data(), 1, data.size(), file), data.size());
+    std::fclose(file);
+
+    return data;
+  }
+
+  void WriteSnapshot(const std::string& path, const Vector<std::byte>& data)
+  {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    EXPECT_EQ(std::fwrite(data.data(), 1, data.size(), file), data.size());
+    std::fclose(file);
+  }
+
+  ///
+  /// Saves a registry of 100 entities with one destroyed, lets the function corrupt the file and tries to load it.
+  ///
+  /// The function is given the entities of the first chunk and the recycled entities of the file.
+  ///
+  template<typename Function>
+  bool LoadCorrupted(const char* name, Function function)
+  {
+    const std::string path = SnapshotPath(name);
+
+    {
+      Registry registry;
+
+      registry.CreateMany(100, Position { 1, 1 });
+      registry.Destroy(50);
+
+      EXPECT_TRUE(registry.Save(path.c_str()));
+    }
+
+    Vector<std::byte> data = ReadSnapshot(path);
+
+    const auto header = reinterpret_cast<const details::RegistryFileHeader*>(data.data());
+    const auto archetype = reinterpret_cast<const details::RegistryFileArchetype*>(data.data() + header->archetypes);
+
+    function(reinterpret_cast<Entity*>(data.data() + archetype->chunks),
+      reinterpret_cast<Entity*>(data.data() + sizeof(details::RegistryFileHeader)));
+
+    WriteSnapshot(path, data);
+
+    Registry registry;
+
+    const bool loaded = registry.Load<Position>(path.c_str());
+
+    EXPECT_TRUE(loaded || registry.EntityCount() == 0);
+
+    std::remove(path.c_str());
+
+    return loaded;
+  }
+
+  ///
+  /// Saves a registry with the archetypes {Position}, {Velocity} and {Position, Velocity}, lets the function corrupt
+  /// their records and tries to load the file.
+  ///
+  /// The function is given the archetype records of the file, in that order.
+  ///
+  template<typename Function>
+  bool LoadCorruptedArchetypes(const char* name, Function function)
+  {
+    const std::string path = SnapshotPath(name);
+
+    {
+      Registry registry;
+
+      registry.CreateMany(100, Position { 1, 1 });
+      registry.CreateMany(100, Velocity { 1 });
+      registry.CreateMany(100, Position { 1, 1 }, Velocity { 1 });
+
+      EXPECT_TRUE(registry.Save(path.c_str()));
+    }
+
+    Vector<std::byte> data = ReadSnapshot(path);
+
+    const auto header = reinterpret_cast<const details::RegistryFileHeader*>(data.data());
+
+    Vector<details::RegistryFileArchetype*> archetypes;
+
+    std::byte* record = data.data() + header->archetypes;
+
+    for (size_t i = 0; i != header->archetype_count; ++i)
+    {
+      const auto archetype = reinterpret_cast<details::RegistryFileArchetype*>(record);
+
+      archetypes.push_back(archetype);
+
+      record += sizeof(details::RegistryFileArchetype) + archetype->component_count * sizeof(uint64_t)
+                + archetype->array_count * sizeof(details::RegistryFileArray);
+    }
+
+    EXPECT_EQ(archetypes.size(), 3);
+
+    function(archetypes);
+
+    WriteSnapshot(path, data);
+
+    Registry registry;
+
+    const bool loaded = registry.Load<Position, Velocity>(path.c_str());
+
+    EXPECT_TRUE(loaded || registry.EntityCount() == 0);
+
+    std::remove(path.c_str());
+
+    return loaded;
+  }
+
+  uint64_t* SnapshotIndices(details::RegistryFileArchetype* archetype)
+  {
+    return reinterpret_cast<uint64_t*>(archetype + 1);
+  }
+
+  details::RegistryFileArray* SnapshotArrays(details::RegistryFileArchetype* archetype)
+  {
+    return reinterpret_cast<details::RegistryFileArray*>(SnapshotIndices(archetype) + archetype->component_count);
+  }
+} // namespace
+
+TEST(RegistryFile_Tests, Load_SavedRegistry_SameEntitiesAndComponents)
+{
+  const std::string path = SnapshotPath("plex_snapshot_same.bin");
+
+  Vector<Entity> entities;
+
+  {
+    Registry registry;
+
+    for (Entity entity : registry.CreateMany(3000, Position { 1, 2 }, Velocity { 3 }))
+    {
+      entities.push_back(entity);
+    }
+
+    for (Entity entity : registry.CreateMany(10, Position { 4, 5 }, Tag {}))
+    {
+      entities.push_back(entity);
+    }
+
+    for (size_t i = 0; i != entities.size(); ++i)
+    {
+      registry.Unpack<Position>(entities[i]).x = static_cast<float>(i);
+    }
+
+    registry.Destroy(entities[5]);
+    registry.AdvanceTick();
+
+    ASSERT_TRUE(registry.Save(path.c_str()));
+  }
+
+  Registry registry;
+
+  ASSERT_TRUE((registry.Load<Position, Velocity, Tag>(path.c_str())));
+
+  EXPECT_EQ(registry.EntityCount(), entities.size() - 1);
+  EXPECT_EQ(registry.EntityCount<Tag>(), 10);
+  EXPECT_EQ(registry.CurrentTick(), 2);
+  EXPECT_FALSE(registry.Valid(entities[5]));
+
+  for (size_t i = 0; i != entities.size(); ++i)
+  {
+    if (i == 5) continue;
+
+    ASSERT_TRUE(registry.Valid(entities[i]));
+    EXPECT_EQ(registry.Unpack<Position>(entities[i]).x, static_cast<float>(i));
+  }
+
+  EXPECT_EQ(registry.Unpack<Velocity>(entities[0]).x, 3);
+  EXPECT_EQ(registry.Unpack<Position>(entities.back()).y, 5);
+
+  // The destroyed identifier is recycled with its next generation
+  const Entity recycled = registry.Create(Position { 0, 0 });
+
+  EXPECT_EQ(EntityTraits<Entity>::Index(recycled), EntityTraits<Entity>::Index(entities[5]));
+  if constexpr (EntityTraits<Entity>::cGenerationBits != 0)
+  {
+    EXPECT_NE(recycled, entities[5]);
+  }
+
+  std::remove(path.c_str());
+}
+
+TEST(RegistryFile_Tests, Load_ModifyLoaded_FileUnchanged)
+{
+  const std::string path = SnapshotPath("plex_snapshot_modify.bin");
+
+  {
+    Registry registry;
+
+    registry.CreateMany(100, Position { 1, 1 });
+
+    ASSERT_TRUE(registry.Save(path.c_str()));
+  }
+
+  {
+    Registry registry;
+
+    ASSERT_TRUE(registry.Load<Position>(path.c_str()));
+
+    registry.Unpack<Position>(0).x = 10;
+    registry.Add(1, Velocity { 2 });
+    registry.Destroy(2);
+    registry.CreateMany(1000, Position { 3, 3 });
+
+    EXPECT_EQ(registry.Unpack<Position>(0).x, 10);
+    EXPECT_EQ(registry.Unpack<Position>(1).x, 1);
+    EXPECT_EQ(registry.Unpack<Position>(150).x, 3);
+    EXPECT_EQ(registry.EntityCount(), 1099);
+  }
+
+  Registry registry;
+
+  ASSERT_TRUE(registry.Load<Position>(path.c_str()));
+
+  EXPECT_EQ(registry.EntityCount(), 100);
+  EXPECT_EQ(registry.Unpack<Position>(0).x, 1);
+
+  std::remove(path.c_str());
+}
+
+TEST(RegistryFile_Tests, Save_LoadedFromSamePath_Overwritten)
+{
+  const std::string path = SnapshotPath("plex_snapshot_resave.bin");
+
+  {
+    Registry registry;
+
+    registry.CreateMany(100000, Position { 1, 1 });
+
+    ASSERT_TRUE(registry.Save(path.c_str()));
+  }
+
+  {
+    Registry registry;
+
+    ASSERT_TRUE(registry.Load<Position>(path.c_str()));
+
+    registry.Unpack<Position>(0).x = 10;
+
+    ASSERT_TRUE(registry.Save(path.c_str()));
+
+    // The adopted chunks are still readable after the file was replaced
+    EXPECT_EQ(registry.Unpack<Position>(99999).x, 1);
+  }
+
+  Registry registry;
+
+  ASSERT_TRUE(registry.Load<Position>(path.c_str()));
+
+  EXPECT_EQ(registry.EntityCount(), 100000);
+  EXPECT_EQ(registry.Unpack<Position>(0).x, 10);
+  EXPECT_EQ(registry.Unpack<Position>(99999).x, 1);
+  EXPECT_FALSE(std::filesystem::exists(path + ".tmp"));
+
+  std::remove(path.c_str());
+}
+
+TEST(RegistryFile_Tests, Load_MissingComponentType_ReturnsFalse)
+{
+  const std::string path = SnapshotPath("plex_snapshot_missing.bin");
+
+  {
+    Registry registry;
+
+    registry.Create(Position { 1, 1 });
+    registry.Create(Velocity { 1 });
+
+    ASSERT_TRUE(registry.Save(path.c_str()));
+  }
+
+  Registry registry;
+
+  EXPECT_FALSE(registry.Load<Position>(path.c_str()));
+  EXPECT_EQ(registry.EntityCount(), 0);
+
+  std::remove(path.c_str());
+}
+
+TEST(RegistryFile_Tests, Load_InvalidFile_ReturnsFalse)
+{
+  const std::string path = SnapshotPath("plex_snapshot_invalid.bin");
+
+  Registry registry;
+
+  EXPECT_FALSE(registry.Load<Position>(SnapshotPath("plex_snapshot_does_not_exist.bin").c_str()));
+
+  std::FILE* file = std::fopen(path.c_str(), "wb");
+  ASSERT_NE(file, nullptr);
+  std::fputs("not a snapshot", file);
+  std::fclose(file);
+
+  EXPECT_FALSE(registry.Load<Position>(path.c_str()));
+  EXPECT_EQ(registry.EntityCount(), 0);
+
+  std::remove(path.c_str());
+}
+
+TEST(RegistryFile_Tests, Load_TruncatedFile_ReturnsFalse)
+{
+  const std::string path = SnapshotPath("plex_snapshot_truncated.bin");
+
+  {
+    Registry registry;
+
+    registry.CreateMany(1000, Position { 1, 1 });
+
+    ASSERT_TRUE(registry.Save(path.c_str()));
+  }
+
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) / 2);
+
+  Registry registry;
+
+  EXPECT_FALSE(registry.Load<Position>(path.c_str()));
+  EXPECT_EQ(registry.EntityCount(), 0);
+
+  std::remove(path.c_str());
+}
+
+TEST(RegistryFile_Tests, Load_Observed_CreateDispatched)
+{
+  const std::string path = SnapshotPath("plex_snapshot_observed.bin");
+
+  {
+    Registry registry;
+
+    registry.CreateMany(500, Position { 1, 1 });
+
+    ASSERT_TRUE(registry.Save(path.c_str()));
+  }
+
+  Registry registry;
+  size_t created = 0;
+
+  Observers<Entity>::Handler handler;
+  handler.Bind([&created](std::span<const Entity> entities) { created += entities.size(); });
+
+  registry.OnCreate<Position>(handler);
+
+  ASSERT_TRUE(registry.Load<Position>(path.c_str()));
+
+  registry.FlushObservers();
+
+  EXPECT_EQ(created, 500);
+
+  std::remove(path.c_str());
+}
+TEST(RegistryFile_Tests, Save_NotTriviallyCopyable_ReturnsFalse)
+{
+  const std::string path = SnapshotPath("plex_snapshot_not_trivial.bin");
+
+  Registry registry;
+
+  registry.Create(Position { 1, 1 });
+  registry.Create(Name { "name" });
+
+  EXPECT_FALSE(registry.Save(path.c_str()));
+  EXPECT_FALSE(std::filesystem::exists(path));
+}
+
+TEST(RegistryFile_Tests, Save_PartialChunk_UnusedRowsZeroed)
+{
+  const std::string path = SnapshotPath("plex_snapshot_zeroed.bin");
+
+  {
+    Registry registry;
+
+    registry.CreateMany(100, Position { 1, 1 });
+
+    for (Entity entity = 50; entity != 100; ++entity)
+    {
+      registry.Destroy(entity);
+    }
+
+    ASSERT_TRUE(registry.Save(path.c_str()));
+  }
+
+  const Vector<std::byte> data = ReadSnapshot(path);
+
+  const auto header = reinterpret_cast<const details::RegistryFileHeader*>(data.data());
+  const auto archetype = reinterpret_cast<const details::RegistryFileArchetype*>(data.data() + header->archetypes);
+  const auto entities = reinterpret_cast<const Entity*>(data.data() + archetype->chunks);
+
+  ASSERT_EQ(archetype->size, 50);
+  EXPECT_TRUE(std::all_of(entities + 50, entities + archetype->chunk_capacity, [](Entity e) { return e == 0; }));
+
+  std::remove(path.c_str());
+}
+
+TEST(RegistryFile_Tests, Load_NotEmpty_ReturnsFalse)
+{
+  const std::string path = SnapshotPath("plex_snapshot_not_empty.bin");
+
+  {
+    Registry registry;
+
+    registry.CreateMany(10, Position { 1, 1 });
+
+    ASSERT_TRUE(registry.Save(path.c_str()));
+  }
+
+  Registry registry;
+
+  registry.Create(Position { 2, 2 });
+
+  EXPECT_FALSE(registry.Load<Position>(path.c_str()));
+  EXPECT_EQ(registry.EntityCount(), 1);
+
+  std::remove(path.c_str());
+}
+
+TEST(RegistryFile_Tests, Load_DuplicateEntity_ReturnsFalse)
+{
+  EXPECT_FALSE(
+    LoadCorrupted("plex_snapshot_duplicate.bin", [](Entity* entities, Entity*) { entities[1] = entities[0]; }));
+}
+
+TEST(RegistryFile_Tests, Load_EntityOutOfRange_ReturnsFalse)
+{
+  EXPECT_FALSE(LoadCorrupted("plex_snapshot_out_of_range.bin", [](Entity* entities, Entity*) { entities[0] = 1000; }));
+}
+
+TEST(RegistryFile_Tests, Load_RecycledAlsoAlive_ReturnsFalse)
+{
+  EXPECT_FALSE(
+    LoadCorrupted("plex_snapshot_recycled.bin", [](Entity* entities, Entity* recycled) { recycled[0] = entities[0]; }));
+}
+
+TEST(RegistryFile_Tests, Load_Unchanged_ReturnsTrue)
+{
+  EXPECT_TRUE(LoadCorrupted("plex_snapshot_unchanged.bin", [](Entity*, Entity*) {}));
+}
+
+TEST(RegistryFile_Tests, Load_DuplicateArchetype_ReturnsFalse)
+{
+  EXPECT_FALSE(LoadCorruptedArchetypes("plex_snapshot_duplicate_archetype.bin",
+    [](const Vector<details::RegistryFileArchetype*>& archetypes)
+    {
+      // Both components have the same size, only the duplicated component set is wrong
+      SnapshotIndices(archetypes[1])[0] = SnapshotIndices(archetypes[0])[0];
+      SnapshotArrays(archetypes[1])[0].component = SnapshotArrays(archetypes[0])[0].component;
+    }));
+}
+
+TEST(RegistryFile_Tests, Load_DuplicateComponent_ReturnsFalse)
+{
+  EXPECT_FALSE(LoadCorruptedArchetypes("plex_snapshot_duplicate_component.bin",
+    [](const Vector<details::RegistryFileArchetype*>& archetypes)
+    {
+      SnapshotIndices(archetypes[2])[1] = SnapshotIndices(archetypes[2])[0];
+      SnapshotArrays(archetypes[2])[1].component = SnapshotArrays(archetypes[2])[0].component;
+    }));
+}
+
+TEST(RegistryFile_Tests, Load_ArchetypesUnchanged_ReturnsTrue)
+{
+  EXPECT_TRUE(LoadCorruptedArchetypes("plex_snapshot_archetypes_unchanged.bin", [](const auto&) {}));
+}
+} // namespace plex::tests
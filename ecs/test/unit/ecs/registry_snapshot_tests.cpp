@@ -0,0 +1,378 @@
+#include "plex/ecs/registry.h"
+
+#include "plex/async/sync_wait.h"
+#include "plex/containers/vector.h"
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+
+namespace plex::tests
+{
+namespace
+{
+  struct Position
+  {
+    float x;
+  };
+
+  struct Name
+  {
+    std::string value;
+  };
+
+  template<typename ViewType>
+  concept Modifiable = requires(ViewType view, Entity entity)
+  {
+    view.Destroy(entity);
+    view.template Sort<Position>(std::less {});
+    view.begin();
+  };
+
+  template<typename Snapshot>
+  concept MutablyViewable = requires(Snapshot snapshot) { snapshot.template ViewFor<Position>(); };
+
+  ///
+  /// Takes a snapshot, lets the function set every position to 2 and checks that the next snapshot sees the writes.
+  ///
+  template<typename Function>
+  void ExpectSnapshotSeesWrites(Function write)
+  {
+    Registry registry;
+
+    registry.CreateMany(5000, Position { 1 });
+
+    registry.AdvanceTick();
+
+    RegistrySnapshot previous = registry.Snapshot();
+
+    registry.AdvanceTick();
+
+    write(registry);
+
+    registry.AdvanceTick();
+
+    RegistrySnapshot current = registry.Snapshot();
+
+    size_t count = 0;
+
+    EntityForEach(previous.ViewFor<const Position>(), [](const Position& position) { EXPECT_EQ(position.x, 1); });
+    EntityForEach(current.ViewFor<const Position>(),
+      [&count](const Position& position)
+      {
+        EXPECT_EQ(position.x, 2);
+        ++count;
+      });
+
+    EXPECT_EQ(count, 5000);
+  }
+} // namespace
+
+TEST(RegistrySnapshot_Tests, Snapshot_ModifiedAfter_KeepsValues)
+{
+  Registry registry;
+
+  const Entity first = registry.Create(Position { 1 });
+  const Entity second = registry.Create(Position { 2 });
+
+  RegistrySnapshot snapshot = registry.Snapshot();
+
+  registry.Unpack<Position>(first).x = 10;
+  registry.Destroy(second);
+  registry.Create(Position { 3 });
+
+  EXPECT_EQ(snapshot.EntityCount(), 2);
+  EXPECT_TRUE(snapshot.Valid(second));
+  EXPECT_EQ(snapshot.Unpack<Position>(first).x, 1);
+  EXPECT_EQ(snapshot.Unpack<Position>(second).x, 2);
+  EXPECT_EQ(snapshot.ViewFor<const Position>().Size(), 2);
+}
+
+TEST(RegistrySnapshot_Tests, Snapshot_UnmodifiedChunks_Shared)
+{
+  Registry registry;
+
+  auto entities = registry.CreateMany(5000, Position { 1 });
+
+  const Entity front = *entities.begin();
+  const Entity back = *(entities.end() - 1);
+
+  ASSERT_GT((*registry.ViewFor<Position>().begin()).ChunkCount(), 1);
+
+  registry.AdvanceTick();
+
+  RegistrySnapshot previous = registry.Snapshot();
+
+  registry.AdvanceTick();
+
+  registry.Unpack<Position>(back).x = 2;
+
+  RegistrySnapshot current = registry.Snapshot();
+
+  EXPECT_EQ(&previous.Unpack<Position>(front), &current.Unpack<Position>(front));
+  EXPECT_NE(&previous.Unpack<Position>(back), &current.Unpack<Position>(back));
+  EXPECT_EQ(previous.Unpack<Position>(back).x, 1);
+  EXPECT_EQ(current.Unpack<Position>(back).x, 2);
+}
+
+TEST(RegistrySnapshot_Tests, Snapshot_WrittenThroughEveryAccessPath_SeesWrites)
+{
+  const auto set = [](Position& position) { position.x = 2; };
+
+  ExpectSnapshotSeesWrites(
+    [](Registry& registry)
+    {
+      Vector<Entity> entities;
+
+      EntityForEach(registry.ViewFor<Position>(), [&entities](Entity entity) { entities.push_back(entity); });
+
+      for (const Entity entity : entities)
+      {
+        registry.Unpack<Position>(entity).x = 2;
+      }
+    });
+
+  ExpectSnapshotSeesWrites(
+    [](Registry& registry)
+    {
+      for (auto&& sub_view : registry.ViewFor<Position>())
+      {
+        for (auto it = sub_view.ebegin(); it != sub_view.eend(); ++it)
+        {
+          sub_view.Unpack<Position>(*it).x = 2;
+        }
+      }
+    });
+
+  ExpectSnapshotSeesWrites([&set](Registry& registry) { EntityForEach(registry.ViewFor<Position>(), set); });
+
+  ExpectSnapshotSeesWrites(
+    [&set](Registry& registry)
+    {
+      auto view = registry.ViewFor<Position>();
+
+      EntityForEach(view.begin(), view.end(), set);
+    });
+
+  ExpectSnapshotSeesWrites(
+    [&set](Registry& registry)
+    {
+      for (auto&& sub_view : registry.ViewFor<Position>())
+      {
+        EntityForEach(sub_view, set);
+      }
+    });
+
+  ExpectSnapshotSeesWrites(
+    [&set](Registry& registry)
+    {
+      for (auto&& sub_view : registry.ViewFor<Position>())
+      {
+        EntityForEach(sub_view.begin(), sub_view.end(), set);
+      }
+    });
+
+  ExpectSnapshotSeesWrites(
+    [&set](Registry& registry) { EntityForEach(registry.ViewFor<Position>(), Changed<Position> { 0 }, set); });
+
+  ExpectSnapshotSeesWrites(
+    [&set](Registry& registry) { EntityForEach(registry.ViewFor<Position>(), Added<Position> { 0 }, set); });
+
+  ExpectSnapshotSeesWrites(
+    [](Registry& registry)
+    {
+      EntityForEachSpan(registry.ViewFor<Position>(),
+        [](std::span<Position> positions)
+        {
+          for (Position& position : positions)
+          {
+            position.x = 2;
+          }
+        });
+    });
+
+  ExpectSnapshotSeesWrites(
+    [&set](Registry& registry)
+    {
+      ThreadPool pool(4, false);
+
+      SyncWait(ParallelEntityForEach(registry.ViewFor<Position>(), pool, set, 1000));
+    });
+}
+
+TEST(RegistrySnapshot_Tests, Snapshot_DestroyedEntity_ChunkCopied)
+{
+  Registry registry;
+
+  auto entities = registry.CreateMany(10, Position { 1 });
+
+  registry.AdvanceTick();
+
+  RegistrySnapshot previous = registry.Snapshot();
+
+  registry.AdvanceTick();
+
+  registry.Destroy(*entities.begin());
+
+  RegistrySnapshot current = registry.Snapshot();
+
+  EXPECT_TRUE(previous.Valid(*entities.begin()));
+  EXPECT_FALSE(current.Valid(*entities.begin()));
+  EXPECT_EQ(current.EntityCount(), 9);
+  EXPECT_EQ(current.ViewFor<const Position>().Size(), 9);
+}
+
+TEST(RegistrySnapshot_Tests, Snapshot_PreviousReleased_ReusedAndUpdated)
+{
+  Registry registry;
+
+  auto entities = registry.CreateMany(5000, Position { 1 });
+
+  registry.AdvanceTick();
+
+  static_cast<void>(registry.Snapshot());
+
+  registry.AdvanceTick();
+
+  Vector<Entity> destroyed;
+
+  for (const Entity entity : entities)
+  {
+    if (entity % 3 == 0) destroyed.push_back(entity);
+    else if (entity % 3 == 1) registry.Add(entity, Name { "moved" });
+  }
+
+  for (const Entity entity : destroyed)
+  {
+    registry.Destroy(entity);
+  }
+
+  const Entity created = registry.Create(Position { 2 });
+
+  RegistrySnapshot snapshot = registry.Snapshot();
+
+  EXPECT_EQ(snapshot.EntityCount(), registry.EntityCount());
+
+  for (const Entity entity : destroyed)
+  {
+    EXPECT_EQ(snapshot.Valid(entity), entity == created);
+  }
+
+  for (const Entity entity : entities)
+  {
+    if (entity % 3 != 1) continue;
+
+    ASSERT_TRUE(snapshot.Valid(entity));
+    EXPECT_EQ(snapshot.Unpack<Position>(entity).x, 1);
+    EXPECT_EQ(snapshot.Unpack<Name>(entity).value, "moved");
+  }
+
+  EXPECT_EQ(snapshot.Unpack<Position>(created).x, 2);
+  EXPECT_EQ(snapshot.ViewFor<const Position>().Size(), registry.EntityCount());
+}
+
+TEST(RegistrySnapshot_Tests, Snapshot_PreviousSnapshotsHeld_Unchanged)
+{
+  Registry registry;
+
+  const Entity entity = registry.Create(Position { 0 });
+
+  Vector<RegistrySnapshot> snapshots;
+
+  for (size_t i = 0; i < 4; i++)
+  {
+    registry.AdvanceTick();
+    registry.Unpack<Position>(entity).x = static_cast<float>(i);
+    registry.Create(Position { 0 });
+
+    snapshots.push_back(registry.Snapshot());
+  }
+
+  for (size_t i = 0; i < 4; i++)
+  {
+    EXPECT_EQ(snapshots[i].Unpack<Position>(entity).x, static_cast<float>(i));
+    EXPECT_EQ(snapshots[i].EntityCount(), i + 2);
+  }
+}
+
+TEST(RegistrySnapshot_Tests, Snapshot_RegistryDestroyed_OutlivesRegistry)
+{
+  auto registry = std::make_unique<Registry>();
+
+  const Entity entity = registry->Create(Name { "before" }, Position { 1 });
+
+  RegistrySnapshot snapshot = registry->Snapshot();
+
+  registry->Unpack<Name>(entity).value = "after";
+  registry.reset();
+
+  EXPECT_EQ(snapshot.Unpack<Name>(entity).value, "before");
+}
+
+TEST(RegistrySnapshot_Tests, EntityForEach_Snapshot_ConstComponents)
+{
+  Registry registry;
+
+  registry.CreateMany(1000, Position { 1 });
+  registry.CreateMany(1000, Position { 2 }, Name { "name" });
+
+  RegistrySnapshot snapshot = registry.Snapshot();
+
+  float sum = 0;
+
+  EntityForEach(snapshot.ViewFor<const Position>(), [&sum](const Position& position) { sum += position.x; });
+
+  EXPECT_EQ(sum, 3000);
+}
+
+TEST(RegistrySnapshot_Tests, ViewFor_Snapshot_ReadOnly)
+{
+  using ViewType = decltype(std::declval<RegistrySnapshot&>().ViewFor<const Position>());
+
+  static_assert(!Modifiable<ViewType>);
+  static_assert(!MutablyViewable<RegistrySnapshot>);
+  static_assert(std::same_as<decltype(std::declval<ViewType&>().Unpack<Position>(Entity {})), const Position&>);
+
+  static_assert(details::ReadOnlyEntityFunction<decltype([](Entity, const Position&, Position) {})>);
+  static_assert(!details::ReadOnlyEntityFunction<decltype([](Position&) {})>);
+  static_assert(!details::ReadOnlyEntityFunction<decltype([](Position*) {})>);
+
+  Registry registry;
+
+  const Entity entity = registry.Create(Position { 1 });
+
+  RegistrySnapshot snapshot = registry.Snapshot();
+
+  const auto view = snapshot.ViewFor<const Position>();
+
+  EXPECT_TRUE(view.Contains(entity));
+  EXPECT_EQ(view.Size(), 1);
+  EXPECT_EQ(view.Unpack<Position>(entity).x, 1);
+}
+
+TEST(RegistrySnapshot_Tests, Snapshot_ReadWhileModified_Consistent)
+{
+  Registry registry;
+
+  registry.CreateMany(10000, Position { 1 });
+
+  RegistrySnapshot snapshot = registry.Snapshot();
+
+  float sum = 0;
+
+  std::thread reader(
+    [&snapshot, &sum]()
+    { EntityForEach(snapshot.ViewFor<const Position>(), [&sum](const Position& position) { sum += position.x; }); });
+
+  EntityForEach(registry.ViewFor<Position>(), [](Position& position) { position.x = 2; });
+  registry.CreateMany(10000, Position { 3 });
+
+  reader.join();
+
+  EXPECT_EQ(sum, 10000);
+}
+} // namespace plex::tests
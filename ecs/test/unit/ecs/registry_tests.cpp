@@ -1,9 +1,21 @@
 #include "plex/ecs/registry.h"
 
+#include "plex/async/sync_wait.h"
+
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <string>
+#include <vector>
+
 namespace plex::tests
 {
+namespace
+{
+  struct EmptyTag
+  {};
+} // namespace
+
 TEST(Registry_Tests, EntityCount_AfterInitialization_Zero)
 {
   Registry registry;
@@ -140,7 +152,143 @@ TEST(Registry_Tests, Create_AfterDestroy_Restore)
   EXPECT_EQ((registry.EntityCount<double, int>()), 1);
   EXPECT_EQ(registry.EntityCount<float>(), 0);
 
-  EXPECT_EQ(entity1, entity2);
+  EXPECT_EQ(EntityTraits<Entity>::Index(entity1), EntityTraits<Entity>::Index(entity2));
+}
+
+TEST(Registry_Tests, Add_Single_MovesToNewArchetype)
+{
+  Registry registry;
+
+  auto entity = registry.Create<int>(10);
+
+  registry.Add(entity, 0.5);
+
+  EXPECT_EQ(registry.EntityCount(), 1);
+  EXPECT_EQ(registry.EntityCount<int>(), 1);
+  EXPECT_EQ((registry.EntityCount<int, double>()), 1);
+  EXPECT_TRUE((registry.HasComponents<int, double>(entity)));
+  EXPECT_EQ(registry.Unpack<int>(entity), 10);
+  EXPECT_EQ(registry.Unpack<double>(entity), 0.5);
+}
+
+TEST(Registry_Tests, Add_Multiple_KeepsOtherEntities)
+{
+  Registry registry;
+
+  auto entity1 = registry.Create<int>(1);
+  auto entity2 = registry.Create<int>(2);
+  auto entity3 = registry.Create<int>(3);
+
+  registry.Add(entity1, 0.1);
+  registry.Add(entity3, 0.3);
+
+  EXPECT_EQ(registry.EntityCount<int>(), 3);
+  EXPECT_EQ((registry.EntityCount<int, double>()), 2);
+  EXPECT_FALSE(registry.HasComponents<double>(entity2));
+  EXPECT_EQ(registry.Unpack<int>(entity1), 1);
+  EXPECT_EQ(registry.Unpack<int>(entity2), 2);
+  EXPECT_EQ(registry.Unpack<int>(entity3), 3);
+  EXPECT_EQ(registry.Unpack<double>(entity1), 0.1);
+  EXPECT_EQ(registry.Unpack<double>(entity3), 0.3);
+}
+
+TEST(Registry_Tests, Remove_Single_MovesToNewArchetype)
+{
+  Registry registry;
+
+  auto entity = registry.Create<int, double>(10, 0.5);
+
+  registry.Remove<double>(entity);
+
+  EXPECT_EQ(registry.EntityCount(), 1);
+  EXPECT_EQ(registry.EntityCount<int>(), 1);
+  EXPECT_EQ(registry.EntityCount<double>(), 0);
+  EXPECT_FALSE(registry.HasComponents<double>(entity));
+  EXPECT_EQ(registry.Unpack<int>(entity), 10);
+}
+
+TEST(Registry_Tests, Remove_LastComponent_EntityStillAlive)
+{
+  Registry registry;
+
+  auto entity = registry.Create<int>(10);
+
+  registry.Remove<int>(entity);
+
+  EXPECT_EQ(registry.EntityCount(), 1);
+  EXPECT_EQ(registry.EntityCount<int>(), 0);
+
+  registry.Add(entity, 20);
+
+  EXPECT_EQ(registry.EntityCount<int>(), 1);
+  EXPECT_EQ(registry.Unpack<int>(entity), 20);
+}
+
+TEST(Registry_Tests, AddRemove_RoundTrip_SameArchetype)
+{
+  Registry registry;
+
+  auto entity1 = registry.Create<int, float>(1, 0.1f);
+  auto entity2 = registry.Create<int, float>(2, 0.2f);
+
+  for (size_t i = 0; i < 3; i++)
+  {
+    registry.Add(entity1, std::string("value"));
+    registry.Remove<float>(entity1);
+    registry.Add(entity1, 0.1f);
+    registry.Remove<std::string>(entity1);
+  }
+
+  EXPECT_EQ((registry.EntityCount<int, float>()), 2);
+  EXPECT_EQ(registry.EntityCount<std::string>(), 0);
+  EXPECT_EQ(registry.Unpack<int>(entity1), 1);
+  EXPECT_EQ(registry.Unpack<float>(entity1), 0.1f);
+  EXPECT_EQ(registry.Unpack<int>(entity2), 2);
+  EXPECT_EQ(registry.Unpack<float>(entity2), 0.2f);
+}
+
+TEST(Registry_Tests, Add_NonTrivialComponents_ValuesRelocated)
+{
+  Registry registry;
+
+  Vector<Entity> entities;
+
+  for (size_t i = 0; i < 10; i++)
+  {
+    entities.push_back(registry.Create<std::string>(std::string(32, static_cast<char>('a' + i))));
+  }
+
+  for (size_t i = 0; i < 10; i += 2)
+  {
+    registry.Add(entities[i], i);
+  }
+
+  EXPECT_EQ((registry.EntityCount<std::string, size_t>()), 5);
+
+  for (size_t i = 0; i < 10; i++)
+  {
+    EXPECT_EQ(registry.Unpack<std::string>(entities[i]), std::string(32, static_cast<char>('a' + i)));
+    EXPECT_EQ(registry.HasComponents<size_t>(entities[i]), i % 2 == 0);
+  }
+}
+
+TEST(Registry_Tests, Add_EmptyComponent_HasComponent)
+{
+  Registry registry;
+
+  auto entity1 = registry.Create<int>(1);
+  auto entity2 = registry.Create<int, EmptyTag>(2, EmptyTag {});
+
+  registry.Add(entity1, EmptyTag {});
+
+  EXPECT_EQ((registry.EntityCount<int, EmptyTag>()), 2);
+  EXPECT_EQ(registry.Unpack<int>(entity1), 1);
+
+  registry.Remove<EmptyTag>(entity2);
+
+  EXPECT_EQ(registry.EntityCount<EmptyTag>(), 1);
+  EXPECT_FALSE(registry.HasComponents<EmptyTag>(entity2));
+  EXPECT_EQ(registry.Unpack<int>(entity2), 2);
 }
 
 TEST(Registry_Tests, DestroyAll_MultipleEntities_DecreaseEntityCount)
@@ -1031,4 +1179,945 @@ TEST(EntityForEach_Tests, View_TwoArchetypes_CorrectEntities)
   EXPECT_EQ(call_count, total_amount);
   EXPECT_EQ(seen_entities.size(), total_amount);
 }
+
+TEST(EntityForEach_Tests, View_EmptyComponent_CorrectEntities)
+{
+  constexpr int amount = 5;
+
+  Registry registry;
+
+  for (int i = 0; i < amount; i++)
+  {
+    registry.Create(i, EmptyTag {});
+  }
+
+  registry.Create(amount);
+
+  int call_count = 0;
+
+  EntityForEach(registry.ViewFor<EmptyTag>(),
+    [&](int value, EmptyTag&)
+    {
+      EXPECT_EQ(value, call_count);
+      ++call_count;
+    });
+
+  EXPECT_EQ(call_count, amount);
+}
+
+TEST(EntityForEach_Tests, View_OnlyEmptyComponent_CorrectEntities)
+{
+  constexpr int amount = 5;
+
+  Registry registry;
+
+  for (int i = 0; i < amount; i++)
+  {
+    registry.Create(i, EmptyTag {});
+  }
+
+  int call_count = 0;
+
+  EntityForEach(registry.ViewFor<EmptyTag>(), [&](const EmptyTag&) { ++call_count; });
+
+  EXPECT_EQ(call_count, amount);
+}
+
+TEST(SubViewIterator_Tests, Increment_AcrossChunks_CorrectEntities)
+{
+  constexpr size_t amount = 5000;
+
+  Registry registry;
+
+  for (size_t i = 0; i < amount; i++)
+  {
+    registry.Create(static_cast<int>(i));
+  }
+
+  SubView<int> sub_view = *registry.ViewFor<int>().begin();
+
+  size_t iterations = 0;
+
+  for (auto it = sub_view.begin(); it != sub_view.end(); ++it)
+  {
+    EXPECT_EQ(*std::get<Entity*>(*it), static_cast<Entity>(*std::get<int*>(*it)));
+    iterations++;
+  }
+
+  EXPECT_EQ(iterations, amount);
+  EXPECT_EQ(*std::get<int*>(*(sub_view.begin() + (amount - 1))), static_cast<int>(amount - 1));
+}
+
+TEST(SubViewIterator_Tests, PreDecrement_EndPartialChunk_LastEntity)
+{
+  Registry registry;
+
+  registry.Create<int>(1);
+  registry.Create<int>(2);
+  registry.Create<int>(3);
+
+  SubView sub_view = *registry.ViewFor<int>().begin();
+
+  auto it = sub_view.end();
+
+  --it;
+
+  EXPECT_EQ(*std::get<int*>(*it), 3);
+  EXPECT_EQ(*std::get<Entity*>(*it), 2);
+}
+
+TEST(SubViewIterator_Tests, ReverseIteration_AcrossPartialChunk_CorrectEntities)
+{
+  constexpr size_t amount = 5000;
+
+  Registry registry;
+
+  for (size_t i = 0; i < amount; i++)
+  {
+    registry.Create(static_cast<int>(i));
+  }
+
+  SubView<int> sub_view = *registry.ViewFor<int>().begin();
+
+  ASSERT_NE(amount % sub_view.ChunkCapacity(), 0);
+
+  size_t expected = amount;
+
+  for (auto it = sub_view.rbegin(); it != sub_view.rend(); ++it)
+  {
+    EXPECT_EQ(*std::get<int*>(*it), static_cast<int>(--expected));
+  }
+
+  EXPECT_EQ(expected, 0);
+}
+
+TEST(EntityForEach_Tests, SubView_AcrossChunks_CorrectEntities)
+{
+  constexpr size_t amount = 5000;
+
+  Registry registry;
+
+  for (size_t i = 0; i < amount; i++)
+  {
+    registry.Create(static_cast<int>(i));
+  }
+
+  SubView<int> sub_view = *registry.ViewFor<int>().begin();
+
+  size_t call_count = 0;
+
+  EntityForEach(sub_view,
+    [&](Entity entity, int value)
+    {
+      EXPECT_EQ(entity, static_cast<Entity>(value));
+      ++call_count;
+    });
+
+  EXPECT_GT(sub_view.ChunkCount(), 1);
+  EXPECT_EQ(call_count, amount);
+}
+
+TEST(ParallelEntityForEach_Tests, View_ManyArchetypes_EveryEntityOnce)
+{
+  constexpr size_t amount = 20000;
+
+  Registry registry;
+
+  for (size_t i = 0; i < amount; i++)
+  {
+    if (i % 2 == 0) registry.Create(static_cast<int>(i));
+    else
+    {
+      registry.Create(static_cast<int>(i), 0.0f);
+    }
+  }
+
+  ThreadPool pool(4, false);
+
+  std::atomic_size_t call_count = 0;
+
+  SyncWait(ParallelEntityForEach(
+    registry.ViewFor<int>(),
+    pool,
+    [&](Entity entity, int& value)
+    {
+      EXPECT_EQ(entity, static_cast<Entity>(value));
+      value = -value - 1;
+      call_count.fetch_add(1, std::memory_order_relaxed);
+    },
+    1000));
+
+  EXPECT_EQ(call_count, amount);
+
+  EntityForEach(registry.ViewFor<int>(),
+    [](Entity entity, int value) { EXPECT_EQ(value, -static_cast<int>(entity) - 1); });
+}
+
+TEST(ParallelEntityForEach_Tests, View_SmallerThanGrain_IteratesSerially)
+{
+  Registry registry;
+
+  for (size_t i = 0; i < 10; i++)
+  {
+    registry.Create(static_cast<int>(i));
+  }
+
+  ThreadPool pool(4, false);
+
+  const auto thread_id = std::this_thread::get_id();
+
+  size_t call_count = 0;
+
+  SyncWait(ParallelEntityForEach(registry.ViewFor<int>(),
+    pool,
+    [&](int)
+    {
+      EXPECT_EQ(std::this_thread::get_id(), thread_id);
+      ++call_count;
+    }));
+
+  EXPECT_EQ(call_count, 10);
+}
+
+TEST(Registry_Tests, CreateMany_Generator_CorrectComponents)
+{
+  constexpr size_t amount = 5000;
+
+  Registry registry;
+
+  auto entities = registry.CreateMany<int, std::string>(
+    amount, [](Entity entity) { return std::make_tuple(static_cast<int>(entity), std::to_string(entity)); });
+
+  EXPECT_EQ(entities.size(), amount);
+  EXPECT_EQ(registry.EntityCount(), amount);
+
+  for (Entity entity : entities)
+  {
+    EXPECT_EQ(registry.Unpack<int>(entity), static_cast<int>(entity));
+    EXPECT_EQ(registry.Unpack<std::string>(entity), std::to_string(entity));
+  }
+}
+
+TEST(Registry_Tests, CreateMany_Copies_EveryEntityHasCopy)
+{
+  Registry registry;
+
+  auto entities = registry.CreateMany(100, 10, std::string("value"));
+
+  EXPECT_EQ((registry.EntityCount<int, std::string>()), 100);
+
+  for (Entity entity : entities)
+  {
+    EXPECT_EQ(registry.Unpack<int>(entity), 10);
+    EXPECT_EQ(registry.Unpack<std::string>(entity), "value");
+  }
+}
+
+TEST(Registry_Tests, CreateMany_AfterDestroy_ContiguousNewIds)
+{
+  Registry registry;
+
+  const Entity entity = registry.Create(0);
+  registry.Create(1);
+  registry.Destroy(entity);
+
+  auto entities = registry.CreateMany(10, 2);
+
+  EXPECT_EQ(*entities.begin(), 2);
+  EXPECT_EQ(entities.size(), 10);
+  EXPECT_EQ(registry.EntityCount<int>(), 11);
+
+  EXPECT_EQ(EntityTraits<Entity>::Index(registry.Create(3)), entity);
+}
+
+TEST(Registry_Tests, Instantiate_Prefab_EveryEntityHasCopy)
+{
+  constexpr size_t amount = 5000;
+
+  Registry registry;
+
+  const Entity prefab = registry.Create(10, std::string("prefab"));
+  registry.Create(1.0f);
+
+  auto entities = registry.Instantiate(prefab, amount);
+
+  EXPECT_EQ(*entities.begin(), 2);
+  EXPECT_EQ(entities.size(), amount);
+  EXPECT_EQ((registry.EntityCount<int, std::string>()), amount + 1);
+
+  for (Entity entity : entities)
+  {
+    EXPECT_EQ(registry.Unpack<int>(entity), 10);
+    EXPECT_EQ(registry.Unpack<std::string>(entity), "prefab");
+  }
+
+  registry.Unpack<std::string>(*entities.begin()) = "changed";
+
+  EXPECT_EQ(registry.Unpack<std::string>(prefab), "prefab");
+}
+
+TEST(Registry_Tests, Instantiate_EmptyComponent_SameArchetype)
+{
+  struct Tag
+  {};
+
+  Registry registry;
+
+  const Entity prefab = registry.Create(Tag {}, 3);
+
+  auto entities = registry.Instantiate(prefab, 10);
+
+  EXPECT_EQ((registry.EntityCount<Tag, int>()), 11);
+
+  for (Entity entity : entities)
+  {
+    EXPECT_TRUE(registry.HasComponents<Tag>(entity));
+    EXPECT_EQ(registry.Unpack<int>(entity), 3);
+  }
+}
+
+TEST(Registry_Tests, DestroyIf_ComponentPredicate_DestroysMatching)
+{
+  constexpr size_t amount = 3000;
+
+  Registry registry;
+
+  for (size_t i = 0; i < amount; i++)
+  {
+    if (i % 2 == 0) registry.Create(static_cast<int>(i));
+    else
+    {
+      registry.Create(static_cast<int>(i), std::to_string(i));
+    }
+  }
+
+  const size_t destroyed = registry.DestroyIf<int>([](const int& value) { return value % 4 < 2; });
+
+  EXPECT_EQ(destroyed, amount / 2);
+  EXPECT_EQ(registry.EntityCount(), amount - destroyed);
+
+  EntityForEach(registry.ViewFor<int>(),
+    [](Entity entity, int value)
+    {
+      EXPECT_GE(value % 4, 2);
+      EXPECT_EQ(static_cast<int>(entity), value);
+    });
+
+  EntityForEach(registry.ViewFor<int, std::string>(),
+    [](int value, const std::string& string) { EXPECT_EQ(std::to_string(value), string); });
+}
+
+TEST(Registry_Tests, DestroyIf_Entity_ReleasesIds)
+{
+  Registry registry;
+
+  for (size_t i = 0; i < 10; i++)
+  {
+    registry.Create(0.0f);
+  }
+
+  EXPECT_EQ(registry.DestroyIf<float>([](Entity entity) { return entity < 5; }), 5);
+
+  EXPECT_EQ(registry.EntityCount<float>(), 5);
+  EXPECT_LT(EntityTraits<Entity>::Index(registry.Create(0.0f)), 5);
+}
+
+TEST(Registry_Tests, DestroyIf_OptionalComponent_DestroysMatching)
+{
+  Registry registry;
+
+  for (size_t i = 0; i < 10; i++)
+  {
+    if (i < 4) registry.Create(static_cast<int>(i), 0.0f);
+    else
+    {
+      registry.Create(static_cast<int>(i));
+    }
+  }
+
+  EXPECT_EQ(registry.DestroyIf<int>([](const float* value) { return value != nullptr; }), 4);
+
+  EXPECT_EQ(registry.EntityCount<int>(), 6);
+  EXPECT_EQ((registry.EntityCount<int, float>()), 0);
+}
+
+TEST(Registry_Tests, Valid_AfterCreate_True)
+{
+  Registry registry;
+
+  const Entity entity1 = registry.Create(10);
+  const Entity entity2 = registry.Create();
+
+  EXPECT_TRUE(registry.Valid(entity1));
+  EXPECT_TRUE(registry.Valid(entity2));
+}
+
+TEST(Registry_Tests, Valid_AfterDestroy_False)
+{
+  Registry registry;
+
+  const Entity entity = registry.Create(10);
+
+  registry.Destroy(entity);
+
+  EXPECT_FALSE(registry.Valid(entity));
+}
+
+#if PLEX_ECS_ENTITY_GENERATION_BITS != 0 // Runs in test_ecs_generations
+
+TEST(Registry_Tests, Valid_StaleAfterIndexReused_False)
+{
+  Registry registry;
+
+  const Entity stale = registry.Create(10);
+
+  registry.Destroy(stale);
+
+  const Entity entity = registry.Create(20);
+
+  EXPECT_EQ(EntityTraits<Entity>::Index(entity), EntityTraits<Entity>::Index(stale));
+  EXPECT_NE(entity, stale);
+
+  EXPECT_TRUE(registry.Valid(entity));
+  EXPECT_FALSE(registry.Valid(stale));
+  EXPECT_EQ(registry.Unpack<int>(entity), 20);
+}
+
+#endif
+
+TEST(Registry_Tests, Valid_AfterAddRemove_True)
+{
+  Registry registry;
+
+  const Entity entity = registry.Create(10);
+
+  registry.Add(entity, 0.5);
+  EXPECT_TRUE(registry.Valid(entity));
+
+  registry.Remove<int>(entity);
+  EXPECT_TRUE(registry.Valid(entity));
+}
+
+TEST(Registry_Tests, Valid_AfterDestroyAllAndDestroyIf_False)
+{
+  Registry registry;
+
+  const Entity entity1 = registry.Create(10);
+  const Entity entity2 = registry.Create(0.5);
+
+  registry.DestroyAll();
+  registry.DestroyIf<double>([](double) { return true; });
+
+  EXPECT_FALSE(registry.Valid(entity1));
+  EXPECT_FALSE(registry.Valid(entity2));
+
+  const Entity entity3 = registry.Create(10);
+
+  EXPECT_TRUE(registry.Valid(entity3));
+
+  if constexpr (EntityTraits<Entity>::cGenerationBits != 0)
+  {
+    EXPECT_FALSE(registry.Valid(entity1));
+    EXPECT_FALSE(registry.Valid(entity2));
+  }
+}
+
+TEST(EntityForEach_Tests, Changed_MutableAccess_OnlyChangedChunks)
+{
+  Registry registry;
+
+  const Entity entity = registry.Create(1);
+  registry.Create(2, 0.5f);
+
+  Tick last_run = registry.AdvanceTick();
+
+  size_t count = 0;
+  const auto counter = [&](const int&) { ++count; };
+
+  EntityForEach(registry.ViewFor<int>(), Changed<int> { last_run }, counter);
+  EXPECT_EQ(count, 0);
+
+  registry.AdvanceTick();
+
+  EntityForEach(registry.ViewFor<int, float>(), [](int& value) { value += 10; });
+
+  EntityForEach(registry.ViewFor<int>(), Changed<int> { last_run }, [&](int value) { EXPECT_EQ(value, 12); });
+  EntityForEach(registry.ViewFor<int>(), Changed<int> { last_run }, counter);
+  EXPECT_EQ(count, 1);
+
+  last_run = registry.AdvanceTick();
+  registry.AdvanceTick();
+
+  registry.Unpack<int>(entity) = 3;
+
+  EntityForEach(registry.ViewFor<int>(), Changed<int> { last_run }, [&](int value) { EXPECT_EQ(value, 3); });
+  EntityForEach(registry.ViewFor<int>(), Changed<int> { last_run }, counter);
+  EXPECT_EQ(count, 2);
+}
+
+TEST(EntityForEach_Tests, Changed_IteratorRange_OnlyRangeChunks)
+{
+  constexpr size_t amount = 5000;
+
+  Registry registry;
+
+  for (size_t i = 0; i < amount; i++)
+  {
+    registry.Create(static_cast<int>(i));
+  }
+
+  SubView<int> sub_view = *registry.ViewFor<int>().begin();
+
+  ASSERT_GT(sub_view.ChunkCount(), 2);
+
+  const Tick last_run = registry.AdvanceTick();
+  registry.AdvanceTick();
+
+  const auto capacity = static_cast<std::ptrdiff_t>(sub_view.ChunkCapacity());
+
+  EntityForEach(sub_view.begin() + 1, sub_view.begin() + capacity + 1, [](int& value) { value = -1; });
+
+  size_t count = 0;
+
+  EntityForEach(registry.ViewFor<int>(), Changed<int> { last_run }, [&](int) { ++count; });
+  EXPECT_EQ(count, 2 * sub_view.ChunkCapacity());
+
+  EXPECT_EQ(*std::get<int*>(*sub_view.begin()), 0);
+  EXPECT_EQ(*std::get<int*>(*(sub_view.begin() + capacity)), -1);
+  EXPECT_EQ(*std::get<int*>(*(sub_view.begin() + capacity + 1)), static_cast<int>(capacity + 1));
+}
+
+TEST(EntityForEach_Tests, Changed_ConstAccess_NotChanged)
+{
+  Registry registry;
+
+  registry.Create(1);
+
+  const Tick last_run = registry.AdvanceTick();
+
+  EntityForEach(registry.ViewFor<int>(), [](const int&) {});
+  EntityForEach(registry.ViewFor<int>(), [](int) {});
+
+  size_t count = 0;
+
+  EntityForEach(registry.ViewFor<int>(), Changed<int> { last_run - 1 }, [&](int) { ++count; });
+  EXPECT_EQ(count, 0);
+}
+
+TEST(EntityForEach_Tests, Added_AcrossTicks_OnlyNewEntities)
+{
+  Registry registry;
+
+  for (int i = 0; i < 10; i++)
+  {
+    registry.Create(i);
+  }
+
+  const Tick last_run = registry.AdvanceTick() - 1;
+
+  const Entity entity = registry.Create(0.5f);
+  registry.Add(entity, 100);
+
+  for (int i = 10; i < 20; i += 2)
+  {
+    registry.Create(i);
+    registry.AdvanceTick();
+    registry.Create(i + 1);
+  }
+
+  std::vector<int> values;
+
+  EntityForEach(registry.ViewFor<int>(), Added<int> { last_run }, [&](int value) { values.push_back(value); });
+  std::ranges::sort(values);
+
+  EXPECT_EQ(values, (std::vector<int> { 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 100 }));
+
+  size_t count = 0;
+
+  EntityForEach(registry.ViewFor<float>(), Added<float> { last_run }, [&](float) { ++count; });
+  EXPECT_EQ(count, 1);
+
+  EntityForEach(registry.ViewFor<int>(), Added<int> { registry.CurrentTick() }, [&](int) { ++count; });
+  EXPECT_EQ(count, 1);
+}
+
+TEST(EntityForEach_Tests, View_Without_ExcludedArchetypesSkipped)
+{
+  Registry registry;
+
+  registry.Create(1);
+  registry.Create(2, 0.5f);
+  registry.Create(3, 0.5);
+  registry.Create(4, 0.5, 0.5f);
+
+  std::vector<int> values;
+
+  EntityForEach(registry.ViewFor<int, Without<float>>(), [&](int value) { values.push_back(value); });
+  std::ranges::sort(values);
+
+  EXPECT_EQ(values, (std::vector<int> { 1, 3 }));
+  EXPECT_EQ((registry.EntityCount<int, Without<float, double>>()), 1);
+}
+
+TEST(EntityForEach_Tests, View_Optional_NullWhenMissing)
+{
+  Registry registry;
+
+  for (int i = 0; i < 10; i++)
+  {
+    if (i % 2 == 0) registry.Create(i);
+    else
+    {
+      registry.Create(i, static_cast<float>(i));
+    }
+  }
+
+  size_t count = 0;
+
+  EntityForEach(registry.ViewFor<int, Optional<float>>(),
+    [&](int value, float* optional)
+    {
+      ++count;
+
+      if (value % 2 == 0) EXPECT_EQ(optional, nullptr);
+      else
+      {
+        ASSERT_NE(optional, nullptr);
+        EXPECT_EQ(*optional, static_cast<float>(value));
+        *optional += 100;
+      }
+    });
+
+  EXPECT_EQ(count, 10);
+
+  EntityForEach(registry.ViewFor<int, float>(),
+    [](int value, float optional) { EXPECT_EQ(optional, static_cast<float>(value + 100)); });
+}
+
+TEST(EntityForEach_Tests, View_OptionalAcrossChunks_CorrectPointers)
+{
+  Registry registry;
+
+  constexpr int amount = 20000;
+
+  for (int i = 0; i < amount; i++)
+  {
+    registry.Create(i, static_cast<double>(i));
+  }
+
+  int sum = 0;
+
+  EntityForEach(registry.ViewFor<int, Optional<double, float>>(),
+    [&](int value, const double* optional, const float* missing)
+    {
+      EXPECT_EQ(missing, nullptr);
+      EXPECT_EQ(*optional, static_cast<double>(value));
+      ++sum;
+    });
+
+  EXPECT_EQ(sum, amount);
+}
+
+namespace
+{
+  struct OutOfLineComponent
+  {
+    using IsStoredOutOfLine = std::true_type;
+
+    int value;
+    char data[4096];
+  };
+} // namespace
+
+TEST(EntityForEach_Tests, View_OutOfLineComponent_Transparent)
+{
+  Registry registry;
+
+  constexpr int amount = 100;
+
+  for (int i = 0; i < amount; i++)
+  {
+    if (i % 2 == 0) registry.Create(i, OutOfLineComponent { i, {} });
+    else
+    {
+      registry.Create(i);
+    }
+  }
+
+  int count = 0;
+
+  EntityForEach(registry.ViewFor<int, OutOfLineComponent>(),
+    [&](int value, OutOfLineComponent& component)
+    {
+      EXPECT_EQ(component.value, value);
+      component.value += 1000;
+      ++count;
+    });
+
+  EXPECT_EQ(count, amount / 2);
+
+  count = 0;
+
+  EntityForEach(registry.ViewFor<int, Optional<OutOfLineComponent>>(),
+    [&](int value, const OutOfLineComponent* component)
+    {
+      if (value % 2 == 0) EXPECT_EQ(component->value, value + 1000);
+      else
+      {
+        EXPECT_EQ(component, nullptr);
+      }
+      ++count;
+    });
+
+  EXPECT_EQ(count, amount);
+}
+
+TEST(SubViewIterator_Tests, Dereference_OutOfLineComponent_ComponentPointers)
+{
+  Registry registry;
+
+  Vector<Entity> entities;
+
+  for (int i = 0; i < 10; i++)
+  {
+    entities.push_back(registry.Create(OutOfLineComponent { i, {} }));
+  }
+
+  // Moves the handles but not the components
+  registry.Destroy(entities[0]);
+  registry.Add(entities[1], 1.0f);
+
+  SubView<OutOfLineComponent> sub_view = *registry.ViewFor<OutOfLineComponent>().begin();
+
+  size_t iterations = 0;
+
+  for (auto it = sub_view.begin(); it != sub_view.end(); ++it)
+  {
+    OutOfLineComponent* component = std::get<OutOfLineComponent*>(*it);
+
+    EXPECT_EQ(component, &registry.Unpack<OutOfLineComponent>(*std::get<Entity*>(*it)));
+    EXPECT_GE(component->value, 2);
+    iterations++;
+  }
+
+  EXPECT_EQ(iterations, 8);
+
+  int sum = 0;
+
+  EntityForEach(sub_view.begin(), sub_view.end(), [&](const OutOfLineComponent& component) { sum += component.value; });
+
+  EXPECT_EQ(sum, 2 + 3 + 4 + 5 + 6 + 7 + 8 + 9);
+  EXPECT_EQ(registry.Unpack<OutOfLineComponent>(entities[1]).value, 1);
+}
+
+TEST(EntityForEachSpan_Tests, View_TwoArchetypes_AlignedChunkSpans)
+{
+  Registry registry;
+
+  constexpr int amount = 5000;
+
+  for (int i = 0; i < amount; i++)
+  {
+    if (i % 2 == 0) registry.Create(i, static_cast<float>(i));
+    else
+    {
+      registry.Create(i, static_cast<float>(i), 0.5);
+    }
+  }
+
+  size_t total = 0;
+
+  EntityForEachSpan(registry.ViewFor<int, float>(),
+    [&](std::span<float> values, std::span<const int> keys, std::span<const Entity> entities)
+    {
+      ASSERT_EQ(values.size(), keys.size());
+      ASSERT_EQ(values.size(), entities.size());
+
+      EXPECT_EQ(reinterpret_cast<uintptr_t>(values.data()) % Storage<Entity>::cChunkAlignment, 0);
+      EXPECT_EQ(reinterpret_cast<uintptr_t>(keys.data()) % Storage<Entity>::cChunkAlignment, 0);
+
+      for (size_t i = 0; i < values.size(); i++)
+      {
+        EXPECT_EQ(values[i], static_cast<float>(keys[i]));
+        EXPECT_EQ(registry.Unpack<int>(entities[i]), keys[i]);
+
+        values[i] *= 2;
+      }
+
+      total += values.size();
+    });
+
+  EXPECT_EQ(total, amount);
+
+  EntityForEach(registry.ViewFor<int, float>(),
+    [](int key, float value) { EXPECT_EQ(value, static_cast<float>(key * 2)); });
+}
+
+TEST(EntityForEachSpan_Tests, SubView_MutableSpan_MarksChanged)
+{
+  Registry registry;
+
+  registry.Create(1, 1.0f);
+
+  const Tick since = registry.CurrentTick();
+  registry.AdvanceTick();
+
+  auto sub_view = *registry.ViewFor<int, float>().begin();
+
+  EntityForEachSpan(sub_view, [](std::span<const int>, std::span<const float>) {});
+
+  EXPECT_FALSE(IsNewerTick(sub_view.ChunkChangedTick<int>(0), since));
+  EXPECT_FALSE(IsNewerTick(sub_view.ChunkChangedTick<float>(0), since));
+
+  EntityForEachSpan(sub_view, [](std::span<const int>, std::span<float>) {});
+
+  EXPECT_FALSE(IsNewerTick(sub_view.ChunkChangedTick<int>(0), since));
+  EXPECT_TRUE(IsNewerTick(sub_view.ChunkChangedTick<float>(0), since));
+}
+
+TEST(Registry_Tests, Set_Singleton_GetSameInstance)
+{
+  Registry registry;
+
+  EXPECT_FALSE(registry.HasSingleton<double>());
+
+  double& singleton = registry.Set<double>(1.5);
+
+  EXPECT_TRUE(registry.HasSingleton<double>());
+  EXPECT_EQ(&registry.Get<double>(), &singleton);
+  EXPECT_EQ(registry.Get<double>(), 1.5);
+
+  // Singletons are not components, no entity is created
+  EXPECT_EQ(registry.EntityCount(), 0);
+  EXPECT_EQ(registry.EntityCount<double>(), 0);
+}
+
+TEST(Registry_Tests, Set_Existing_ReplacedInPlace)
+{
+  Registry registry;
+
+  const std::string& singleton = registry.Set<std::string>("first");
+
+  registry.Set<std::string>(5u, 'x');
+
+  EXPECT_EQ(&registry.Get<std::string>(), &singleton);
+  EXPECT_EQ(registry.Get<std::string>(), "xxxxx");
+
+  registry.Unset<std::string>();
+
+  EXPECT_FALSE(registry.HasSingleton<std::string>());
+}
+
+TEST(Registry_Tests, Set_ExistingNotAssignable_ReplacedInPlace)
+{
+  struct Settings
+  {
+    explicit Settings(int initial) : value(initial) {}
+
+    Settings& operator=(const Settings&) = delete;
+
+    int value;
+  };
+
+  static_assert(!std::is_move_assignable_v<Settings>);
+
+  Registry registry;
+
+  const Settings& singleton = registry.Set<Settings>(1);
+
+  registry.Set<Settings>(2);
+
+  EXPECT_EQ(&registry.Get<Settings>(), &singleton);
+  EXPECT_EQ(registry.Get<Settings>().value, 2);
+}
+
+TEST(Registry_Tests, Unpack_ManyArchetypes_CorrectValues)
+{
+  Registry registry;
+
+  Vector<Entity> entities;
+
+  for (int i = 0; i < 64; i++)
+  {
+    switch (i % 4)
+    {
+    case 0: entities.push_back(registry.Create(i)); break;
+    case 1: entities.push_back(registry.Create(i, 0.5f)); break;
+    case 2: entities.push_back(registry.Create(i, 0.5)); break;
+    default: entities.push_back(registry.Create(i, 0.5f, 0.5)); break;
+    }
+  }
+
+  for (size_t i = 0; i < 64; i++)
+  {
+    EXPECT_EQ(registry.Unpack<int>(entities[i]), static_cast<int>(i));
+    EXPECT_EQ(registry.HasComponents<float>(entities[i]), i % 4 == 1 || i % 4 == 3);
+    EXPECT_EQ((registry.HasComponents<int, Without<double>>(entities[i])), i % 4 < 2);
+  }
+
+  registry.Destroy<int>(entities[5]);
+
+  EXPECT_FALSE(registry.HasComponents<int>(entities[5]));
+  EXPECT_EQ(registry.Unpack<int>(entities[6]), 6);
+}
+
+TEST(Registry_Tests, HasComponents_AfterAddRemove_FollowsArchetype)
+{
+  Registry registry;
+
+  const Entity entity = registry.Create(1);
+
+  registry.Add(entity, 2.0f);
+
+  EXPECT_TRUE((registry.HasComponents<int, float>(entity)));
+  EXPECT_EQ(registry.Unpack<float>(entity), 2.0f);
+
+  registry.Remove<int>(entity);
+
+  EXPECT_FALSE(registry.HasComponents<int>(entity));
+  EXPECT_TRUE(registry.HasComponents<float>(entity));
+  EXPECT_EQ(registry.Unpack<float>(entity), 2.0f);
+}
+
+TEST(Registry_Tests, Sort_ManyArchetypes_EveryArchetypeSorted)
+{
+  Registry registry;
+
+  Vector<Entity> entities;
+
+  for (int i = 0; i < 2000; i++)
+  {
+    entities.push_back(i % 2 == 0 ? registry.Create(-i) : registry.Create(-i, 1.0f));
+  }
+
+  registry.Sort<int>([](const int lhs, const int rhs) { return lhs < rhs; });
+
+  for (auto sub_view : registry.ViewFor<int>())
+  {
+    Vector<int> values;
+
+    for (auto it = sub_view.begin<int>(); it != sub_view.end<int>(); ++it)
+    {
+      values.push_back(*std::get<int*>(*it));
+    }
+
+    EXPECT_EQ(values.size(), 1000);
+    EXPECT_TRUE(std::ranges::is_sorted(values));
+  }
+
+  for (int i = 0; i < 2000; i++)
+  {
+    EXPECT_EQ(registry.Unpack<int>(entities[static_cast<size_t>(i)]), -i);
+  }
+
+  registry.Sort<int>([](const int value) { return -value; });
+
+  Vector<int> values;
+
+  EntityForEach(registry.ViewFor<int, Without<float>>(), [&](int value) { values.push_back(value); });
+
+  EXPECT_EQ(values.size(), 1000);
+  EXPECT_TRUE(std::ranges::is_sorted(values, std::ranges::greater {}));
+}
+
 } // namespace plex::tests
\ No newline at end of file
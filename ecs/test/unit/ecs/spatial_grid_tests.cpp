@@ -0,0 +1,298 @@
+#include "plex/ecs/spatial_grid.h"
+
+#include <gtest/gtest.h>
+
+#include <limits>
+
+#include "plex/random/pcg.h"
+
+namespace plex::tests
+{
+namespace
+{
+  struct Position
+  {
+    float3 value;
+  };
+
+  struct Tag
+  {
+    int value;
+  };
+
+  using Grid = SpatialGrid<Position, float3 Position::*>;
+
+  ///
+  /// Returns a random position in a cube of the given size centered on the origin.
+  ///
+  float3 RandomPosition(PCG& random, const uint32_t size)
+  {
+    const auto coordinate = [&]()
+    { return static_cast<float>(random(size * 100)) / 100.0f - static_cast<float>(size) / 2.0f; };
+
+    const float x = coordinate();
+    const float y = coordinate();
+    const float z = coordinate();
+
+    return { x, y, z };
+  }
+
+  ///
+  /// Creates entities at random positions, in two archetypes.
+  ///
+  Vector<Entity> CreateRandom(Registry& registry, PCG& random, const size_t amount)
+  {
+    Vector<Entity> entities;
+
+    for (size_t i = 0; i < amount; i++)
+    {
+      const Position position { RandomPosition(random, 100) };
+
+      entities.push_back(i % 2 == 0 ? registry.Create(position) : registry.Create(position, Tag { 0 }));
+    }
+
+    return entities;
+  }
+
+  ///
+  /// Returns the sorted entities whose position is inside the sphere, by testing every entity.
+  ///
+  Vector<Entity> BruteForceRadius(Registry& registry, const float3& center, const float radius)
+  {
+    Vector<Entity> entities;
+
+    EntityForEach(registry.ViewFor<const Position>(),
+      [&](const Entity entity, const Position& position)
+      {
+        const float3 offset = position.value - center;
+
+        if (offset.x * offset.x + offset.y * offset.y + offset.z * offset.z <= radius * radius)
+        {
+          entities.push_back(entity);
+        }
+      });
+
+    std::ranges::sort(entities);
+
+    return entities;
+  }
+
+  ///
+  /// Returns the entities sorted.
+  ///
+  Vector<Entity> Sorted(std::span<const Entity> entities)
+  {
+    Vector<Entity> sorted(entities.begin(), entities.end());
+
+    std::ranges::sort(sorted);
+
+    return sorted;
+  }
+} // namespace
+
+TEST(SpatialGrid_Tests, QueryRadius_Random_SameAsBruteForce)
+{
+  Registry registry;
+  PCG random;
+
+  CreateRandom(registry, random, 5000);
+
+  Grid grid(registry, 4.0f, &Position::value);
+
+  EXPECT_EQ(grid.Size(), 5000);
+
+  for (size_t i = 0; i < 50; i++)
+  {
+    const float3 center = RandomPosition(random, 120);
+    const float radius = static_cast<float>(random(200)) / 10.0f;
+
+    EXPECT_EQ(Sorted(grid.QueryRadius(center, radius)), BruteForceRadius(registry, center, radius));
+  }
+}
+
+TEST(SpatialGrid_Tests, QueryAABB_Random_SameAsBruteForce)
+{
+  Registry registry;
+  PCG random;
+
+  CreateRandom(registry, random, 5000);
+
+  Grid grid(registry, 4.0f, &Position::value);
+
+  for (size_t i = 0; i < 50; i++)
+  {
+    const float3 min = RandomPosition(random, 120);
+    const float3 max = min + static_cast<float>(random(400)) / 10.0f;
+
+    Vector<Entity> expected;
+
+    EntityForEach(registry.ViewFor<const Position>(),
+      [&](const Entity entity, const Position& position)
+      {
+        const float3& value = position.value;
+
+        if (value.x >= min.x && value.y >= min.y && value.z >= min.z && value.x <= max.x && value.y <= max.y
+            && value.z <= max.z)
+        {
+          expected.push_back(entity);
+        }
+      });
+
+    std::ranges::sort(expected);
+
+    EXPECT_EQ(Sorted(grid.QueryAABB(min, max)), expected);
+  }
+}
+
+TEST(SpatialGrid_Tests, QueryAABB_LargerThanBuckets_NoDuplicates)
+{
+  Registry registry;
+  PCG random;
+
+  CreateRandom(registry, random, 1000);
+
+  Grid grid(registry, 0.5f, &Position::value);
+
+  const Vector<Entity> entities = Sorted(grid.QueryAABB(float3 { -60, -60, -60 }, float3 { 60, 60, 60 }));
+
+  EXPECT_EQ(entities.size(), 1000);
+  EXPECT_EQ(std::ranges::adjacent_find(entities), entities.end());
+}
+
+TEST(SpatialGrid_Tests, Update_Moved_FoundAtNewPosition)
+{
+  Registry registry;
+
+  const Entity entity = registry.Create(Position { { 0, 0, 0 } });
+  const Entity other = registry.Create(Position { { 1, 0, 0 } });
+
+  Grid grid(registry, 2.0f, &Position::value);
+
+  registry.Unpack<Position>(entity).value = { 50, 50, 50 };
+
+  EXPECT_EQ(grid.QueryRadius({ 50, 50, 50 }, 1).size(), 0);
+
+  grid.Update();
+
+  EXPECT_EQ(Sorted(grid.QueryRadius({ 0, 0, 0 }, 2)), Sorted(std::span(&other, 1)));
+  EXPECT_EQ(Sorted(grid.QueryRadius({ 50, 50, 50 }, 1)), Sorted(std::span(&entity, 1)));
+  EXPECT_EQ(grid.Size(), 2);
+}
+
+TEST(SpatialGrid_Tests, Update_MovedTwiceInSameTick_FoundAtLatestPosition)
+{
+  Registry registry;
+
+  const Entity entity = registry.Create(Position { { 0, 0, 0 } });
+
+  Grid grid(registry, 2.0f, &Position::value);
+
+  const Tick tick = registry.CurrentTick();
+
+  registry.Unpack<Position>(entity).value = { 20, 0, 0 };
+  grid.Update();
+
+  registry.Unpack<Position>(entity).value = { 40, 0, 0 };
+  grid.Update();
+
+  EXPECT_EQ(registry.CurrentTick(), tick);
+  EXPECT_EQ(grid.QueryRadius({ 20, 0, 0 }, 1).size(), 0);
+  EXPECT_EQ(Sorted(grid.QueryRadius({ 40, 0, 0 }, 1)), Sorted(std::span(&entity, 1)));
+}
+
+TEST(SpatialGrid_Tests, Update_NotFinitePosition_NotIndexed)
+{
+  constexpr float nan = std::numeric_limits<float>::quiet_NaN();
+  constexpr float infinity = std::numeric_limits<float>::infinity();
+
+  Registry registry;
+
+  const Entity entity = registry.Create(Position { { 0, 0, 0 } });
+  const Entity other = registry.Create(Position { { nan, 0, 0 } });
+  registry.Create(Position { { 0, infinity, 0 } });
+
+  Grid grid(registry, 2.0f, &Position::value);
+
+  EXPECT_EQ(grid.Size(), 1);
+  EXPECT_FALSE(grid.Contains(other));
+
+  registry.Unpack<Position>(entity).value = { 0, 0, -infinity };
+  grid.Update();
+
+  EXPECT_EQ(grid.Size(), 0);
+  EXPECT_EQ(grid.QueryRadius({ nan, 0, 0 }, 10).size(), 0);
+}
+
+TEST(SpatialGrid_Tests, QueryAABB_ExtremeBounds_FindsAll)
+{
+  constexpr float max = std::numeric_limits<float>::max();
+
+  Registry registry;
+  PCG random;
+
+  CreateRandom(registry, random, 100);
+
+  Grid grid(registry, 4.0f, &Position::value);
+
+  EXPECT_EQ(grid.QueryAABB(float3 { -max, -max, -max }, float3 { max, max, max }).size(), 100);
+  EXPECT_EQ(grid.QueryAABB(float3 { -max, -1, -1 }, float3 { max, 1, 1 }).size(),
+    grid.QueryAABB(float3 { -60, -1, -1 }, float3 { 60, 1, 1 }).size());
+}
+
+TEST(SpatialGrid_Tests, Update_Created_GrowsAndFindsAll)
+{
+  Registry registry;
+  PCG random;
+
+  Grid grid(registry, 4.0f, &Position::value);
+
+  const Vector<Entity> entities = CreateRandom(registry, random, 10000);
+
+  grid.Update();
+
+  EXPECT_EQ(grid.Size(), entities.size());
+
+  for (const Entity entity : entities)
+  {
+    EXPECT_TRUE(grid.Contains(entity));
+  }
+
+  for (size_t i = 0; i < 20; i++)
+  {
+    const float3 center = RandomPosition(random, 100);
+
+    EXPECT_EQ(Sorted(grid.QueryRadius(center, 10)), BruteForceRadius(registry, center, 10));
+  }
+}
+
+TEST(SpatialGrid_Tests, FlushObservers_DestroyedOrRemoved_Erased)
+{
+  Registry registry;
+  PCG random;
+
+  const Vector<Entity> entities = CreateRandom(registry, random, 100);
+
+  Grid grid(registry, 4.0f, &Position::value);
+
+  registry.Destroy(entities[0]);
+  registry.Remove<Position>(entities[1]);
+  registry.Remove<Tag>(entities[3]);
+
+  EXPECT_TRUE(grid.Contains(entities[0]));
+
+  registry.FlushObservers();
+
+  EXPECT_FALSE(grid.Contains(entities[0]));
+  EXPECT_FALSE(grid.Contains(entities[1]));
+  EXPECT_TRUE(grid.Contains(entities[3]));
+  EXPECT_EQ(grid.Size(), 98);
+
+  const Entity recycled = registry.Create(Position { { 0, 0, 0 } });
+
+  grid.Update();
+
+  EXPECT_TRUE(grid.Contains(recycled));
+  EXPECT_EQ(Sorted(grid.QueryAABB(float3 { -60, -60, -60 }, float3 { 60, 60, 60 })),
+    BruteForceRadius(registry, float3 {}, 1000));
+}
+} // namespace plex::tests
@@ -1,6 +1,9 @@
 #include "plex/ecs/storage.h"
 
 #include <algorithm>
+#include <bit>
+#include <memory>
+#include <string>
 
 #include <gtest/gtest.h>
 
@@ -322,4 +325,766 @@ TEST(Storage_Tests, Erase_MultipleEraseAfterMultipleInsert_CorrectState)
   EXPECT_FALSE(storage.Contains(1));
 }
 
+TEST(Storage_Tests, Relocate_AddComponent_CorrectState)
+{
+  SharedSparseArray<size_t> sparse;
+  Storage<size_t> source(&sparse);
+  Storage<size_t> destination(&sparse);
+  source.Initialize<int>();
+  destination.Initialize<int, std::string>();
+
+  source.Insert(0, 10);
+  source.Insert(1, 11);
+
+  source.Relocate(0, destination, std::string { "20" });
+
+  EXPECT_EQ(source.Size(), 1);
+  EXPECT_EQ(destination.Size(), 1);
+  EXPECT_FALSE(source.Contains(0));
+  EXPECT_TRUE(source.Contains(1));
+  EXPECT_TRUE(destination.Contains(0));
+  EXPECT_EQ(source.Unpack<int>(1), 11);
+  EXPECT_EQ(destination.Unpack<int>(0), 10);
+  EXPECT_EQ(destination.Unpack<std::string>(0), "20");
+}
+
+TEST(Storage_Tests, Relocate_RemoveComponent_CorrectState)
+{
+  SharedSparseArray<size_t> sparse;
+  Storage<size_t> source(&sparse);
+  Storage<size_t> destination(&sparse);
+  source.Initialize<int, std::string>();
+  destination.Initialize<std::string>();
+
+  source.Insert(0, 10, std::string { "20" });
+  source.Insert(1, 11, std::string { "21" });
+
+  source.Relocate(1, destination);
+
+  EXPECT_EQ(source.Size(), 1);
+  EXPECT_EQ(destination.Size(), 1);
+  EXPECT_TRUE(source.Contains(0));
+  EXPECT_TRUE(destination.Contains(1));
+  EXPECT_EQ(source.Unpack<int>(0), 10);
+  EXPECT_EQ(source.Unpack<std::string>(0), "20");
+  EXPECT_EQ(destination.Unpack<std::string>(1), "21");
+}
+
+namespace
+{
+  struct EmptyTag
+  {};
+} // namespace
+
+TEST(Storage_Tests, Insert_WithEmptyComponent_CorrectState)
+{
+  SharedSparseArray<size_t> sparse;
+  Storage<size_t> storage(&sparse);
+  storage.Initialize<int, EmptyTag>();
+
+  storage.Insert(0, 10, EmptyTag {});
+  storage.Insert(1, 11, EmptyTag {});
+
+  EXPECT_EQ(storage.Size(), 2);
+  EXPECT_TRUE(storage.HasComponent<EmptyTag>());
+  EXPECT_EQ(storage.Unpack<int>(1), 11);
+  EXPECT_EQ(&storage.Unpack<EmptyTag>(0), &storage.Unpack<EmptyTag>(1));
+  EXPECT_EQ(storage.ComponentInfos().size(), 2);
+}
+
+TEST(Storage_Tests, Relocate_AddEmptyComponent_CorrectState)
+{
+  SharedSparseArray<size_t> sparse;
+  Storage<size_t> source(&sparse);
+  Storage<size_t> destination(&sparse);
+  source.Initialize<int>();
+  destination.Initialize<int, EmptyTag>();
+
+  source.Insert(0, 10);
+  source.Relocate(0, destination, EmptyTag {});
+
+  EXPECT_TRUE(source.Empty());
+  EXPECT_TRUE(destination.Contains(0));
+  EXPECT_EQ(destination.Unpack<int>(0), 10);
+
+  destination.Erase(0);
+
+  EXPECT_TRUE(destination.Empty());
+}
+
+TEST(Storage_Tests, Insert_ManyAcrossChunks_CorrectValues)
+{
+  constexpr size_t cAmount = 5000;
+
+  SharedSparseArray<size_t> sparse;
+  Storage<size_t> storage(&sparse);
+  storage.Initialize<size_t, std::string>();
+
+  for (size_t i = 0; i < cAmount; i++)
+  {
+    storage.Insert(i, size_t { i }, std::to_string(i));
+  }
+
+  EXPECT_GT(storage.ChunkCount(), 1);
+
+  for (size_t i = 0; i < cAmount; i += 2)
+  {
+    storage.Erase(i);
+  }
+
+  EXPECT_EQ(storage.Size(), cAmount / 2);
+
+  for (size_t i = 1; i < cAmount; i += 2)
+  {
+    ASSERT_TRUE(storage.Contains(i));
+    EXPECT_EQ(storage.Unpack<size_t>(i), i);
+    EXPECT_EQ(storage.Unpack<std::string>(i), std::to_string(i));
+  }
+}
+
+TEST(Storage_Tests, ChunkSize_ManyAcrossChunks_SumIsSize)
+{
+  constexpr size_t cAmount = 3000;
+
+  SharedSparseArray<size_t> sparse;
+  Storage<size_t> storage(&sparse);
+  storage.Initialize<size_t>();
+
+  for (size_t i = 0; i < cAmount; i++)
+  {
+    storage.Insert(i, size_t { i });
+  }
+
+  EXPECT_TRUE(std::has_single_bit(storage.ChunkCapacity()));
+
+  size_t total = 0;
+
+  for (size_t chunk = 0; chunk < storage.ChunkCount(); chunk++)
+  {
+    const size_t* entities = storage.ChunkEntities(chunk);
+    const size_t* values = storage.ChunkComponents<size_t>(chunk);
+
+    for (size_t i = 0; i < storage.ChunkSize(chunk); i++)
+    {
+      EXPECT_EQ(entities[i], values[i]);
+    }
+
+    total += storage.ChunkSize(chunk);
+  }
+
+  EXPECT_EQ(total, cAmount);
+}
+
+TEST(Storage_Tests, Insert_LargerThanChunk_CorrectValues)
+{
+  struct LargeComponent
+  {
+    char data[Storage<size_t>::cChunkSize * 2];
+  };
+
+  SharedSparseArray<size_t> sparse;
+  Storage<size_t> storage(&sparse);
+  storage.Initialize<LargeComponent, int>();
+
+  auto large = std::make_unique<LargeComponent>();
+  large->data[Storage<size_t>::cChunkSize] = 'x';
+
+  storage.Insert(0, *large, 10);
+  storage.Insert(1, *large, 11);
+
+  EXPECT_EQ(storage.ChunkCapacity(), 1);
+  EXPECT_EQ(storage.ChunkCount(), 2);
+  EXPECT_EQ(storage.Unpack<LargeComponent>(1).data[Storage<size_t>::cChunkSize], 'x');
+  EXPECT_EQ(storage.Unpack<int>(1), 11);
+}
+
+namespace
+{
+  struct OutOfLineComponent
+  {
+    using IsStoredOutOfLine = std::true_type;
+
+    std::string name;
+    size_t data[256];
+  };
+} // namespace
+
+TEST(Storage_Tests, Insert_OutOfLineComponent_OnlyHandleInChunk)
+{
+  EXPECT_TRUE(IsStoredOutOfLine<OutOfLineComponent>::value);
+  EXPECT_FALSE(IsStoredOutOfLine<size_t>::value);
+  EXPECT_EQ(GetComponentInfo<OutOfLineComponent>()->size, sizeof(OutOfLineHandle<OutOfLineComponent>));
+
+  SharedSparseArray<size_t> sparse;
+  Storage<size_t> storage(&sparse);
+  storage.Initialize<OutOfLineComponent, int>();
+
+  auto component = std::make_unique<OutOfLineComponent>();
+  component->name = "component";
+  component->data[255] = 7;
+
+  storage.Insert(0, *component, 10);
+
+  EXPECT_EQ(storage.Unpack<OutOfLineComponent>(0).name, "component");
+  EXPECT_EQ(storage.Unpack<OutOfLineComponent>(0).data[255], 7);
+  EXPECT_EQ(storage.ChunkComponents<OutOfLineComponent>(0)[0].component, &storage.Unpack<OutOfLineComponent>(0));
+  EXPECT_EQ(storage.Unpack<int>(0), 10);
+}
+
+TEST(Storage_Tests, EraseAndRelocate_OutOfLineComponent_StableAddress)
+{
+  SharedSparseArray<size_t> sparse;
+  Storage<size_t> source(&sparse);
+  Storage<size_t> destination(&sparse);
+  source.Initialize<OutOfLineComponent>();
+  destination.Initialize<OutOfLineComponent, int>();
+
+  for (size_t i = 0; i < 3; i++)
+  {
+    source.Insert(i, OutOfLineComponent { std::to_string(i), {} });
+  }
+
+  const OutOfLineComponent* last = &source.Unpack<OutOfLineComponent>(2);
+
+  source.Erase(0);
+
+  EXPECT_EQ(&source.Unpack<OutOfLineComponent>(2), last);
+  EXPECT_EQ(source.Unpack<OutOfLineComponent>(2).name, "2");
+
+  source.Relocate(2, destination, 20);
+
+  EXPECT_EQ(&destination.Unpack<OutOfLineComponent>(2), last);
+  EXPECT_EQ(destination.Unpack<OutOfLineComponent>(2).name, "2");
+  EXPECT_EQ(destination.Unpack<int>(2), 20);
+  EXPECT_EQ(source.Unpack<OutOfLineComponent>(1).name, "1");
+}
+
+TEST(Storage_Tests, InsertMany_AcrossChunks_CorrectValues)
+{
+  constexpr size_t cAmount = 5000;
+
+  SharedSparseArray<size_t> sparse;
+  Storage<size_t> storage(&sparse);
+  storage.Initialize<size_t, std::string>();
+
+  storage.Insert(0, size_t { 0 }, std::string("0"));
+  storage.InsertMany<size_t, std::string>(
+    1, cAmount - 1, [](size_t entity) { return std::make_tuple(entity, std::to_string(entity)); });
+
+  EXPECT_EQ(storage.Size(), cAmount);
+
+  for (size_t i = 0; i < cAmount; i++)
+  {
+    ASSERT_TRUE(storage.Contains(i));
+    EXPECT_EQ(storage[i], i);
+    EXPECT_EQ(storage.Unpack<size_t>(i), i);
+    EXPECT_EQ(storage.Unpack<std::string>(i), std::to_string(i));
+  }
+}
+
+TEST(Storage_Tests, InsertCopies_AcrossChunks_EveryEntityHasCopy)
+{
+  constexpr size_t cAmount = 5000;
+
+  SharedSparseArray<size_t> sparse;
+  Storage<size_t> storage(&sparse);
+  storage.Initialize<size_t, std::string>();
+
+  storage.Insert(0, size_t { 10 }, std::string("prefab"));
+  storage.InsertCopies(1, cAmount - 1, 0);
+
+  EXPECT_EQ(storage.Size(), cAmount);
+  EXPECT_GT(storage.ChunkCount(), 1);
+
+  for (size_t i = 0; i < cAmount; i++)
+  {
+    ASSERT_TRUE(storage.Contains(i));
+    EXPECT_EQ(storage[i], i);
+    EXPECT_EQ(storage.Unpack<size_t>(i), 10);
+    EXPECT_EQ(storage.Unpack<std::string>(i), "prefab");
+  }
+}
+
+TEST(Storage_Tests, InsertChunk_DifferentLayout_CopiesRows)
+{
+  constexpr size_t cAmount = 3000;
+
+  SharedSparseArray<size_t> source_sparse;
+  Storage<size_t> source(&source_sparse);
+  source.Initialize<int, double>();
+
+  for (size_t i = 0; i < cAmount; i++)
+  {
+    source.Insert(i, static_cast<int>(i), static_cast<double>(i) / 2);
+  }
+
+  // Components in another order have different offsets in the chunks
+  SharedSparseArray<size_t> sparse;
+  Storage<size_t> storage(&sparse);
+  storage.Initialize<double, int>();
+
+  storage.Insert(cAmount, 0.5, -1);
+
+  Vector<size_t> offsets;
+  Vector<size_t> tick_offsets;
+
+  offsets.resize(std::max(GetComponentId<int>(), GetComponentId<double>()) + 1, 0);
+  tick_offsets.resize(offsets.size(), 0);
+
+  offsets[GetComponentId<int>()] = source.ComponentOffset(GetComponentId<int>());
+  offsets[GetComponentId<double>()] = source.ComponentOffset(GetComponentId<double>());
+  tick_offsets[GetComponentId<int>()] = source.TicksOffset(GetComponentId<int>());
+  tick_offsets[GetComponentId<double>()] = source.TicksOffset(GetComponentId<double>());
+
+  EXPECT_NE(storage.ComponentOffset(GetComponentId<int>()), offsets[GetComponentId<int>()]);
+
+  for (size_t chunk = 0; chunk < source.ChunkCount(); chunk++)
+  {
+    storage.InsertChunk(source.ChunkData(chunk), source.ChunkSize(chunk), { offsets.data(), offsets.size() },
+      { tick_offsets.data(), tick_offsets.size() });
+  }
+
+  EXPECT_EQ(storage.Size(), cAmount + 1);
+  EXPECT_EQ(storage.Unpack<int>(cAmount), -1);
+
+  for (size_t i = 0; i < cAmount; i++)
+  {
+    ASSERT_TRUE(storage.Contains(i));
+    EXPECT_EQ(storage.Unpack<int>(i), static_cast<int>(i));
+    EXPECT_EQ(storage.Unpack<double>(i), static_cast<double>(i) / 2);
+  }
+}
+
+TEST(Storage_Tests, InsertCopies_OutOfLineComponent_DistinctCopies)
+{
+  SharedSparseArray<size_t> sparse;
+  Storage<size_t> storage(&sparse);
+  storage.Initialize<OutOfLineComponent, int>();
+
+  auto component = std::make_unique<OutOfLineComponent>();
+  component->name = "prefab";
+
+  storage.Insert(0, std::move(*component), 5);
+  storage.InsertCopies(1, 3, 0);
+
+  for (size_t i = 1; i < 4; i++)
+  {
+    EXPECT_NE(&storage.Unpack<OutOfLineComponent>(i), &storage.Unpack<OutOfLineComponent>(0));
+    EXPECT_EQ(storage.Unpack<OutOfLineComponent>(i).name, "prefab");
+    EXPECT_EQ(storage.Unpack<int>(i), 5);
+  }
+}
+
+TEST(Storage_Tests, Reserve_Amount_EnoughChunks)
+{
+  SharedSparseArray<size_t> sparse;
+  Storage<size_t> storage(&sparse);
+  storage.Initialize<size_t>();
+
+  storage.Reserve(storage.ChunkCapacity() * 3);
+
+  EXPECT_TRUE(storage.Empty());
+  EXPECT_EQ(storage.ChunkCount(), 0);
+
+  for (size_t i = 0; i < storage.ChunkCapacity() * 3; i++)
+  {
+    storage.Insert(i, size_t { i });
+  }
+
+  EXPECT_EQ(storage.ChunkCount(), 3);
+  EXPECT_EQ(storage.Unpack<size_t>(storage.ChunkCapacity() * 3 - 1), storage.ChunkCapacity() * 3 - 1);
+}
+
+TEST(Storage_Tests, EraseRows_EveryThirdAcrossChunks_StableCompaction)
+{
+  constexpr size_t cAmount = 5000;
+
+  SharedSparseArray<size_t> sparse;
+  Storage<size_t> storage(&sparse);
+  storage.Initialize<size_t, std::string>();
+
+  for (size_t i = 0; i < cAmount; i++)
+  {
+    storage.Insert(i, size_t { i }, std::to_string(i));
+  }
+
+  Vector<size_t> rows;
+
+  for (size_t i = 0; i < cAmount; i += 3)
+  {
+    rows.push_back(i);
+  }
+
+  Vector<size_t> erased;
+
+  storage.EraseRows(rows, erased);
+
+  EXPECT_EQ(erased.size(), rows.size());
+  EXPECT_EQ(storage.Size(), cAmount - rows.size());
+
+  for (size_t entity : erased)
+  {
+    EXPECT_EQ(entity % 3, 0);
+    EXPECT_FALSE(storage.Contains(entity));
+  }
+
+  for (size_t i = 0; i < storage.Size(); i++)
+  {
+    const size_t entity = storage[i];
+
+    EXPECT_NE(entity % 3, 0);
+    EXPECT_TRUE(storage.Contains(entity));
+    EXPECT_EQ(storage.Unpack<size_t>(entity), entity);
+    EXPECT_EQ(storage.Unpack<std::string>(entity), std::to_string(entity));
+
+    if (i > 0)
+    {
+      EXPECT_LT(storage[i - 1], entity);
+    }
+  }
+}
+
+TEST(Storage_Tests, EraseRows_None_Unchanged)
+{
+  SharedSparseArray<size_t> sparse;
+  Storage<size_t> storage(&sparse);
+  storage.Initialize<size_t>();
+
+  storage.Insert(0, size_t { 0 });
+  storage.Insert(1, size_t { 1 });
+
+  Vector<size_t> erased;
+
+  storage.EraseRows({}, erased);
+
+  EXPECT_EQ(storage.Size(), 2);
+  EXPECT_TRUE(erased.empty());
+}
+
+TEST(SharedSparseArray_Tests, Valid_AfterAssignAndInvalidate_Correct)
+{
+  using Traits = EntityTraits<size_t>;
+
+  SharedSparseArray<size_t> sparse;
+
+  const size_t entity = Traits::Combine(100, 3);
+
+  EXPECT_FALSE(sparse.Valid(entity));
+
+  sparse.Assure(entity);
+  sparse.Assign(entity, 7);
+
+  EXPECT_TRUE(sparse.Valid(entity));
+  EXPECT_EQ(sparse[entity], 7);
+
+  sparse.Invalidate(entity);
+
+  EXPECT_FALSE(sparse.Valid(entity));
+  EXPECT_FALSE(sparse.Valid(Traits::Combine(1000000, 0)));
+}
+
+TEST(SharedSparseArray_Tests, Assure_HighEntity_SinglePage)
+{
+  using Sparse = SharedSparseArray<size_t>;
+
+  Sparse sparse;
+
+  const size_t entity = Sparse::cPageSize * 1000 + 5;
+
+  sparse.Assure(entity);
+  sparse.Assign(entity, 7);
+
+  EXPECT_EQ(sparse.AllocatedPages(), 1);
+  EXPECT_GT(sparse.Capacity(), entity);
+  EXPECT_TRUE(sparse.Valid(entity));
+  EXPECT_EQ(sparse[entity], 7);
+
+  // Pages in the directory that were never assured read as invalid
+  EXPECT_TRUE(sparse.Assured(5));
+  EXPECT_FALSE(sparse.Valid(5));
+  EXPECT_FALSE(sparse.Valid(entity + 1));
+}
+
+TEST(SharedSparseArray_Tests, Assure_RangeAcrossPages_AllPagesAllocated)
+{
+  using Sparse = SharedSparseArray<size_t>;
+
+  Sparse sparse;
+
+  sparse.Assure(Sparse::cPageSize - 1, Sparse::cPageSize * 3);
+
+  EXPECT_EQ(sparse.AllocatedPages(), 4);
+
+  for (size_t entity = Sparse::cPageSize - 1; entity <= Sparse::cPageSize * 3; entity++)
+  {
+    sparse.Assign(entity, entity);
+  }
+
+  EXPECT_EQ(sparse[Sparse::cPageSize * 2], Sparse::cPageSize * 2);
+  EXPECT_TRUE(sparse.Valid(Sparse::cPageSize * 3));
+}
+
+TEST(SharedSparseArray_Tests, Archetype_InsertRelocateErase_FollowsOwner)
+{
+  SharedSparseArray<size_t> sparse;
+  Storage<size_t> source(&sparse, nullptr, 3);
+  Storage<size_t> destination(&sparse, nullptr, 5);
+  source.Initialize<int>();
+  destination.Initialize<int, float>();
+
+  source.Insert(0, 10);
+  source.Insert(1, 11);
+  source.Insert(2, 12);
+
+  EXPECT_EQ(sparse.Archetype(0), 3);
+  EXPECT_EQ(sparse.Archetype(2), 3);
+
+  source.Relocate(0, destination, 1.0f);
+
+  EXPECT_EQ(sparse.Archetype(0), 5);
+  EXPECT_EQ(sparse.Archetype(2), 3);
+  EXPECT_EQ(source.Unpack<int>(2), 12);
+
+  source.Erase(1);
+
+  EXPECT_EQ(sparse.Archetype(2), 3);
+  EXPECT_EQ(sparse[2], 0);
+}
+
+TEST(Storage_Tests, Contains_StaleGeneration_False)
+{
+  using Traits = EntityTraits<size_t>;
+
+  SharedSparseArray<size_t> sparse;
+  Storage<size_t> storage(&sparse);
+  storage.Initialize<int>();
+
+  storage.Insert(Traits::Combine(0, 1), 10);
+
+  EXPECT_TRUE(storage.Contains(Traits::Combine(0, 1)));
+  EXPECT_EQ(storage.Unpack<int>(Traits::Combine(0, 1)), 10);
+
+  if constexpr (Traits::cGenerationBits != 0)
+  {
+    EXPECT_FALSE(storage.Contains(Traits::Combine(0, 0)));
+  }
+}
+
+TEST(Storage_Tests, ChunkAddedTicks_InsertAtTicks_StampedPerRow)
+{
+  SharedSparseArray<size_t> sparse;
+  Tick tick = 5;
+  Storage<size_t> storage(&sparse, &tick);
+  storage.Initialize<int>();
+
+  storage.Insert(0, 10);
+  tick = 6;
+  storage.Insert(1, 11);
+
+  EXPECT_EQ(storage.ChunkAddedTicks<int>(0)[0], 5);
+  EXPECT_EQ(storage.ChunkAddedTicks<int>(0)[1], 6);
+  EXPECT_EQ(storage.ChunkAddedTick<int>(0), 6);
+  EXPECT_EQ(storage.ChunkChangedTick<int>(0), 6);
+
+  tick = 7;
+  storage.MarkChanged<int>(0);
+
+  EXPECT_EQ(storage.ChunkChangedTick<int>(0), 7);
+  EXPECT_EQ(storage.ChunkAddedTick<int>(0), 6);
+}
+
+TEST(Storage_Tests, ChunkAddedTicks_EraseAndRelocate_TicksFollowRows)
+{
+  SharedSparseArray<size_t> sparse;
+  Tick tick = 1;
+  Storage<size_t> source(&sparse, &tick);
+  Storage<size_t> destination(&sparse, &tick);
+  source.Initialize<int>();
+  destination.Initialize<int, std::string>();
+
+  source.Insert(0, 10);
+  tick = 2;
+  source.Insert(1, 11);
+  tick = 3;
+  source.Insert(2, 12);
+
+  tick = 4;
+  source.Erase(0);
+
+  EXPECT_EQ(source.ChunkAddedTicks<int>(0)[0], 3);
+  EXPECT_EQ(source.ChunkAddedTicks<int>(0)[1], 2);
+
+  source.Relocate(1, destination, std::string { "21" });
+
+  EXPECT_EQ(source.ChunkAddedTicks<int>(0)[0], 3);
+  EXPECT_EQ(destination.ChunkAddedTicks<int>(0)[0], 2);
+  EXPECT_EQ(destination.ChunkAddedTicks<std::string>(0)[0], 4);
+  EXPECT_EQ(destination.ChunkAddedTick<int>(0), 2);
+  EXPECT_EQ(destination.ChunkAddedTick<std::string>(0), 4);
+}
+
+TEST(Storage_Tests, ChunkAddedTicks_EraseRows_TicksFollowRows)
+{
+  SharedSparseArray<size_t> sparse;
+  Tick tick = 0;
+  Storage<size_t> storage(&sparse, &tick);
+  storage.Initialize<int>();
+
+  for (size_t i = 0; i < 10; i++)
+  {
+    tick = static_cast<Tick>(i + 1);
+    storage.Insert(i, static_cast<int>(i));
+  }
+
+  const size_t rows[] { 0, 2, 4, 6, 8 };
+
+  Vector<size_t> erased;
+  storage.EraseRows(rows, erased);
+
+  for (size_t i = 0; i < storage.Size(); i++)
+  {
+    EXPECT_EQ(storage.ChunkAddedTicks<int>(0)[i], static_cast<Tick>(storage.ChunkComponents<int>(0)[i] + 1));
+  }
+}
+
+TEST(Storage_Tests, IsNewerTick_WrapAround_Correct)
+{
+  EXPECT_TRUE(IsNewerTick(2, 1));
+  EXPECT_FALSE(IsNewerTick(1, 1));
+  EXPECT_FALSE(IsNewerTick(1, 2));
+  EXPECT_TRUE(IsNewerTick(1, std::numeric_limits<Tick>::max()));
+}
+
+TEST(Storage_Tests, Sort_Compare_ComponentsFollowEntities)
+{
+  SharedSparseArray<size_t> sparse;
+  Storage<size_t> storage(&sparse);
+  storage.Initialize<int, std::string>();
+
+  constexpr size_t cAmount = 3000;
+
+  for (size_t i = 0; i < cAmount; i++)
+  {
+    storage.Insert(i, static_cast<int>(cAmount - i), std::to_string(i));
+  }
+
+  ASSERT_GT(storage.ChunkCount(), 1);
+
+  storage.Sort<int>([](const int lhs, const int rhs) { return lhs < rhs; });
+
+  for (size_t i = 0; i < cAmount; i++)
+  {
+    const size_t entity = cAmount - 1 - i;
+
+    EXPECT_EQ(storage[i], entity);
+    EXPECT_EQ(storage.ComponentAt<int>(i), static_cast<int>(i + 1));
+    EXPECT_EQ(storage.Unpack<std::string>(entity), std::to_string(entity));
+  }
+}
+
+TEST(Storage_Tests, Sort_SignedKey_RadixSortedAndStable)
+{
+  SharedSparseArray<size_t> sparse;
+  Storage<size_t> storage(&sparse);
+  storage.Initialize<int>();
+
+  const int values[] = { 3, -1, 70000, -70000, 3, 0, -1, 3 };
+
+  for (size_t i = 0; i < std::size(values); i++)
+  {
+    storage.Insert(i, values[i]);
+  }
+
+  storage.Sort<int>([](const int value) { return value; });
+
+  const size_t expected[] = { 3, 1, 6, 5, 0, 4, 7, 2 };
+
+  for (size_t i = 0; i < std::size(expected); i++)
+  {
+    EXPECT_EQ(storage[i], expected[i]);
+    EXPECT_EQ(storage.Unpack<int>(expected[i]), values[expected[i]]);
+  }
+}
+
+TEST(Storage_Tests, Sort_AlreadySorted_NothingMoved)
+{
+  SharedSparseArray<size_t> sparse;
+  Storage<size_t> storage(&sparse);
+  storage.Initialize<int>();
+
+  for (size_t i = 0; i < 100; i++)
+  {
+    storage.Insert(i, static_cast<int>(i));
+  }
+
+  const int* components = storage.ChunkComponents<int>(0);
+
+  const size_t version = storage.Version();
+
+  storage.Sort<int>([](const int value) { return static_cast<uint64_t>(value); });
+  storage.Sort<int>([](const int lhs, const int rhs) { return lhs < rhs; });
+
+  EXPECT_EQ(storage.ChunkComponents<int>(0), components);
+  EXPECT_EQ(storage.Version(), version);
+}
+
+TEST(Storage_Tests, Version_RowsAddedRemovedOrMoved_Changes)
+{
+  SharedSparseArray<size_t> sparse;
+  Storage<size_t> storage(&sparse);
+  storage.Initialize<int>();
+
+  size_t version = storage.Version();
+
+  const auto changed = [&]()
+  {
+    const bool result = storage.Version() != version;
+    version = storage.Version();
+    return result;
+  };
+
+  storage.Insert(0, 2);
+  EXPECT_TRUE(changed());
+
+  storage.Insert(1, 1);
+  EXPECT_TRUE(changed());
+
+  storage.Unpack<int>(0) = 3;
+  EXPECT_FALSE(changed());
+
+  storage.Sort<int>([](const int value) { return value; });
+  EXPECT_TRUE(changed());
+
+  storage.Erase(0);
+  EXPECT_TRUE(changed());
+
+  storage.Clear();
+  EXPECT_TRUE(changed());
+}
+
+TEST(Storage_Tests, Sort_Key_TicksFollowRows)
+{
+  SharedSparseArray<size_t> sparse;
+  Tick tick = 0;
+  Storage<size_t> storage(&sparse, &tick);
+  storage.Initialize<int>();
+
+  for (size_t i = 0; i < 10; i++)
+  {
+    tick = static_cast<Tick>(i + 1);
+    storage.Insert(i, static_cast<int>(10 - i));
+  }
+
+  tick = 20;
+
+  storage.Sort<int>([](const int value) { return value; });
+
+  EXPECT_EQ(storage.ChunkChangedTick<int>(0), 10);
+
+  for (size_t i = 0; i < storage.Size(); i++)
+  {
+    EXPECT_EQ(storage.ChunkAddedTicks<int>(0)[i], static_cast<Tick>(11 - storage.ChunkComponents<int>(0)[i]));
+  }
+}
+
 } // namespace plex::tests
\ No newline at end of file
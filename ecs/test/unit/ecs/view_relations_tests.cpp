@@ -2,6 +2,10 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <thread>
+#include <utility>
+
 namespace plex::tests
 {
 TEST(ViewRelations_Tests, AssureArchetype_Single_UniqueId)
@@ -167,4 +171,253 @@ TEST(ViewRelations_Tests, ViewArchetypes_Multiple_CorrectArchetypes)
 
   EXPECT_TRUE(std::includes(archetypes.begin(), archetypes.end(), view_archetypes.begin(), view_archetypes.end()));
 }
+
+TEST(ViewRelations_Tests, AssureArchetype_Runtime_SameIdAsCompileTime)
+{
+  ViewRelations relations;
+
+  Vector<ComponentId> components;
+  components.push_back(GetComponentId<int>());
+  components.push_back(GetComponentId<double>());
+  std::ranges::sort(components);
+
+  EXPECT_EQ(relations.AssureArchetype(components), (relations.AssureArchetype<double, int>()));
+  EXPECT_EQ(relations.ArchetypeComponents(relations.AssureArchetype(components)), components);
+}
+
+TEST(ViewRelations_Tests, AssureArchetype_Runtime_AddedToViews)
+{
+  ViewRelations relations;
+
+  const ViewId view = relations.AssureView<bool>();
+
+  Vector<ComponentId> components;
+  components.push_back(GetComponentId<bool>());
+  components.push_back(GetComponentId<char>());
+  std::ranges::sort(components);
+
+  const ArchetypeId archetype = relations.AssureArchetype(components);
+
+  ASSERT_EQ(relations.ViewArchetypes(view).size(), 1);
+  EXPECT_EQ(relations.ViewArchetypes(view)[0], archetype);
+}
+
+TEST(ViewRelations_Tests, AssureArchetype_SeparateRelations_DenseLocalIds)
+{
+  ViewRelations relations1;
+  ViewRelations relations2;
+
+  EXPECT_EQ((relations1.AssureArchetype<int, double>()), 0);
+  EXPECT_EQ(relations1.AssureArchetype<float>(), 1);
+
+  EXPECT_EQ(relations2.AssureArchetype<float>(), 0);
+  EXPECT_EQ((relations2.AssureArchetype<double, int>()), 1);
+  EXPECT_EQ(relations2.AssureArchetype<int>(), 2);
+
+  EXPECT_EQ(relations1.ArchetypeCount(), 2);
+  EXPECT_EQ(relations2.ArchetypeCount(), 3);
+}
+
+TEST(ViewRelations_Tests, AssureView_SeparateRelations_DenseLocalIds)
+{
+  ViewRelations relations1;
+  ViewRelations relations2;
+
+  // The empty view is always assured first
+  EXPECT_EQ(relations1.AssureView<>(), 0);
+  EXPECT_EQ(relations2.AssureView<>(), 0);
+
+  EXPECT_EQ(relations1.AssureView<int>(), 1);
+  EXPECT_EQ((relations1.AssureView<int, Without<double>>()), 2);
+
+  EXPECT_EQ((relations2.AssureView<int, Without<double>>()), 1);
+
+  EXPECT_EQ(relations1.ViewCount(), 3);
+  EXPECT_EQ(relations2.ViewCount(), 2);
+}
+
+TEST(ViewRelations_Tests, AssureArchetype_ManyArchetypes_AllViewsUpdated)
+{
+  ViewRelations relations;
+
+  const ViewId view = relations.AssureView<bool>();
+
+  Vector<ComponentId> components;
+  components.push_back(GetComponentId<bool>());
+
+  const ArchetypeId first = relations.AssureArchetype(components);
+
+  for (ComponentId i = 1; i <= 300; i++)
+  {
+    Vector<ComponentId> other;
+    other.push_back(GetComponentId<bool>());
+    other.push_back(GetComponentId<bool>() + i);
+    std::ranges::sort(other);
+
+    EXPECT_EQ(relations.AssureArchetype(other), first + i);
+  }
+
+  EXPECT_EQ(relations.ArchetypeCount(), 301);
+  EXPECT_EQ(relations.ViewArchetypes(view).size(), 301);
+}
+
+TEST(ViewRelations_Tests, AssureArchetype_WhileOthersInitialized_SameId)
+{
+  ViewRelations relations;
+
+  const ArchetypeId expected = relations.AssureArchetype<char>();
+
+  std::atomic<bool> done = false;
+  size_t mismatches = 0;
+
+  std::thread reader(
+    [&]()
+    {
+      while (!done.load())
+      {
+        if (relations.AssureArchetype<char>() != expected) mismatches++;
+      }
+    });
+
+  for (ComponentId i = 1; i <= 2000; i++)
+  {
+    Vector<ComponentId> components;
+    components.push_back(GetComponentId<char>() + i);
+
+    relations.AssureArchetype(components);
+  }
+
+  done.store(true);
+  reader.join();
+
+  EXPECT_EQ(mismatches, 0);
+  EXPECT_EQ(relations.ArchetypeCount(), 2001);
+}
+
+TEST(ViewRelations_Tests, AssureView_WithoutAndOptional_DifferentIds)
+{
+  ViewRelations relations;
+
+  EXPECT_NE(relations.AssureView<int>(), (relations.AssureView<int, Without<float>>()));
+  EXPECT_NE(relations.AssureView<int>(), (relations.AssureView<int, Optional<float>>()));
+  EXPECT_NE((relations.AssureView<int, Without<float>>()), (relations.AssureView<int, Optional<float>>()));
+  EXPECT_EQ((relations.AssureView<int, Without<float>>()), (relations.AssureView<Without<float>, int>()));
+}
+
+TEST(ViewRelations_Tests, ViewArchetypes_Without_ExcludedArchetypesSkipped)
+{
+  ViewRelations relations;
+
+  const ArchetypeId int_archetype = relations.AssureArchetype<int>();
+  relations.AssureArchetype<int, float>();
+
+  const ViewId view = relations.AssureView<int, Without<float>>();
+
+  const ArchetypeId int_double_archetype = relations.AssureArchetype<int, double>();
+  relations.AssureArchetype<int, double, float>();
+
+  Vector<ArchetypeId> view_archetypes = relations.ViewArchetypes(view);
+  std::ranges::sort(view_archetypes);
+
+  ASSERT_EQ(view_archetypes.size(), 2);
+  EXPECT_EQ(view_archetypes[0], std::min(int_archetype, int_double_archetype));
+  EXPECT_EQ(view_archetypes[1], std::max(int_archetype, int_double_archetype));
+
+  EXPECT_EQ(relations.ViewArchetypes(relations.AssureView<int, Without<float, double>>()).size(), 1);
+  EXPECT_EQ(relations.ViewArchetypes(relations.AssureView<Without<float>>()).size(), 2);
+}
+
+TEST(ViewRelations_Tests, ViewArchetypes_Optional_SameArchetypes)
+{
+  ViewRelations relations;
+
+  relations.AssureArchetype<int>();
+  relations.AssureArchetype<int, float>();
+  relations.AssureArchetype<float>();
+
+  EXPECT_EQ(relations.ViewArchetypes(relations.AssureView<int, Optional<float>>()).size(), 2);
+  EXPECT_EQ(relations.ViewArchetypes(relations.AssureView<Optional<float>>()).size(), 3);
+}
+
+namespace
+{
+  template<size_t I>
+  struct Tag
+  {};
+
+  template<size_t... I>
+  ComponentId LastComponentId(std::index_sequence<I...>)
+  {
+    return (GetComponentId<Tag<I>>(), ...);
+  }
+} // namespace
+
+TEST(ViewRelations_Tests, ViewArchetypes_ComponentIdsAcrossSignatureBlocks_CorrectArchetypes)
+{
+  ViewRelations relations;
+
+  const ArchetypeId low = relations.AssureArchetype<int>();
+  const ViewId int_view = relations.AssureView<int>();
+
+  // Enough components to grow the signatures past a single block
+  const ComponentId high = LastComponentId(std::make_index_sequence<600>());
+
+  ASSERT_GE(high, 512);
+
+  Vector<ComponentId> components;
+  components.push_back(GetComponentId<int>());
+  components.push_back(high);
+  std::ranges::sort(components);
+
+  const ArchetypeId both = relations.AssureArchetype(components);
+
+  const ViewId high_view = relations.AssureView<Tag<599>>();
+  const ViewId excluded_view = relations.AssureView<int, Without<Tag<599>>>();
+
+  EXPECT_EQ(relations.ViewArchetypes(int_view).size(), 2);
+
+  ASSERT_EQ(relations.ViewArchetypes(high_view).size(), 1);
+  EXPECT_EQ(relations.ViewArchetypes(high_view)[0], both);
+
+  ASSERT_EQ(relations.ViewArchetypes(excluded_view).size(), 1);
+  EXPECT_EQ(relations.ViewArchetypes(excluded_view)[0], low);
+}
+
+TEST(ViewRelations_Tests, ViewContains_RequiredAndExcluded_Correct)
+{
+  ViewRelations relations;
+
+  const ViewId view = relations.AssureView<int, Without<float>>();
+
+  EXPECT_TRUE(relations.ViewContains(view, relations.AssureArchetype<int>()));
+  EXPECT_TRUE((relations.ViewContains(view, relations.AssureArchetype<int, double>())));
+  EXPECT_FALSE((relations.ViewContains(view, relations.AssureArchetype<int, float>())));
+  EXPECT_FALSE(relations.ViewContains(view, relations.AssureArchetype<double>()));
+  EXPECT_TRUE(relations.ViewContains(relations.AssureView<>(), relations.AssureArchetype<double>()));
+}
+
+TEST(ViewRelations_Tests, FindAddTransition_NotCached_Invalid)
+{
+  ViewRelations relations;
+
+  const ArchetypeId source = relations.AssureArchetype<int>();
+
+  EXPECT_EQ(relations.FindAddTransition(source, GetComponentId<double>()), cInvalidArchetype);
+  EXPECT_EQ(relations.FindRemoveTransition(source, GetComponentId<int>()), cInvalidArchetype);
+}
+
+TEST(ViewRelations_Tests, AddTransition_Single_CachedBothWays)
+{
+  ViewRelations relations;
+
+  const ArchetypeId source = relations.AssureArchetype<int>();
+  const ArchetypeId destination = relations.AssureArchetype<int, double>();
+
+  relations.AddTransition(source, GetComponentId<double>(), destination);
+
+  EXPECT_EQ(relations.FindAddTransition(source, GetComponentId<double>()), destination);
+  EXPECT_EQ(relations.FindRemoveTransition(destination, GetComponentId<double>()), source);
+  EXPECT_EQ(relations.FindAddTransition(source, GetComponentId<float>()), cInvalidArchetype);
+  EXPECT_EQ(relations.FindRemoveTransition(destination, GetComponentId<int>()), cInvalidArchetype);
+}
 } // namespace plex::tests
\ No newline at end of file